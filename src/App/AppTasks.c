@@ -15,30 +15,297 @@
 
 
 /***** INCLUDES **************************************************************/
+#include <stdbool.h>
+
+#include "stm32g4xx_hal.h"
+
 #include "Scheduler.h"
 #include "AppTasks.h"
+#include "Application.h"
+
+#include "UARTModule.h"
+#include "TimerModule.h"
+#include "ADCModule.h"
+#include "WaterSensor.h"
+#include "DualChannelGasSensor.h"
+#include "GasScale/GasScale.h"
+#include "AlarmEngine/AlarmEngine.h"
+#include "TrendEstimator/TrendEstimator.h"
+#include "Util/Log/LogOutput.h"
+
+#ifdef ENABLE_FRAME_MUX
+#include "FrameMux.h"
+#endif
 
 /***** PRIVATE CONSTANTS *****************************************************/
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define SENSOR_RX_CHUNK         32          //!< Number of bytes read from the UART at once
+
+#define DIAG_CMD_WATER_LINK     0x01        //!< Diagnostic request for the water sensor link statistics
+#define DIAG_CMD_ADC_CAPTURE    0x02        //!< Diagnostic request to start a raw ADC capture
+
+#define DIAG_CAPTURE_TRIGGER    'c'         //!< Byte on the debug UART which starts a raw ADC capture without the frame multiplexer
+#define DIAG_CAPTURE_MASK       ((1u << ADC_INPUT0) | (1u << ADC_INPUT1))  //!< Default channels of a raw ADC capture
+#define DIAG_CAPTURE_RATE_HZ    10000       //!< Default sample rate of a raw ADC capture
+#define DIAG_CAPTURE_SEQUENCES  2048        //!< Default number of sequences of a raw ADC capture
+
+#ifdef ENABLE_FRAME_MUX
+#define ADC_DUMP_WRITER         frameMuxWriteTelemetry  //!< The ADC dump is sent on the telemetry channel
+#else
+#define ADC_DUMP_WRITER         uartWriteDebug          //!< The ADC dump is sent as raw bytes
+#endif
+
+#define GAS_DEFECT_WATCHDOG1    ADC_WATCHDOG1   //!< Analog watchdog of the valid voltage range of gas channel 1 (ADC_INPUT0)
+#define GAS_DEFECT_WATCHDOG2    ADC_WATCHDOG2   //!< Analog watchdog of the valid voltage range of gas channel 2 (ADC_INPUT1)
+#define GAS_EMERGENCY_WATCHDOG  ADC_WATCHDOG3   //!< Analog watchdog of the emergency threshold of gas channel 1 (ADC_INPUT0)
+#define GAS_CONFIRM_CHANNELS    ((1u << ADC_INPUT0) | (1u << ADC_INPUT1))  //!< Channels of the confirmation conversion
+
+#define ALARM_SIGNAL_GAS_PPM    0           //!< Signal ID of the mean gas concentration [ppm]
+#define ALARM_SIGNAL_WATER_CM   1           //!< Signal ID of the (highest) water level [cm]
+
+#define ALARM_HYSTERESIS_PPM    100         //!< Hysteresis of the gas alarms [ppm]
+#define ALARM_HYSTERESIS_CM     5           //!< Hysteresis of the water alarms [cm]
+
+#define TREND_SAMPLE_PERIOD_MS  250         //!< Sample period of the trend estimators (250 ms task)
+#define TREND_WINDOW_SIZE       32          //!< Samples in the window of the trend estimators (8 s)
+#define TREND_HORIZON_MS        10000       //!< Early warning if the emergency threshold is predicted within this time
+
+#ifdef ENABLE_WATER_MULTIDROP
+#define WATER_PROBE_COUNT       (sizeof(gWaterProbeIds) / sizeof(gWaterProbeIds[0]))   //!< Number of probes on the sensor line
+#endif
 
 
 /***** PRIVATE TYPES *********************************************************/
 
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static void gasWatchdogCallback(ADC_Watchdog_t watchdog, ADC_Channel_t adcChannel);
+static void gasConfirmCallback(uint32_t channelMask, const int32_t* pRawValues);
+static void sensorRxCallback(UARTPort_t port);
+#ifdef ENABLE_FRAME_MUX
+static void diagnosticConsumer(uint8_t channel, const uint8_t* pPayload, uint16_t length);
+static uint8_t* putUint32(uint8_t* pBuffer, uint32_t value);
+static uint32_t getUint32(const uint8_t* pBuffer);
+#endif
+static bool waterSensorDefect(uint32_t nowUs);
+static bool waterSensorLevel(int32_t* pMicroVolt);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
+static WaterSensor_t gWaterSensor;          //!< Decoder for the water level sensor frames
+static DualChannelGasSensor_t gGasSensor;   //!< Redundant gas sensors on the fast ADC inputs
+static bool gSensorDefect = false;          //!< Sensor failure has been reported to the application
+static volatile bool gAlarmAcknowledge = false;     //!< Acknowledge of the alarms requested, not yet posted
+static volatile uint32_t gGasWatchdogDefects = 0;   //!< Bit mask of the fired gas range watchdogs (bit n = ADC_Watchdog_t n), not yet re-armed
+static volatile bool gGasEmergencyConfirmed = false;    //!< Emergency threshold crossing confirmed by an immediate conversion
+static bool gGasEmergencyPosted = false;            //!< Event of the confirmed crossing has been accepted
+static int32_t gGasEmergencyMicroVolt;              //!< Sensor voltage of the emergency threshold [µV]
+
+/**
+ * @brief Alarm rules of the sensor values. Each row contains SIGNAL_ID,
+ * THRESHOLD, HOLD TIME [ms], HYSTERESIS, EVENT_ID
+ *
+ * The last four members of a row are only the initialization of the dynamic
+ * members used during runtime
+ */
+static AlarmRule_t gAlarmRules[] =
+{
+    {ALARM_SIGNAL_GAS_PPM,      GAS_PPM_WARNING,        5000,   ALARM_HYSTERESIS_PPM,   EVT_ID_ALARM_WARNING,       false,  0,  false,  false},
+    {ALARM_SIGNAL_GAS_PPM,      GAS_PPM_EMERGENCY,      3000,   ALARM_HYSTERESIS_PPM,   EVT_ID_ALARM_EMERGENCY,     false,  0,  false,  false},
+    {ALARM_SIGNAL_WATER_CM,     WATER_CM_WARNING,       10000,  ALARM_HYSTERESIS_CM,    EVT_ID_ALARM_WARNING,       false,  0,  false,  false},
+    {ALARM_SIGNAL_WATER_CM,     WATER_CM_EMERGENCY,     5000,   ALARM_HYSTERESIS_CM,    EVT_ID_ALARM_EMERGENCY,     false,  0,  false,  false},
+};
+
+static AlarmEngine_t gAlarmEngine;          //!< Time-over-threshold supervision of the sensor values
+
+static int32_t gGasTrendWindow[TREND_WINDOW_SIZE];      //!< Samples of the gas trend [ppm]
+static int32_t gWaterTrendWindow[TREND_WINDOW_SIZE];    //!< Samples of the water level trend [cm]
+static TrendEstimator_t gGasTrend;                      //!< Rate of change of the gas concentration
+static TrendEstimator_t gWaterTrend;                    //!< Rate of change of the water level
+
+#ifdef ENABLE_WATER_MULTIDROP
+static const uint8_t gWaterProbeIds[] = { 0x01, 0x02, 0x03, 0x04 };    //!< Addresses of the probes on the sensor line
+static WaterProbe_t gWaterProbes[WATER_PROBE_COUNT];                    //!< State of the probes
+static WaterBus_t gWaterBus;                                            //!< Address table of the probes
+#endif
 
 
 /***** PUBLIC FUNCTIONS ******************************************************/
 
+void taskAppInitialize()
+{
+    uint32_t nowUs = timerGetMicroseconds();
+
+    waterSensorInitialize(&gWaterSensor, nowUs);
+    gasSensorInitialize(&gGasSensor);
+    alarmEngineInitialize(&gAlarmEngine, gAlarmRules, sizeof(gAlarmRules) / sizeof(AlarmRule_t), sameplAppSendEvent);
+
+    trendInitialize(&gGasTrend, gGasTrendWindow, TREND_WINDOW_SIZE, TREND_SAMPLE_PERIOD_MS);
+    trendSetEarlyWarning(&gGasTrend, GAS_PPM_EMERGENCY, TREND_HORIZON_MS, EVT_ID_ALARM_TREND, sameplAppSendEvent);
+    trendInitialize(&gWaterTrend, gWaterTrendWindow, TREND_WINDOW_SIZE, TREND_SAMPLE_PERIOD_MS);
+    trendSetEarlyWarning(&gWaterTrend, WATER_CM_EMERGENCY, TREND_HORIZON_MS, EVT_ID_ALARM_TREND, sameplAppSendEvent);
+
+#ifdef ENABLE_WATER_MULTIDROP
+    waterBusInitialize(&gWaterBus, gWaterProbes, WATER_PROBE_COUNT);
+    for (uint32_t i = 0; i < WATER_PROBE_COUNT; i++)
+    {
+        waterBusAddProbe(&gWaterBus, gWaterProbeIds[i], nowUs);
+    }
+    waterSensorAttachBus(&gWaterSensor, &gWaterBus);
+#endif
+
+    // A gas channel outside of 0.5 V .. 2.5 V is detected by the analog
+    // watchdogs within one conversion instead of the next poll
+    adcRegisterWatchdogCallback(gasWatchdogCallback);
+    adcConfigureWatchdog(GAS_DEFECT_WATCHDOG1, ADC_INPUT0, GAS_MICROVOLT_MIN, GAS_MICROVOLT_MAX);
+    adcConfigureWatchdog(GAS_DEFECT_WATCHDOG2, ADC_INPUT1, GAS_MICROVOLT_MIN, GAS_MICROVOLT_MAX);
+
+    // A crossing of the emergency threshold is confirmed by an immediate
+    // conversion of both channels instead of waiting for the next poll
+    gGasEmergencyMicroVolt = gasScalePpmToMicroVolt(GAS_PPM_EMERGENCY);
+    adcConfigureWatchdog(GAS_EMERGENCY_WATCHDOG, ADC_INPUT0, 0, gGasEmergencyMicroVolt);
+
+    // The sensor UART carries the raw sensor byte stream, which is decoded
+    // right in the RX event so the frames get exact arrival time stamps
+    uartSetRxCallback(UART_PORT_SENSOR, sensorRxCallback);
+
+#ifdef ENABLE_FRAME_MUX
+    frameMuxRegisterConsumer(FRAME_CHANNEL_DIAGNOSTIC, diagnosticConsumer);
+#endif
+}
+
+void taskAppAcknowledgeAlarms()
+{
+    gAlarmAcknowledge = true;
+}
 
 void taskApp10ms()
 {
+#ifdef ENABLE_FRAME_MUX
+    // A raw ADC capture is requested on the diagnostic channel (see diagnosticConsumer())
+    frameMuxProcess();
+#else
+    // A raw ADC capture is started from the terminal (see tools/adc_dump_to_csv.py)
+    int8_t hasData = 0;
+    uint8_t command = 0;
+
+    if (uartHasData(UART_PORT_DEBUG, &hasData) == UART_ERR_OK && hasData != 0 &&
+        uartReceiveData(UART_PORT_DEBUG, &command, 1) == UART_ERR_OK && command == DIAG_CAPTURE_TRIGGER)
+    {
+        adcCaptureStart(DIAG_CAPTURE_MASK, DIAG_CAPTURE_RATE_HZ, DIAG_CAPTURE_SEQUENCES);
+    }
+#endif
+
+    // The dump of a completed capture is streamed one chunk per cycle
+    adcCaptureProcess(ADC_DUMP_WRITER);
+
+    uint32_t nowMs = HAL_GetTick();
+    int32_t waterMicroVolt = 0;
+    int32_t gasPpm = 0;
+
+    // A water sensor is defect until its next valid frame. The decoders are
+    // also updated by the sensor UART RX interrupt
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool defect = waterSensorDefect(timerGetMicroseconds());
+    bool waterValid = waterSensorLevel(&waterMicroVolt);
+    __set_PRIMASK(primask);
+
+    // Both gas channels are taken from the same conversion sequence
+    ADCSnapshot_t snapshot;
+    if (adcGetSnapshot(&snapshot) == ADC_ERR_OK &&
+        gasSensorProcessSnapshot(&gGasSensor, &snapshot) == GAS_SENSOR_ERR_DEFECT)
+    {
+        defect = true;
+    }
+
+    uint32_t watchdogDefects = gGasWatchdogDefects;
+    if (watchdogDefects != 0)
+    {
+        defect = true;
+    }
+
+    // The state machine takes one event per cycle. The sensor failure is
+    // posted first and counts as reported only once it has been accepted,
+    // the other events are posted again in the next cycles
+    if (!defect)
+    {
+        gSensorDefect = false;
+    }
+    else if (!gSensorDefect)
+    {
+        gSensorDefect = (sameplAppSendEvent(EVT_ID_SENSOR_FAILED) == 0);
+    }
 
+    // The fired watchdogs are re-armed once the failure has been reported,
+    // so a broken sensor raises at most one interrupt per cycle
+    if (watchdogDefects != 0 && gSensorDefect)
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        gGasWatchdogDefects &= ~watchdogDefects;
+        __set_PRIMASK(primask);
+
+        for (uint32_t i = 0; i < ADC_WATCHDOG_COUNT; i++)
+        {
+            if ((watchdogDefects & (1u << i)) != 0)
+            {
+                adcRearmWatchdog((ADC_Watchdog_t)i);
+            }
+        }
+    }
+
+    // After an acknowledge the alarms have to elapse their hold time again
+    // and the trends have to fill their window again
+    if (gAlarmAcknowledge)
+    {
+        alarmEngineResetSignal(&gAlarmEngine, ALARM_SIGNAL_GAS_PPM);
+        alarmEngineResetSignal(&gAlarmEngine, ALARM_SIGNAL_WATER_CM);
+        trendReset(&gGasTrend);
+        trendReset(&gWaterTrend);
+        gAlarmAcknowledge = (sameplAppSendEvent(EVT_ID_ALARM_RESET) != 0);
+    }
+
+    // The alarms of a sensor without valid value start again with its next value
+    if (waterValid)
+    {
+        alarmEngineUpdate(&gAlarmEngine, ALARM_SIGNAL_WATER_CM, waterSensorMicroVoltToCm(waterMicroVolt), nowMs);
+    }
+    else
+    {
+        alarmEngineResetSignal(&gAlarmEngine, ALARM_SIGNAL_WATER_CM);
+    }
+
+    if (gasSensorGetPpm(&gGasSensor, &gasPpm) == GAS_SENSOR_ERR_OK)
+    {
+        alarmEngineUpdate(&gAlarmEngine, ALARM_SIGNAL_GAS_PPM, gasPpm, nowMs);
+
+        // The confirmed crossing posts the emergency right away, the watchdog
+        // is re-armed as soon as the gas concentration has dropped again
+        if (gGasEmergencyConfirmed && !gGasEmergencyPosted)
+        {
+            gGasEmergencyPosted = (sameplAppSendEvent(EVT_ID_ALARM_EMERGENCY) == 0);
+            if (gGasEmergencyPosted)
+            {
+                outputLog("Gas emergency confirmed\n\r");
+            }
+        }
+        else if (gGasEmergencyConfirmed && gasPpm <= GAS_PPM_EMERGENCY - ALARM_HYSTERESIS_PPM)
+        {
+            gGasEmergencyConfirmed = false;
+            gGasEmergencyPosted = false;
+            adcRearmWatchdog(GAS_EMERGENCY_WATCHDOG);
+        }
+    }
+    else
+    {
+        alarmEngineResetSignal(&gAlarmEngine, ALARM_SIGNAL_GAS_PPM);
+    }
+
+    // Process the events posted in this cycle
+    sampleAppRun();
 }
 
 
@@ -49,12 +316,265 @@ void taskApp50ms()
 
 void taskApp250ms()
 {
+    int32_t waterMicroVolt = 0;
+    int32_t gasPpm = 0;
 
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool waterValid = waterSensorLevel(&waterMicroVolt);
+    __set_PRIMASK(primask);
+
+    // The trend needs a gapless window, a sensor without valid value starts again
+    if (waterValid)
+    {
+        trendUpdate(&gWaterTrend, waterSensorMicroVoltToCm(waterMicroVolt));
+    }
+    else
+    {
+        trendReset(&gWaterTrend);
+    }
+
+    if (gasSensorGetPpm(&gGasSensor, &gasPpm) == GAS_SENSOR_ERR_OK)
+    {
+        trendUpdate(&gGasTrend, gasPpm);
+    }
+    else
+    {
+        trendReset(&gGasTrend);
+    }
 }
 
 
 /***** PRIVATE FUNCTIONS *****************************************************/
 
+/**
+ * @brief Supervises the water sensors
+ *
+ * With several probes on the line, only the probes whose timeout expired
+ * are visited, so the cost does not grow with the number of probes.
+ *
+ * @param nowUs         Current time in us
+ *
+ * @return true if at least one sensor does not send any frames
+ */
+static bool waterSensorDefect(uint32_t nowUs)
+{
+#ifdef ENABLE_WATER_MULTIDROP
+    return waterBusCheckTimeouts(&gWaterBus, nowUs) > 0;
+#else
+    return waterSensorCheckTimeout(&gWaterSensor, nowUs) == WATER_ERR_TIMEOUT;
+#endif
+}
+
+/**
+ * @brief Flags a gas channel outside of the valid voltage range
+ *
+ * The interrupt of the watchdog stays disabled until the 10 ms task has
+ * reported the failure and re-armed it.
+ *
+ * @param watchdog      Analog watchdog which fired
+ * @param adcChannel    Channel monitored by the watchdog
+ *
+ * @remark: called by the ADC module from the analog watchdog interrupt
+ */
+static void gasWatchdogCallback(ADC_Watchdog_t watchdog, ADC_Channel_t adcChannel)
+{
+    if (watchdog == GAS_DEFECT_WATCHDOG1 || watchdog == GAS_DEFECT_WATCHDOG2)
+    {
+        gGasWatchdogDefects |= (1u << watchdog);
+    }
+    else if (watchdog == GAS_EMERGENCY_WATCHDOG)
+    {
+        // Another confirmation is still running, try again with the next conversion
+        if (adcConfirmStart(GAS_CONFIRM_CHANNELS, gasConfirmCallback) != ADC_ERR_OK)
+        {
+            adcRearmWatchdog(GAS_EMERGENCY_WATCHDOG);
+        }
+    }
+}
 
+/**
+ * @brief Checks the emergency threshold crossing with the immediate
+ * conversion of both gas channels
+ *
+ * Both redundant channels have to be above the threshold, otherwise the
+ * crossing was a spike and the watchdog is re-armed.
+ *
+ * @param channelMask   Bit mask of converted channels
+ * @param pRawValues    Raw values in digits, indexed by ADC_Channel_t
+ *
+ * @remark: called by the ADC module from the ADC interrupt
+ */
+static void gasConfirmCallback(uint32_t channelMask, const int32_t* pRawValues)
+{
+    if ((channelMask & GAS_CONFIRM_CHANNELS) == GAS_CONFIRM_CHANNELS &&
+        pRawValues[ADC_INPUT0] * ADC_MICROVOLTS_PER_DIGIT >= gGasEmergencyMicroVolt &&
+        pRawValues[ADC_INPUT1] * ADC_MICROVOLTS_PER_DIGIT >= gGasEmergencyMicroVolt)
+    {
+        gGasEmergencyConfirmed = true;
+    }
+    else
+    {
+        adcRearmWatchdog(GAS_EMERGENCY_WATCHDOG);
+    }
+}
 
+/**
+ * @brief Returns the filtered value of the water sensor, with several
+ * probes on the line the highest value of all probes with valid data
+ *
+ * @param pMicroVolt    Pointer to store the value [µV] to
+ *
+ * @return true if at least one sensor has a valid value
+ */
+static bool waterSensorLevel(int32_t* pMicroVolt)
+{
+    bool valid = false;
+    int32_t microVolt;
+
+#ifdef ENABLE_WATER_MULTIDROP
+    for (uint32_t i = 0; i < gWaterBus.probeCount; i++)
+    {
+        if (waterChannelGetValue(&gWaterBus.pProbes[i].channel, 0, &microVolt) == WATER_ERR_OK &&
+            (!valid || microVolt > *pMicroVolt))
+        {
+            *pMicroVolt = microVolt;
+            valid = true;
+        }
+    }
+#else
+    if (waterChannelGetValue(&gWaterSensor.channel, 0, &microVolt) == WATER_ERR_OK)
+    {
+        *pMicroVolt = microVolt;
+        valid = true;
+    }
+#endif
+
+    return valid;
+}
+
+/**
+ * @brief Decodes the received sensor bytes with the arrival time stamp
+ *
+ * @param port          Port which received the data (UART_PORT_SENSOR)
+ *
+ * @remark: called by the UART module from the RX event interrupt
+ */
+static void sensorRxCallback(UARTPort_t port)
+{
+    uint8_t chunk[SENSOR_RX_CHUNK];
+    int32_t count;
+    uint32_t nowUs = timerGetMicroseconds();
 
+    while ((count = uartRead(port, chunk, SENSOR_RX_CHUNK)) > 0)
+    {
+        waterSensorProcess(&gWaterSensor, chunk, count, nowUs);
+    }
+}
+
+#ifdef ENABLE_FRAME_MUX
+/**
+ * @brief Answers requests on the diagnostic channel
+ *
+ * DIAG_CMD_WATER_LINK is answered with the command byte followed by the
+ * link quality summary (WaterLinkQuality_t) and the inter-arrival histogram,
+ * all values as 32 bit little endian.
+ *
+ * DIAG_CMD_ADC_CAPTURE starts a raw ADC capture, optionally followed by the
+ * channel mask, the sample rate [Hz] and the number of sequences (32 bit
+ * little endian each, otherwise the DIAG_CAPTURE_* defaults are used). The
+ * answer is the command byte followed by the result of adcCaptureStart(),
+ * the dump follows on the telemetry channel.
+ *
+ * @param channel       Channel of the frame
+ * @param pPayload      Payload of the frame
+ * @param length        Length of the payload
+ */
+static void diagnosticConsumer(uint8_t channel, const uint8_t* pPayload, uint16_t length)
+{
+    uint8_t response[1 + sizeof(WaterLinkQuality_t) + WATER_LINK_HISTOGRAM_BINS * sizeof(uint32_t)];
+    WaterLinkStats_t link;
+    WaterLinkQuality_t quality;
+
+    if (length >= 1 && pPayload[0] == DIAG_CMD_ADC_CAPTURE)
+    {
+        uint32_t channelMask = DIAG_CAPTURE_MASK;
+        uint32_t sampleRateHz = DIAG_CAPTURE_RATE_HZ;
+        uint32_t sequenceCount = DIAG_CAPTURE_SEQUENCES;
+
+        if (length >= 13)
+        {
+            channelMask = getUint32(&pPayload[1]);
+            sampleRateHz = getUint32(&pPayload[5]);
+            sequenceCount = getUint32(&pPayload[9]);
+        }
+
+        response[0] = DIAG_CMD_ADC_CAPTURE;
+        putUint32(&response[1], (uint32_t)adcCaptureStart(channelMask, sampleRateHz, sequenceCount));
+        frameMuxSend(FRAME_CHANNEL_DIAGNOSTIC, response, 5);
+        return;
+    }
+
+    if (length < 1 || pPayload[0] != DIAG_CMD_WATER_LINK)
+    {
+        return;
+    }
+
+    // The statistics are updated by the sensor UART RX interrupt, the
+    // response is built from a consistent copy
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    link = gWaterSensor.channel.link;
+    __set_PRIMASK(primask);
+
+    waterLinkGetQuality(&link, &quality);
+
+    uint8_t* pWrite = response;
+    *pWrite++ = DIAG_CMD_WATER_LINK;
+    pWrite = putUint32(pWrite, quality.intervalMinUs);
+    pWrite = putUint32(pWrite, quality.intervalMaxUs);
+    pWrite = putUint32(pWrite, quality.intervalMeanUs);
+    pWrite = putUint32(pWrite, quality.jitterMeanUs);
+    pWrite = putUint32(pWrite, quality.jitterMaxUs);
+    pWrite = putUint32(pWrite, quality.lossRatePpm);
+    pWrite = putUint32(pWrite, quality.checksumErrorRatePpm);
+
+    for (int32_t i = 0; i < WATER_LINK_HISTOGRAM_BINS; i++)
+    {
+        pWrite = putUint32(pWrite, link.histogram[i]);
+    }
+
+    frameMuxSend(FRAME_CHANNEL_DIAGNOSTIC, response, (uint16_t)(pWrite - response));
+}
+
+/**
+ * @brief Stores a 32 bit value in little endian byte order
+ *
+ * @param pBuffer       Destination
+ * @param value         Value to store
+ *
+ * @return Pointer behind the stored value
+ */
+static uint8_t* putUint32(uint8_t* pBuffer, uint32_t value)
+{
+    pBuffer[0] = (uint8_t)value;
+    pBuffer[1] = (uint8_t)(value >> 8);
+    pBuffer[2] = (uint8_t)(value >> 16);
+    pBuffer[3] = (uint8_t)(value >> 24);
+
+    return pBuffer + 4;
+}
+
+/**
+ * @brief Reads a 32 bit value in little endian byte order
+ *
+ * @param pBuffer       Source
+ *
+ * @return The value
+ */
+static uint32_t getUint32(const uint8_t* pBuffer)
+{
+    return (uint32_t)pBuffer[0] | ((uint32_t)pBuffer[1] << 8) |
+           ((uint32_t)pBuffer[2] << 16) | ((uint32_t)pBuffer[3] << 24);
+}
+#endif
@@ -30,6 +30,21 @@
 
 /***** PROTOTYPES ************************************************************/
 
+/**
+ * @brief Initializes the data used by the application tasks, has to be
+ * called once after the peripherals have been initialized
+ */
+void taskAppInitialize();
+
+/**
+ * @brief Acknowledges the active alarms (e.g. by the alarm reset button)
+ *
+ * The acknowledge is posted to the state machine with the next 10ms task.
+ * Alarms whose condition is still present become active again after
+ * their hold time.
+ */
+void taskAppAcknowledgeAlarms();
+
 void taskApp10ms();
 void taskApp50ms();
 void taskApp250ms();
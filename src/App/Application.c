@@ -20,6 +20,7 @@
 #include "Application.h"
 #include "Util/Global.h"
 #include "Util/Log/printf.h"
+#include "Util/Log/LogOutput.h"
 
 #include "UARTModule.h"
 #include "ButtonModule.h"
@@ -32,6 +33,8 @@
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define ALARM_LED               LED1    //!< On = Warning, Flashing = Emergency
+#define ALARM_LED_FLASH_MS      250     //!< Half period of the flashing alarm LED
 
 
 /***** PRIVATE TYPES *********************************************************/
@@ -39,6 +42,9 @@
 
 /***** PRIVATE PROTOTYPES ****************************************************/
 static int32_t onStateRunning(State_t* pState, int32_t eventID);
+static int32_t onEntryWarning(State_t* pState, int32_t eventID);
+static int32_t onStateEmergency(State_t* pState, int32_t eventID);
+static int32_t onExitAlarm(State_t* pState, int32_t eventID);
 
 /***** PRIVATE VARIABLES *****************************************************/
 
@@ -53,7 +59,9 @@ static State_t gStateList[] =
 {
     {STATE_ID_STARTUP, 0,  		0,                  0,              false},
     {STATE_ID_RUNNING, 0,       onStateRunning,     0,  			false},
-    {STATE_ID_FAILURE, 0,  		0,                  0,              false}
+    {STATE_ID_FAILURE, 0,  		0,                  0,              false},
+    {STATE_ID_WARNING, onEntryWarning,  0,          onExitAlarm,    false},
+    {STATE_ID_EMERGENCY, 0,     onStateEmergency,   onExitAlarm,    false}
 };
 
 /**
@@ -68,6 +76,14 @@ static StateTableEntry_t gStateTableEntries[] =
     {STATE_ID_STARTUP,          STATE_ID_RUNNING,           EVT_ID_INIT_READY,          0,      0,      0},
     {STATE_ID_STARTUP,          STATE_ID_FAILURE,           EVT_ID_SENSOR_FAILED,       0,      0,      0},
     {STATE_ID_RUNNING,          STATE_ID_FAILURE,           EVT_ID_SENSOR_FAILED,       0,      0,      0},
+    {STATE_ID_RUNNING,          STATE_ID_WARNING,           EVT_ID_ALARM_WARNING,       0,      0,      0},
+    {STATE_ID_RUNNING,          STATE_ID_WARNING,           EVT_ID_ALARM_TREND,         0,      0,      0},
+    {STATE_ID_RUNNING,          STATE_ID_EMERGENCY,         EVT_ID_ALARM_EMERGENCY,     0,      0,      0},
+    {STATE_ID_WARNING,          STATE_ID_EMERGENCY,         EVT_ID_ALARM_EMERGENCY,     0,      0,      0},
+    {STATE_ID_WARNING,          STATE_ID_RUNNING,           EVT_ID_ALARM_RESET,         0,      0,      0},
+    {STATE_ID_WARNING,          STATE_ID_FAILURE,           EVT_ID_SENSOR_FAILED,       0,      0,      0},
+    {STATE_ID_EMERGENCY,        STATE_ID_RUNNING,           EVT_ID_ALARM_RESET,         0,      0,      0},
+    {STATE_ID_EMERGENCY,        STATE_ID_FAILURE,           EVT_ID_SENSOR_FAILED,       0,      0,      0},
 };
 
 /**
@@ -100,6 +116,11 @@ int32_t sameplAppSendEvent(int32_t eventID)
     return result;
 }
 
+int32_t sampleAppGetState()
+{
+    return gStateTable.currentStateID;
+}
+
 
 /***** PRIVATE FUNCTIONS *****************************************************/
 static int32_t onStateRunning(State_t* pState, int32_t eventID)
@@ -107,3 +128,22 @@ static int32_t onStateRunning(State_t* pState, int32_t eventID)
 	return 0;
 }
 
+static int32_t onEntryWarning(State_t* pState, int32_t eventID)
+{
+    ledSetLED(ALARM_LED, LED_ON);
+    outputLog("Warning: sensor value high or rising fast\n\r");
+    return 0;
+}
+
+static int32_t onStateEmergency(State_t* pState, int32_t eventID)
+{
+    ledSetLED(ALARM_LED, ((HAL_GetTick() / ALARM_LED_FLASH_MS) % 2 == 0) ? LED_ON : LED_OFF);
+    return 0;
+}
+
+static int32_t onExitAlarm(State_t* pState, int32_t eventID)
+{
+    ledSetLED(ALARM_LED, LED_OFF);
+    return 0;
+}
+
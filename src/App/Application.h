@@ -25,9 +25,15 @@
 #define STATE_ID_STARTUP        1       //!< Example State for Startup
 #define STATE_ID_RUNNING        2       //!< Example State for Runing
 #define STATE_ID_FAILURE        3       //!< Example State for Failure
+#define STATE_ID_WARNING        4       //!< State for a sensor value above the warning threshold
+#define STATE_ID_EMERGENCY      5       //!< State for a sensor value above the emergency threshold
 
 #define EVT_ID_INIT_READY       1       //!< Event ID for INIT_READY
 #define EVT_ID_SENSOR_FAILED    2       //!< Event ID for Sensor Failure
+#define EVT_ID_ALARM_EMERGENCY  3       //!< Event ID for a gas or water emergency
+#define EVT_ID_ALARM_WARNING    4       //!< Event ID for a sensor value above the warning threshold
+#define EVT_ID_ALARM_RESET      5       //!< Event ID for the acknowledge of the alarms by the user
+#define EVT_ID_ALARM_TREND      6       //!< Event ID for a sensor value predicted to reach the emergency threshold soon
 
 /***** TYPES *****************************************************************/
 
@@ -40,4 +46,11 @@ int32_t sampleAppRun();
 
 int32_t sameplAppSendEvent(int32_t eventID);
 
+/**
+ * @brief Returns the ID of the current state of the state machine
+ *
+ * @return STATE_ID_xxx
+ */
+int32_t sampleAppGetState();
+
 #endif
@@ -151,11 +151,11 @@ void Authfunc_Update(void)
 
                 /* Non-blocking single-byte peek */
                 int8_t hasData = 0;
-                uartHasData(&hasData);
+                uartHasData(UART_PORT_DEBUG, &hasData);
                 if (hasData)
                 {
                     uint8_t ch = 0U;
-                    uartReceiveData(&ch, 1);
+                    uartReceiveData(UART_PORT_DEBUG, &ch, 1);
                     if (ch == 'A')
                     {
                         outputLogf("[AUTH] Trigger 'A' received – waiting for key\r\n");
@@ -208,11 +208,11 @@ void Authfunc_Update(void)
 
                 /* Try to read the next key byte (non-blocking) */
                 int8_t hasData = 0;
-                uartHasData(&hasData);
+                uartHasData(UART_PORT_DEBUG, &hasData);
                 if (hasData)
                 {
                     uint8_t ch = 0U;
-                    uartReceiveData(&ch, 1);
+                    uartReceiveData(UART_PORT_DEBUG, &ch, 1);
 
                     if (ch == '\n')
                     {
@@ -255,6 +255,10 @@ void Authfunc_Update(void)
              *    if correct, jump into the Application binary.
              *    This function does not return on success.            */
             outputLogf("[AUTH] Calling auth_verify()\r\n");
+
+            /* No UART DMA must be running when the Application takes over */
+            uartFlush(UART_PORT_DEBUG, AUTH_UART_FLUSH_TIMEOUT_MS);
+            uartStopReception(UART_PORT_DEBUG);
             auth_verify();
 
             /*
@@ -39,6 +39,9 @@
 /** LED flash period in ms (used for stage-2 LED D2 flashing) */
 #define AUTH_LED_FLASH_PERIOD_MS    250U
 
+/** Maximum time in ms to drain the UART TX queue before starting the Application */
+#define AUTH_UART_FLUSH_TIMEOUT_MS  200U
+
 /***** TYPES *****************************************************************/
 
 /**
@@ -21,36 +21,200 @@
 #include "System.h"
 #include "HardwareConfig.h"
 #include "ADCModule.h"
+#include "TimerModule.h"
 
+#include <stdbool.h>
 #include <string.h>
 
 /***** PRIVATE CONSTANTS *****************************************************/
-static const int32_t MICROVOLTS_PER_DIGIT = 805;    //!< 805 µV / digit
+static const int32_t ADC_MAX_DIGITS = 4095;         //!< Maximum conversion result for 12 bit resolution
+
+/**
+ * @brief Mapping of the (1 based) rank number to the regular ranks of the HAL
+ */
+static const uint32_t ADC_HAL_RANKS[] =
+{
+    ADC_REGULAR_RANK_1,  ADC_REGULAR_RANK_2,  ADC_REGULAR_RANK_3,  ADC_REGULAR_RANK_4,
+    ADC_REGULAR_RANK_5,  ADC_REGULAR_RANK_6,  ADC_REGULAR_RANK_7,  ADC_REGULAR_RANK_8,
+    ADC_REGULAR_RANK_9,  ADC_REGULAR_RANK_10, ADC_REGULAR_RANK_11, ADC_REGULAR_RANK_12,
+    ADC_REGULAR_RANK_13, ADC_REGULAR_RANK_14, ADC_REGULAR_RANK_15, ADC_REGULAR_RANK_16
+};
+
+/**
+ * @brief Mapping of the (1 based) rank number to the injected ranks of the HAL
+ */
+static const uint32_t ADC_HAL_INJECTED_RANKS[] =
+{
+    ADC_INJECTED_RANK_1, ADC_INJECTED_RANK_2, ADC_INJECTED_RANK_3, ADC_INJECTED_RANK_4
+};
+
+/**
+ * @brief Bit positions of the channel numbers of the injected ranks in JSQR
+ */
+static const uint32_t ADC_JSQR_POSITIONS[] =
+{
+    ADC_JSQR_JSQ1_Pos, ADC_JSQR_JSQ2_Pos, ADC_JSQR_JSQ3_Pos, ADC_JSQR_JSQ4_Pos
+};
+
+/**
+ * @brief Mapping of the logical analog watchdogs to the HAL watchdog numbers
+ * and the corresponding interrupt sources
+ */
+static const uint32_t ADC_HAL_WATCHDOGS[ADC_WATCHDOG_COUNT]     = { ADC_ANALOGWATCHDOG_1, ADC_ANALOGWATCHDOG_2, ADC_ANALOGWATCHDOG_3 };
+static const uint32_t ADC_HAL_WATCHDOG_ITS[ADC_WATCHDOG_COUNT]  = { ADC_IT_AWD1, ADC_IT_AWD2, ADC_IT_AWD3 };
 
 
 /***** PRIVATE MACROS ********************************************************/
-#define ADC_CHANNEL_COUNT       5                   //!< Total number of used ADC channels
+#define ADC_DMA_SEQUENCES       2                   //!< Number of conversion sequences in the DMA buffer (half/full transfer)
+#define ADC_MAX_SEQUENCE_LENGTH ADC_CHANNEL_COUNT   //!< Upper bound for the number of ranks per ADC (all channels on one ADC)
+#define ADC_DMA_BUFFER_LENGTH   (ADC_DMA_SEQUENCES * ADC_MAX_SEQUENCE_LENGTH)   //!< Size of the DMA buffer in (packed) words
+#define ADC_MAX_INJECTED_LENGTH 4                   //!< Maximum number of ranks in the injected sequence
+#define ADC_INSTANCE_COUNT      2                   //!< Number of used ADC instances (master, slave)
 
-#define IDX_ADC_INPUT0          0                   //!< Array index for ADC channel 0 (Pot 1) in global ADC value array
-#define IDX_ADC_INPUT1          1                   //!< Array index for ADC channel 1 (Pot 2) in global ADC value array
-#define IDX_ADC_TEMP            2                   //!< Array index for ADC channel 2 (internal Temp) in global ADC value array
-#define IDX_ADC_VBAT            3                   //!< Array index for ADC channel 3 (VBat) in global ADC value array
-#define IDX_ADC_VREF            4                   //!< Array index for ADC channel 4 (internal reference voltage) in global ADC value array
+#define ADC_DUMP_VERSION        1                   //!< Version of the raw capture dump format
+#define ADC_DUMP_HEADER_SIZE    32                  //!< Size of the dump header in bytes
+#define ADC_DUMP_TRAILER_SIZE   4                   //!< Size of the dump trailer in bytes
+#define ADC_DUMP_CHUNK_SIZE     64                  //!< Number of sample bytes written per call of adcCaptureProcess()
+
+#define ADC_MASTER_DATA(word)   ((word) & 0xFFFFU)  //!< Extracts the master (ADC1) result of a packed DMA word
+#define ADC_SLAVE_DATA(word)    ((word) >> 16)      //!< Extracts the slave (ADC2) result of a packed DMA word
 
 
 /***** PRIVATE TYPES *********************************************************/
 
+/**
+ * @brief Static description of one logical ADC channel
+ *
+ */
+typedef struct _ADCChannelDescriptor
+{
+    ADC_HandleTypeDef* pHandle;                 //!< ADC which converts the channel (ADC1 = master, ADC2 = slave)
+    ADC_Group_t group;                          //!< Acquisition group (fast = regular, housekeeping = injected on the master)
+    uint32_t halChannel;                        //!< Channel of the ADC peripheral
+    uint32_t rank;                              //!< Rank (starting at 1) in the sequence of the group on the ADC
+    uint32_t samplingTime;                      //!< Sampling time of the channel
+    GPIO_TypeDef* pPort;                        //!< GPIO port of the analog input (0 for internal channels)
+    uint32_t pin;                               //!< GPIO pin of the analog input
+    int32_t microVoltsPerDigit;                 //!< Scaling from digits to the measured voltage in µV
+} ADCChannelDescriptor_t;
+
+/**
+ * @brief Internal data of the injected confirmation conversion
+ *
+ */
+typedef struct _ADCConfirm
+{
+    volatile bool active;                                               //!< Flag whether a confirmation is running
+    volatile uint32_t pendingADCs;                                      //!< Bit mask of ADC instances which haven't finished yet
+    uint32_t channelMask;                                               //!< Bit mask of requested channels
+    uint32_t rankCount[ADC_INSTANCE_COUNT];                             //!< Number of injected ranks per ADC
+    ADC_Channel_t rankChannel[ADC_INSTANCE_COUNT][ADC_MAX_INJECTED_LENGTH];  //!< Logical channel of each injected rank per ADC
+    int32_t rawValues[ADC_CHANNEL_COUNT];                               //!< Results, indexed by ADC_Channel_t
+    ADCConfirmCallback pCallback;                                       //!< Callback which receives the result
+} ADCConfirm_t;
+
+/**
+ * @brief Internal data of the raw capture diagnostic mode
+ *
+ */
+typedef struct _ADCCapture
+{
+    volatile ADC_CaptureState_t state;          //!< Current state of the capture
+    uint32_t channelMask;                       //!< Bit mask of captured channels
+    uint32_t channelCount;                      //!< Number of captured channels
+    uint32_t sampleRateHz;                      //!< Actual trigger rate during the capture
+    uint32_t previousRateHz;                    //!< Trigger rate before the capture (restored afterwards)
+    uint32_t sequenceCount;                     //!< Number of sequences to capture
+    uint32_t startTick;                         //!< HAL tick at the start of the capture
+    volatile uint32_t sampleCount;              //!< Number of samples written to the buffer
+    uint32_t sampleTarget;                      //!< Number of samples to capture
+    uint32_t streamOffset;                      //!< Number of sample bytes already streamed
+    bool headerSent;                            //!< Flag whether the dump header has been sent
+} ADCCapture_t;
+
 
 /***** PRIVATE PROTOTYPES ****************************************************/
 
 static void adcInitializeDMA(void);
+static uint32_t adcGetSequenceLength(ADC_Group_t group);
+static uint32_t adcMicroVoltToDigits(ADC_Channel_t adcChannel, int32_t microVolt);
+static void adcWatchdogFired(ADC_HandleTypeDef* hadc, ADC_Watchdog_t watchdog);
+static void adcStartConversion(void);
+static void adcStopConversion(void);
+static int32_t adcApplySampleRate(uint32_t sampleRateHz, uint32_t* pActualHz);
+static void adcPublishSequence(const uint32_t* pSequence);
+static void adcPublishHousekeeping(void);
+static void adcPublishSnapshot(ADC_Group_t group, const int32_t* pValues);
+static int32_t adcStartHousekeeping(void);
+static uint32_t adcGetInstanceIndex(ADC_HandleTypeDef* hadc);
+static void adcAbortInjected(ADC_HandleTypeDef* hadc);
+static void adcConfirmComplete(ADC_HandleTypeDef* hadc);
+static void adcConfirmCancel(void);
+static void adcCaptureSequence(const int32_t* pValues);
+static void adcPutU16(uint8_t* pBuffer, uint16_t value);
+static void adcPutU32(uint8_t* pBuffer, uint32_t value);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
-static ADC_HandleTypeDef gADCHandle;                //!< Global handle for ADC peripheral
+static ADC_HandleTypeDef gADCHandle;                //!< Global handle for ADC peripheral (ADC1, master)
+static ADC_HandleTypeDef gADC2Handle;               //!< Global handle for ADC2 peripheral (slave, POT2)
 static DMA_HandleTypeDef gDMA_ADC_Handle;           //!< Global handle for DMA peripheral used for ADC data transfer
 
-static uint32_t gADCValues[ADC_CHANNEL_COUNT];      //!< Global array for ADC values used by the DMA transfer
+/**
+ * @brief Global array for ADC values used by the DMA transfer
+ *
+ * The buffer holds two complete conversion sequences. While the DMA writes
+ * one half, the other half is stable and gets published as snapshot.
+ */
+static uint32_t gADCValues[ADC_DMA_BUFFER_LENGTH];
+
+static volatile uint32_t gSnapshotLock[ADC_GROUP_COUNT];   //!< Sequence lock counters for gSnapshot (odd = write in progress)
+static volatile ADCSnapshot_t gSnapshot[ADC_GROUP_COUNT];   //!< Last complete conversion sequence of each group
+static ADCGroupCallback gGroupCallback[ADC_GROUP_COUNT];    //!< Callbacks called after a sequence of a group has been published
+
+static uint32_t gSequenceLength;                    //!< Number of ranks in the regular sequence of each ADC (fast group)
+static uint32_t gInjectedLength;                    //!< Number of ranks in the injected sequence of the master (housekeeping group)
+
+static volatile uint32_t gHousekeepingIntervalMs = ADC_HOUSEKEEPING_MS;   //!< Interval of the housekeeping conversion (0 = on demand)
+static uint32_t gHousekeepingTick;                  //!< HAL tick of the last housekeeping start
+static volatile bool gHousekeepingPending;          //!< Housekeeping has been aborted by a confirmation and is repeated
+static uint32_t gHousekeepingJSQR;                  //!< Injected sequence of the housekeeping group (restored after a confirmation)
+
+static ADCConfirm_t gConfirm;                       //!< State of the injected confirmation conversion
+static ADC_HandleTypeDef* const ADC_INSTANCES[ADC_INSTANCE_COUNT] = { &gADCHandle, &gADC2Handle };  //!< Used ADC instances
+
+/**
+ * @brief Descriptor table of all logical channels (indexed by ADC_Channel_t)
+ *
+ * Initialization, DMA transfer length and reads are derived from this
+ * table, so adding a sensor only requires a new enum value and a new row.
+ * Fast channels with the same rank on master and slave are converted at the
+ * same instant and must use the same sampling time. Housekeeping channels
+ * change on a seconds timescale and are converted as injected group of the
+ * master, which interrupts the regular sequence and resumes it afterwards.
+ *
+ * Minimum sampling times at 32MHz ADC clock (datasheet): temperature
+ * sensor 5us, VBAT 12us, VREFINT 4us. VBAT is measured via an internal
+ * 1/3 divider.
+ */
+static const ADCChannelDescriptor_t ADC_CHANNEL_TABLE[ADC_CHANNEL_COUNT] =
+{
+    /* ADC          Group                       HAL channel                     Rank    Sampling time                   GPIO port           GPIO pin    Scaling [µV/digit] */
+    { &gADCHandle,  ADC_GROUP_FAST,             ADC_CHANNEL_1,                  1,      ADC_SAMPLETIME_47CYCLES_5,      POT1_GPIO_PORT,     POT1_PIN,   ADC_MICROVOLTS_PER_DIGIT     },  // ADC_INPUT0
+    { &gADC2Handle, ADC_GROUP_FAST,             ADC_CHANNEL_2,                  1,      ADC_SAMPLETIME_47CYCLES_5,      POT2_GPIO_PORT,     POT2_PIN,   ADC_MICROVOLTS_PER_DIGIT     },  // ADC_INPUT1
+    { &gADCHandle,  ADC_GROUP_HOUSEKEEPING,     ADC_CHANNEL_TEMPSENSOR_ADC1,    1,      ADC_SAMPLETIME_247CYCLES_5,     0,                  0,          ADC_MICROVOLTS_PER_DIGIT     },  // ADC_TEMP
+    { &gADCHandle,  ADC_GROUP_HOUSEKEEPING,     ADC_CHANNEL_VBAT,               2,      ADC_SAMPLETIME_640CYCLES_5,     0,                  0,          3 * ADC_MICROVOLTS_PER_DIGIT },  // ADC_VBAT
+    { &gADCHandle,  ADC_GROUP_HOUSEKEEPING,     ADC_CHANNEL_VREFINT,            3,      ADC_SAMPLETIME_247CYCLES_5,     0,                  0,          ADC_MICROVOLTS_PER_DIGIT     }   // ADC_VREF
+};
+
+static ADCWatchdogCallback gWatchdogCallback = 0;   //!< Callback which is called if an analog watchdog fires
+static ADC_HandleTypeDef* gWatchdogHandle[ADC_WATCHDOG_COUNT];          //!< ADC on which each analog watchdog is configured
+static ADC_AnalogWDGConfTypeDef gWatchdogConfig[ADC_WATCHDOG_COUNT];    //!< Current configuration of the analog watchdogs
+static ADC_Channel_t gWatchdogChannel[ADC_WATCHDOG_COUNT];              //!< Channel monitored by each analog watchdog
+static bool gWatchdogConfigured[ADC_WATCHDOG_COUNT];                   //!< Flags whether an analog watchdog has been configured
+
+static ADCCapture_t gCapture;                                   //!< State of the raw capture diagnostic mode
+static uint16_t gCaptureBuffer[ADC_CAPTURE_MAX_SAMPLES];        //!< RAM buffer for the raw capture
 
 
 /***** PUBLIC FUNCTIONS ******************************************************/
@@ -60,13 +224,30 @@ int32_t adcInitialize()
     /* Initialize DMA block for use with ADC */
     adcInitializeDMA();
 
-    memset(gADCValues, 0, ADC_CHANNEL_COUNT * sizeof(uint32_t));
+    memset(gADCValues, 0, sizeof(gADCValues));
+
+    gSequenceLength = adcGetSequenceLength(ADC_GROUP_FAST);
+    gInjectedLength = adcGetSequenceLength(ADC_GROUP_HOUSEKEEPING);
+    if (gSequenceLength == 0 || gInjectedLength > ADC_MAX_INJECTED_LENGTH)
+    {
+        return ADC_ERR_INIT_FAILURE;
+    }
 
     /**
      * Common config
+     *
+     * ADC1 (master) and ADC2 (slave) run in dual regular simultaneous mode
+     * for the fast group: ADC2 converts POT2 at the same time as ADC1 converts
+     * POT1. Both results of a rank are packed into one 32 bit word
+     * (master: bits 0..15, slave: bits 16..31) and moved by one DMA transfer.
+     *
+     * The housekeeping group is the injected group of ADC1, started by
+     * software. Its end of sequence interrupt is used, therefore the EOC
+     * selection is "sequence" (the regular group only uses the DMA).
      */
     ADC_MultiModeTypeDef multimode = {0};
     ADC_ChannelConfTypeDef sConfig = {0};
+    ADC_InjectionConfTypeDef sConfigInjected = {0};
 
     gADCHandle.Instance 					= ADC1;
     gADCHandle.Init.ClockPrescaler 			= ADC_CLOCK_SYNC_PCLK_DIV4;
@@ -74,10 +255,10 @@ int32_t adcInitialize()
     gADCHandle.Init.DataAlign 				= ADC_DATAALIGN_RIGHT;
     gADCHandle.Init.GainCompensation 		= 0;
     gADCHandle.Init.ScanConvMode 			= ADC_SCAN_ENABLE;
-    gADCHandle.Init.EOCSelection 			= ADC_EOC_SINGLE_CONV;
+    gADCHandle.Init.EOCSelection 			= ADC_EOC_SEQ_CONV;
     gADCHandle.Init.LowPowerAutoWait 		= DISABLE;
     gADCHandle.Init.ContinuousConvMode 		= DISABLE;
-    gADCHandle.Init.NbrOfConversion 		= 5;
+    gADCHandle.Init.NbrOfConversion 		= gSequenceLength;
     gADCHandle.Init.DiscontinuousConvMode 	= DISABLE;
     gADCHandle.Init.ExternalTrigConv 		= ADC_EXTERNALTRIG_T3_TRGO;
     gADCHandle.Init.ExternalTrigConvEdge 	= ADC_EXTERNALTRIGCONVEDGE_RISING;
@@ -90,69 +271,122 @@ int32_t adcInitialize()
     	Error_Handler();
     }
 
+    /* The slave uses the same settings, but is triggered by the master and
+     * doesn't use an own DMA channel */
+    gADC2Handle.Instance                    = ADC2;
+    gADC2Handle.Init                        = gADCHandle.Init;
+    gADC2Handle.Init.ExternalTrigConv       = ADC_SOFTWARE_START;
+    gADC2Handle.Init.DMAContinuousRequests  = DISABLE;
+
+    if (HAL_ADC_Init(&gADC2Handle) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
 	/** Configure the ADC multi-mode
 	*/
-	multimode.Mode = ADC_MODE_INDEPENDENT;
+	multimode.Mode              = ADC_DUALMODE_REGSIMULT;
+	multimode.DMAAccessMode     = ADC_DMAACCESSMODE_12_10_BITS;
+	multimode.TwoSamplingDelay  = ADC_TWOSAMPLINGDELAY_1CYCLE;
 	if (HAL_ADCEx_MultiModeConfigChannel(&gADCHandle, &multimode) != HAL_OK)
 	{
 		Error_Handler();
 	}
 
-	/** Configure Regular Channel
+	/** Configure Regular Channels (fast group) of master and slave from the descriptor table
 	*/
-	sConfig.Channel 		= ADC_CHANNEL_1;
-	sConfig.Rank 			= ADC_REGULAR_RANK_1;
-	sConfig.SamplingTime 	= ADC_SAMPLETIME_92CYCLES_5;
+	const ADCChannelDescriptor_t* pFillChannel = 0;
+	uint32_t slaveRanks = 0;
+
 	sConfig.SingleDiff 		= ADC_SINGLE_ENDED;
 	sConfig.OffsetNumber 	= ADC_OFFSET_NONE;
 	sConfig.Offset 			= 0;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
-	{
-		Error_Handler();
-	}
 
-	/** Configure Regular Channel
-	*/
-	sConfig.Channel 		= ADC_CHANNEL_2;
-	sConfig.Rank 			= ADC_REGULAR_RANK_2;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
+	for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
 	{
-		Error_Handler();
-	}
+		const ADCChannelDescriptor_t* pChannel = &ADC_CHANNEL_TABLE[i];
 
-	/** Configure Regular Channel
-	*/
-	sConfig.Channel 		= ADC_CHANNEL_TEMPSENSOR_ADC1;
-	sConfig.Rank 			= ADC_REGULAR_RANK_3;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
-	{
-		Error_Handler();
+		if (pChannel->group != ADC_GROUP_FAST)
+		{
+			continue;
+		}
+
+		sConfig.Channel 		= pChannel->halChannel;
+		sConfig.Rank 			= ADC_HAL_RANKS[pChannel->rank - 1];
+		sConfig.SamplingTime 	= pChannel->samplingTime;
+		if (HAL_ADC_ConfigChannel(pChannel->pHandle, &sConfig) != HAL_OK)
+		{
+			Error_Handler();
+		}
+
+		if (pChannel->pHandle == &gADC2Handle)
+		{
+			slaveRanks |= 1U << (pChannel->rank - 1);
+			pFillChannel = pChannel;
+		}
 	}
 
-	/** Configure Regular Channel
+	/** Fill unused ranks of the slave
+	 *
+	 * In simultaneous mode both sequences must have the same length, otherwise
+	 * the packed DMA transfer gets out of step. The slave results of these
+	 * ranks are not used, they just repeat a slave channel.
 	*/
-	sConfig.Channel 		= ADC_CHANNEL_VBAT;
-	sConfig.Rank 			= ADC_REGULAR_RANK_4;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
+	for (uint32_t rank = 1; rank <= gSequenceLength && pFillChannel != 0; rank++)
 	{
-		Error_Handler();
+		if ((slaveRanks & (1U << (rank - 1))) == 0)
+		{
+			sConfig.Channel 		= pFillChannel->halChannel;
+			sConfig.Rank 			= ADC_HAL_RANKS[rank - 1];
+			sConfig.SamplingTime 	= pFillChannel->samplingTime;
+			if (HAL_ADC_ConfigChannel(&gADC2Handle, &sConfig) != HAL_OK)
+			{
+				Error_Handler();
+			}
+		}
 	}
 
-	/** Configure Regular Channel
+	/** Configure Injected Channels (housekeeping group) of the master
 	*/
-	sConfig.Channel 		= ADC_CHANNEL_VREFINT;
-	sConfig.Rank 			= ADC_REGULAR_RANK_5;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
+	sConfigInjected.InjectedSingleDiff 				= ADC_SINGLE_ENDED;
+	sConfigInjected.InjectedOffsetNumber 			= ADC_OFFSET_NONE;
+	sConfigInjected.InjectedOffset 					= 0;
+	sConfigInjected.InjectedNbrOfConversion 		= gInjectedLength;
+	sConfigInjected.InjectedDiscontinuousConvMode 	= DISABLE;
+	sConfigInjected.AutoInjectedConv 				= DISABLE;
+	sConfigInjected.QueueInjectedContext 			= DISABLE;
+	sConfigInjected.ExternalTrigInjecConv 			= ADC_INJECTED_SOFTWARE_START;
+	sConfigInjected.ExternalTrigInjecConvEdge 		= ADC_EXTERNALTRIGINJECCONV_EDGE_NONE;
+	sConfigInjected.InjecOversamplingMode 			= DISABLE;
+
+	for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
 	{
-		Error_Handler();
+		const ADCChannelDescriptor_t* pChannel = &ADC_CHANNEL_TABLE[i];
+
+		if (pChannel->group != ADC_GROUP_HOUSEKEEPING)
+		{
+			continue;
+		}
+
+		sConfigInjected.InjectedChannel 		= pChannel->halChannel;
+		sConfigInjected.InjectedRank 			= ADC_HAL_INJECTED_RANKS[pChannel->rank - 1];
+		sConfigInjected.InjectedSamplingTime 	= pChannel->samplingTime;
+		if (HAL_ADCEx_InjectedConfigChannel(&gADCHandle, &sConfigInjected) != HAL_OK)
+		{
+			Error_Handler();
+		}
 	}
 
-	/* Calibrate the ADC */
+	/* The injected sequence is shared with the confirmation conversion */
+	gHousekeepingJSQR = gADCHandle.Instance->JSQR;
+
+	/* Calibrate both ADCs */
     HAL_ADCEx_Calibration_Start(&gADCHandle, ADC_SINGLE_ENDED);
+    HAL_ADCEx_Calibration_Start(&gADC2Handle, ADC_SINGLE_ENDED);
 
     // Start ADC in DMA mode
     // This assumes, that DMA peripheral has been already configured
-    HAL_ADC_Start_DMA(&gADCHandle, gADCValues, ADC_CHANNEL_COUNT);
+    adcStartConversion();
 
 	return ADC_ERR_OK;
 }
@@ -189,15 +423,21 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
 	__HAL_RCC_ADC12_CLK_ENABLE();
 
 	__HAL_RCC_GPIOA_CLK_ENABLE();
-	/**ADC1 GPIO Configuration
-	PA0     ------> ADC1_IN1
-	PA1     ------> ADC1_IN2
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+
+	/** ADC1/ADC2 GPIO Configuration (all external channels of the descriptor table)
 	*/
-	//GPIO_InitStruct.Pin 	= POT1_PIN | POT2_PIN;
-	GPIO_InitStruct.Pin 	= POT1_PIN;
-	GPIO_InitStruct.Mode 	= GPIO_MODE_ANALOG;
-	GPIO_InitStruct.Pull 	= GPIO_NOPULL;
-	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+	for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+	{
+		if (ADC_CHANNEL_TABLE[i].pPort != 0)
+		{
+			GPIO_InitStruct.Pin 	= ADC_CHANNEL_TABLE[i].pin;
+			GPIO_InitStruct.Mode 	= GPIO_MODE_ANALOG;
+			GPIO_InitStruct.Pull 	= GPIO_NOPULL;
+			HAL_GPIO_Init(ADC_CHANNEL_TABLE[i].pPort, &GPIO_InitStruct);
+		}
+	}
 
 	/* ADC1 DMA Init */
 	/* ADC1 Init */
@@ -222,44 +462,507 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
 	HAL_NVIC_SetPriority(ADC1_2_IRQn, 0, 0);
 	HAL_NVIC_EnableIRQ(ADC1_2_IRQn);
   }
+
+  /* ADC2 (slave) shares clock, GPIO and interrupt with ADC1 and transfers its
+   * results via the DMA channel of the master. Nothing else to set up. */
 }
 
 int32_t adcReadChannelRaw(ADC_Channel_t adcChannel)
 {
-    int32_t adcValue = 0;
+    if (adcChannel >= ADC_CHANNEL_COUNT)
+    {
+        return 0;
+    }
+
+    return gSnapshot[ADC_CHANNEL_TABLE[adcChannel].group].rawValues[adcChannel];
+}
+
+int32_t adcReadChannel(ADC_Channel_t adcChannel)
+{
+    if (adcChannel >= ADC_CHANNEL_COUNT)
+    {
+        return 0;
+    }
+
+    return adcReadChannelRaw(adcChannel) * ADC_CHANNEL_TABLE[adcChannel].microVoltsPerDigit;
+}
+
+int32_t adcGetSnapshot(ADCSnapshot_t* pSnapshot)
+{
+    return adcGetGroupSnapshot(ADC_GROUP_FAST, pSnapshot);
+}
+
+int32_t adcGetGroupSnapshot(ADC_Group_t group, ADCSnapshot_t* pSnapshot)
+{
+    if (group >= ADC_GROUP_COUNT || pSnapshot == 0)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
 
-    switch(adcChannel)
+    volatile ADCSnapshot_t* pSource = &gSnapshot[group];
+    uint32_t lockBefore;
+    uint32_t lockAfter;
+
+    do
     {
-        case ADC_INPUT0:
-            adcValue = gADCValues[IDX_ADC_INPUT0];
-            break;
+        lockBefore = gSnapshotLock[group];
+        __DMB();
 
-        case ADC_INPUT1:
-            adcValue = gADCValues[IDX_ADC_INPUT1];
-            break;
+        pSnapshot->sequenceNumber = pSource->sequenceNumber;
+        pSnapshot->timestamp = pSource->timestamp;
+        for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+        {
+            pSnapshot->rawValues[i] = pSource->rawValues[i];
+        }
 
-        case ADC_TEMP:
-            adcValue = gADCValues[IDX_ADC_TEMP];
-            break;
+        __DMB();
+        lockAfter = gSnapshotLock[group];
+    } while ((lockBefore & 1U) != 0U || lockBefore != lockAfter);
 
-        case ADC_VBAT:
-            adcValue = gADCValues[IDX_ADC_VBAT];
-            break;
+    return ADC_ERR_OK;
+}
 
-        case ADC_VREF:
-            adcValue = gADCValues[IDX_ADC_VREF];
-            break;
+int32_t adcRegisterGroupCallback(ADC_Group_t group, ADCGroupCallback pCallback)
+{
+    if (group >= ADC_GROUP_COUNT)
+    {
+        return ADC_ERR_INVALID_PARAM;
     }
 
-    return adcValue;
+    gGroupCallback[group] = pCallback;
+
+    return ADC_ERR_OK;
 }
 
-int32_t adcReadChannel(ADC_Channel_t adcChannel)
+int32_t adcSetHousekeepingInterval(uint32_t intervalMs)
 {
-    int32_t adcRawValue = adcReadChannelRaw(adcChannel);
-    int32_t adcMicroVoltValue = adcRawValue * MICROVOLTS_PER_DIGIT;
+    gHousekeepingIntervalMs = intervalMs;
 
-    return adcMicroVoltValue;
+    return ADC_ERR_OK;
+}
+
+int32_t adcTriggerHousekeeping()
+{
+    return adcStartHousekeeping();
+}
+
+int32_t adcConfirmStart(uint32_t channelMask, ADCConfirmCallback pCallback)
+{
+    if (pCallback == 0 || channelMask == 0 || (channelMask >> ADC_CHANNEL_COUNT) != 0)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    if (gConfirm.active)
+    {
+        return ADC_ERR_BUSY;
+    }
+
+    uint32_t jsqr[ADC_INSTANCE_COUNT] = {0};
+
+    gConfirm.rankCount[0] = 0;
+    gConfirm.rankCount[1] = 0;
+
+    /* Build the injected sequence of each ADC */
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        if ((channelMask & (1U << i)) == 0)
+        {
+            continue;
+        }
+
+        uint32_t index = adcGetInstanceIndex(ADC_CHANNEL_TABLE[i].pHandle);
+        uint32_t rank = gConfirm.rankCount[index];
+
+        if (rank >= ADC_MAX_INJECTED_LENGTH)
+        {
+            return ADC_ERR_INVALID_PARAM;
+        }
+
+        jsqr[index] |= __LL_ADC_CHANNEL_TO_DECIMAL_NB(ADC_CHANNEL_TABLE[i].halChannel) << ADC_JSQR_POSITIONS[rank];
+        gConfirm.rankChannel[index][rank] = (ADC_Channel_t)i;
+        gConfirm.rankCount[index] = rank + 1;
+    }
+
+    gConfirm.active         = true;
+    gConfirm.channelMask    = channelMask;
+    gConfirm.pCallback      = pCallback;
+    gConfirm.pendingADCs    = 0;
+
+    for (uint32_t index = 0; index < ADC_INSTANCE_COUNT; index++)
+    {
+        if (gConfirm.rankCount[index] != 0)
+        {
+            gConfirm.pendingADCs |= 1U << index;
+        }
+    }
+
+    /* Software trigger (JEXTEN = 0), JL = number of ranks - 1. The injected
+     * sequence can only be written while no injected conversion is ongoing,
+     * so a running housekeeping conversion is aborted (confirmation has
+     * priority) and repeated afterwards. */
+    for (uint32_t index = 0; index < ADC_INSTANCE_COUNT; index++)
+    {
+        if (gConfirm.rankCount[index] == 0)
+        {
+            continue;
+        }
+
+        ADC_HandleTypeDef* hadc = ADC_INSTANCES[index];
+
+        if (LL_ADC_INJ_IsConversionOngoing(hadc->Instance))
+        {
+            adcAbortInjected(hadc);
+            gHousekeepingPending = true;
+        }
+
+        hadc->Instance->JSQR = jsqr[index] | ((gConfirm.rankCount[index] - 1) << ADC_JSQR_JL_Pos);
+
+        __HAL_ADC_CLEAR_FLAG(hadc, ADC_FLAG_JEOC | ADC_FLAG_JEOS);
+        __HAL_ADC_ENABLE_IT(hadc, ADC_IT_JEOS);
+        LL_ADC_INJ_StartConversion(hadc->Instance);
+    }
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcSetSampleRate(uint32_t sampleRateHz, uint32_t* pActualHz)
+{
+    /* The capture owns the trigger rate until the buffer is complete */
+    if (gCapture.state == ADC_CAPTURE_RUNNING || gCapture.state == ADC_CAPTURE_COMPLETE)
+    {
+        return ADC_ERR_BUSY;
+    }
+
+    return adcApplySampleRate(sampleRateHz, pActualHz);
+}
+
+uint32_t adcGetSampleRate()
+{
+    return timerGetTriggerFrequency();
+}
+
+int32_t adcCaptureStart(uint32_t channelMask, uint32_t sampleRateHz, uint32_t sequenceCount)
+{
+    if (gCapture.state != ADC_CAPTURE_IDLE)
+    {
+        return ADC_ERR_BUSY;
+    }
+
+    uint32_t channelCount = 0;
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        if (channelMask & (1U << i))
+        {
+            /* Only the fast group is converted with the capture rate */
+            if (ADC_CHANNEL_TABLE[i].group != ADC_GROUP_FAST)
+            {
+                return ADC_ERR_INVALID_PARAM;
+            }
+
+            channelCount++;
+        }
+    }
+
+    if (channelCount == 0 || (channelMask >> ADC_CHANNEL_COUNT) != 0 ||
+        sequenceCount == 0 || sequenceCount > ADC_CAPTURE_MAX_SAMPLES / channelCount ||
+        sampleRateHz == 0 || sampleRateHz > ADC_CAPTURE_MAX_RATE_HZ)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    gCapture.channelMask    = channelMask;
+    gCapture.channelCount   = channelCount;
+    gCapture.previousRateHz = timerGetTriggerFrequency();
+    gCapture.sequenceCount  = sequenceCount;
+    gCapture.sampleTarget   = sequenceCount * channelCount;
+    gCapture.sampleCount    = 0;
+    gCapture.streamOffset   = 0;
+    gCapture.headerSent     = false;
+
+    if (adcApplySampleRate(sampleRateHz, &gCapture.sampleRateHz) != ADC_ERR_OK)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    gCapture.startTick = HAL_GetTick();
+    gCapture.state = ADC_CAPTURE_RUNNING;
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcCaptureAbort()
+{
+    if (gCapture.state != ADC_CAPTURE_IDLE)
+    {
+        gCapture.state = ADC_CAPTURE_IDLE;
+        adcApplySampleRate(gCapture.previousRateHz, 0);
+    }
+
+    return ADC_ERR_OK;
+}
+
+ADC_CaptureState_t adcCaptureGetState()
+{
+    return gCapture.state;
+}
+
+int32_t adcCaptureProcess(ADCDumpWriter pWriter)
+{
+    if (pWriter == 0)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    if (gCapture.state == ADC_CAPTURE_COMPLETE)
+    {
+        /* Back to the normal trigger rate before the (slow) dump starts */
+        adcApplySampleRate(gCapture.previousRateHz, 0);
+        gCapture.state = ADC_CAPTURE_STREAMING;
+    }
+
+    if (gCapture.state != ADC_CAPTURE_STREAMING)
+    {
+        return ADC_ERR_OK;
+    }
+
+    if (!gCapture.headerSent)
+    {
+        uint8_t header[ADC_DUMP_HEADER_SIZE] = {0};
+
+        header[0] = 'A';
+        header[1] = 'D';
+        header[2] = 'C';
+        header[3] = 'D';
+        header[4] = ADC_DUMP_VERSION;
+        header[5] = (uint8_t)gCapture.channelCount;
+        adcPutU16(&header[6], (uint16_t)gCapture.channelMask);
+        adcPutU32(&header[8], gCapture.sampleRateHz);
+        adcPutU32(&header[12], gCapture.sequenceCount);
+        adcPutU32(&header[16], (uint32_t)ADC_MICROVOLTS_PER_DIGIT);
+        adcPutU16(&header[20], *VREFINT_CAL_ADDR);
+        adcPutU16(&header[22], *TEMPSENSOR_CAL1_ADDR);
+        adcPutU16(&header[24], *TEMPSENSOR_CAL2_ADDR);
+        adcPutU32(&header[28], gCapture.startTick);
+
+        /* A writer which could not take the data is retried with the next call */
+        if (pWriter(header, ADC_DUMP_HEADER_SIZE) == 0)
+        {
+            gCapture.headerSent = true;
+        }
+
+        return ADC_ERR_OK;
+    }
+
+    uint32_t totalBytes = gCapture.sampleTarget * sizeof(uint16_t);
+
+    if (gCapture.streamOffset < totalBytes)
+    {
+        uint32_t chunk = totalBytes - gCapture.streamOffset;
+        if (chunk > ADC_DUMP_CHUNK_SIZE)
+        {
+            chunk = ADC_DUMP_CHUNK_SIZE;
+        }
+
+        /* The samples are stored little endian, so the buffer can be written as is */
+        if (pWriter((uint8_t*)gCaptureBuffer + gCapture.streamOffset, (int32_t)chunk) == 0)
+        {
+            gCapture.streamOffset += chunk;
+        }
+
+        return ADC_ERR_OK;
+    }
+
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < gCapture.sampleTarget; i++)
+    {
+        checksum += gCaptureBuffer[i];
+    }
+
+    uint8_t trailer[ADC_DUMP_TRAILER_SIZE];
+    adcPutU32(trailer, checksum);
+    if (pWriter(trailer, ADC_DUMP_TRAILER_SIZE) == 0)
+    {
+        gCapture.state = ADC_CAPTURE_IDLE;
+    }
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcConfigureWatchdog(ADC_Watchdog_t watchdog, ADC_Channel_t adcChannel, int32_t lowMicroVolt, int32_t highMicroVolt)
+{
+    if (watchdog >= ADC_WATCHDOG_COUNT || adcChannel >= ADC_CHANNEL_COUNT || lowMicroVolt > highMicroVolt)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    ADC_AnalogWDGConfTypeDef* pConfig = &gWatchdogConfig[watchdog];
+    ADC_HandleTypeDef* pHandle = ADC_CHANNEL_TABLE[adcChannel].pHandle;
+
+    /* The channel selection of a watchdog can only be changed while no conversion
+     * is ongoing. Therefore, the triggered DMA conversion is stopped shortly. */
+    adcStopConversion();
+
+    /* Release the watchdog on the ADC it was used before. This also removes
+     * the previous channel of watchdog 2 and 3, which can monitor several
+     * channels, so that exactly one channel is monitored */
+    if (gWatchdogConfigured[watchdog])
+    {
+        pConfig->WatchdogMode   = ADC_ANALOGWATCHDOG_NONE;
+        pConfig->ITMode         = DISABLE;
+        HAL_ADC_AnalogWDGConfig(gWatchdogHandle[watchdog], pConfig);
+        gWatchdogConfigured[watchdog] = false;
+    }
+
+    pConfig->WatchdogNumber     = ADC_HAL_WATCHDOGS[watchdog];
+    pConfig->WatchdogMode       = (ADC_CHANNEL_TABLE[adcChannel].group == ADC_GROUP_FAST) ? ADC_ANALOGWATCHDOG_SINGLE_REG : ADC_ANALOGWATCHDOG_SINGLE_INJEC;
+    pConfig->Channel            = ADC_CHANNEL_TABLE[adcChannel].halChannel;
+    pConfig->ITMode             = ENABLE;
+    pConfig->LowThreshold       = adcMicroVoltToDigits(adcChannel, lowMicroVolt);
+    pConfig->HighThreshold      = adcMicroVoltToDigits(adcChannel, highMicroVolt);
+    pConfig->FilteringConfig    = ADC_AWD_FILTERING_NONE;
+
+    int32_t result = ADC_ERR_OK;
+
+    if (HAL_ADC_AnalogWDGConfig(pHandle, pConfig) != HAL_OK)
+    {
+        result = ADC_ERR_CONFIG;
+    }
+    else
+    {
+        gWatchdogHandle[watchdog] = pHandle;
+        gWatchdogChannel[watchdog] = adcChannel;
+        gWatchdogConfigured[watchdog] = true;
+    }
+
+    adcStartConversion();
+
+    return result;
+}
+
+int32_t adcSetWatchdogThresholds(ADC_Watchdog_t watchdog, int32_t lowMicroVolt, int32_t highMicroVolt)
+{
+    if (watchdog >= ADC_WATCHDOG_COUNT || !gWatchdogConfigured[watchdog] || lowMicroVolt > highMicroVolt)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    ADC_AnalogWDGConfTypeDef* pConfig = &gWatchdogConfig[watchdog];
+    pConfig->LowThreshold       = adcMicroVoltToDigits(gWatchdogChannel[watchdog], lowMicroVolt);
+    pConfig->HighThreshold      = adcMicroVoltToDigits(gWatchdogChannel[watchdog], highMicroVolt);
+
+    /* While the conversion is running, the HAL only updates the thresholds and
+     * keeps the channel selection and interrupt configuration untouched */
+    if (HAL_ADC_AnalogWDGConfig(gWatchdogHandle[watchdog], pConfig) != HAL_OK)
+    {
+        return ADC_ERR_CONFIG;
+    }
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcRearmWatchdog(ADC_Watchdog_t watchdog)
+{
+    if (watchdog >= ADC_WATCHDOG_COUNT || !gWatchdogConfigured[watchdog])
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    __HAL_ADC_CLEAR_FLAG(gWatchdogHandle[watchdog], ADC_HAL_WATCHDOG_ITS[watchdog]);
+    __HAL_ADC_ENABLE_IT(gWatchdogHandle[watchdog], ADC_HAL_WATCHDOG_ITS[watchdog]);
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcRegisterWatchdogCallback(ADCWatchdogCallback pCallback)
+{
+    gWatchdogCallback = pCallback;
+
+    return ADC_ERR_OK;
+}
+
+/**
+ * @brief Conversion half complete callback: the first sequence of the DMA
+ * buffer is complete and stable while the DMA writes the second one
+ *
+ * @param hadc: ADC handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from the DMA interrupt
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    adcPublishSequence(&gADCValues[0]);
+}
+
+/**
+ * @brief Conversion complete callback: the second sequence of the DMA
+ * buffer is complete and stable while the DMA writes the first one
+ *
+ * @param hadc: ADC handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from the DMA interrupt
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    adcPublishSequence(&gADCValues[gSequenceLength]);
+}
+
+/**
+ * @brief Injected conversion complete callback (end of the housekeeping or
+ * confirmation sequence)
+ *
+ * @param hadc: ADC handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_ADC_IRQHandler()
+ */
+void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    /* The confirmation conversion uses the injected sequence of an ADC
+     * exclusively while it is pending on this ADC */
+    if (gConfirm.active && (gConfirm.pendingADCs & (1U << adcGetInstanceIndex(hadc))) != 0)
+    {
+        adcConfirmComplete(hadc);
+    }
+    else if (hadc == &gADCHandle)
+    {
+        adcPublishHousekeeping();
+    }
+}
+
+/**
+ * @brief Analog watchdog 1 callback
+ *
+ * @param hadc: ADC handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_ADC_IRQHandler()
+ */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc)
+{
+    adcWatchdogFired(hadc, ADC_WATCHDOG1);
+}
+
+/**
+ * @brief Analog watchdog 2 callback
+ *
+ * @param hadc: ADC handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_ADC_IRQHandler()
+ */
+void HAL_ADCEx_LevelOutOfWindow2Callback(ADC_HandleTypeDef* hadc)
+{
+    adcWatchdogFired(hadc, ADC_WATCHDOG2);
+}
+
+/**
+ * @brief Analog watchdog 3 callback
+ *
+ * @param hadc: ADC handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_ADC_IRQHandler()
+ */
+void HAL_ADCEx_LevelOutOfWindow3Callback(ADC_HandleTypeDef* hadc)
+{
+    adcWatchdogFired(hadc, ADC_WATCHDOG3);
 }
 
 
@@ -282,6 +985,376 @@ static void adcInitializeDMA(void)
     HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
 }
 
+/**
+ * @brief Returns the number of ranks in the sequence of a group, which is
+ * the highest rank of the group used in the descriptor table
+ *
+ * @param group         Acquisition group
+ *
+ * @return Sequence length, 0 if the group is empty or the descriptor table is invalid
+ */
+static uint32_t adcGetSequenceLength(ADC_Group_t group)
+{
+    uint32_t sequenceLength = 0;
+
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        uint32_t rank = ADC_CHANNEL_TABLE[i].rank;
+
+        if (ADC_CHANNEL_TABLE[i].group != group)
+        {
+            continue;
+        }
+
+        /* The housekeeping group is only converted by the master */
+        if (rank == 0 || rank > ADC_MAX_SEQUENCE_LENGTH ||
+            (group == ADC_GROUP_HOUSEKEEPING && ADC_CHANNEL_TABLE[i].pHandle != &gADCHandle))
+        {
+            return 0;
+        }
+
+        if (rank > sequenceLength)
+        {
+            sequenceLength = rank;
+        }
+    }
+
+    return sequenceLength;
+}
+
+/**
+ * @brief Converts a voltage in microvolt to ADC digits of a channel (limited
+ * to the 12 bit range of the ADC)
+ *
+ * @param adcChannel    Channel which defines the scaling
+ * @param microVolt     Voltage in microvolt [µV]
+ *
+ * @return Returns the corresponding ADC value in digits
+ */
+static uint32_t adcMicroVoltToDigits(ADC_Channel_t adcChannel, int32_t microVolt)
+{
+    int32_t digits = microVolt / ADC_CHANNEL_TABLE[adcChannel].microVoltsPerDigit;
+
+    if (digits < 0)
+    {
+        digits = 0;
+    }
+    else if (digits > ADC_MAX_DIGITS)
+    {
+        digits = ADC_MAX_DIGITS;
+    }
+
+    return (uint32_t)digits;
+}
+
+/**
+ * @brief Common handling of a fired analog watchdog. The interrupt of the
+ * watchdog is disabled until it is re-armed by adcRearmWatchdog()
+ *
+ * @param hadc          ADC on which the watchdog fired
+ * @param watchdog      Analog watchdog which fired
+ */
+static void adcWatchdogFired(ADC_HandleTypeDef* hadc, ADC_Watchdog_t watchdog)
+{
+    __HAL_ADC_DISABLE_IT(hadc, ADC_HAL_WATCHDOG_ITS[watchdog]);
+
+    /* Each logical watchdog is only used on one ADC */
+    if (gWatchdogHandle[watchdog] == hadc && gWatchdogCallback != 0)
+    {
+        gWatchdogCallback(watchdog, gWatchdogChannel[watchdog]);
+    }
+}
+
+/**
+ * @brief Starts the triggered dual ADC conversion with DMA transfer
+ */
+static void adcStartConversion(void)
+{
+    HAL_ADCEx_MultiModeStart_DMA(&gADCHandle, gADCValues, ADC_DMA_SEQUENCES * gSequenceLength);
+}
+
+/**
+ * @brief Stops the triggered dual ADC conversion and the DMA transfer
+ */
+static void adcStopConversion(void)
+{
+    HAL_ADCEx_MultiModeStop_DMA(&gADCHandle);
+    adcConfirmCancel();
+}
+
+/**
+ * @brief Restarts the conversion with a new trigger rate
+ *
+ * Stopping the DMA before the timer is reprogrammed ensures that the
+ * restarted transfer begins at the first sequence of the DMA buffer, so the
+ * half/full transfer callbacks stay aligned with the sequences.
+ *
+ * @param sampleRateHz      Requested trigger rate in Hz
+ * @param pActualHz         Optional pointer to return the actually achieved rate in Hz (can be 0)
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+static int32_t adcApplySampleRate(uint32_t sampleRateHz, uint32_t* pActualHz)
+{
+    if (sampleRateHz < ADC_MIN_SAMPLE_RATE_HZ || sampleRateHz > ADC_MAX_SAMPLE_RATE_HZ)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    adcStopConversion();
+    int32_t result = timerSetTriggerFrequency(sampleRateHz, pActualHz);
+    adcStartConversion();
+
+    return (result == TIMER_ERR_OK) ? ADC_ERR_OK : ADC_ERR_CONFIG;
+}
+
+/**
+ * @brief Starts the injected conversion of the housekeeping group
+ *
+ * @return Returns ADC_ERR_OK if the conversion has been started
+ */
+static int32_t adcStartHousekeeping(void)
+{
+    if (gInjectedLength == 0 || gConfirm.active || LL_ADC_INJ_IsConversionOngoing(gADCHandle.Instance))
+    {
+        return ADC_ERR_BUSY;
+    }
+
+    if (HAL_ADCEx_InjectedStart_IT(&gADCHandle) != HAL_OK)
+    {
+        return ADC_ERR_BUSY;
+    }
+
+    gHousekeepingTick = HAL_GetTick();
+    gHousekeepingPending = false;
+
+    return ADC_ERR_OK;
+}
+
+/**
+ * @brief Returns the index of an ADC instance in ADC_INSTANCES
+ *
+ * @param hadc          ADC handle
+ *
+ * @return Index (0 = master, 1 = slave)
+ */
+static uint32_t adcGetInstanceIndex(ADC_HandleTypeDef* hadc)
+{
+    return (hadc == &gADC2Handle) ? 1U : 0U;
+}
+
+/**
+ * @brief Aborts an ongoing injected conversion of an ADC
+ *
+ * @param hadc          ADC handle
+ */
+static void adcAbortInjected(ADC_HandleTypeDef* hadc)
+{
+    __HAL_ADC_DISABLE_IT(hadc, ADC_IT_JEOC | ADC_IT_JEOS);
+
+    LL_ADC_INJ_StopConversion(hadc->Instance);
+    while (LL_ADC_INJ_IsStopConversionOngoing(hadc->Instance))
+    {
+        /* Takes only a few ADC clock cycles */
+    }
+
+    __HAL_ADC_CLEAR_FLAG(hadc, ADC_FLAG_JEOC | ADC_FLAG_JEOS);
+}
+
+/**
+ * @brief Collects the results of the confirmation conversion of one ADC and
+ * calls the callback as soon as all ADCs have finished
+ *
+ * @param hadc          ADC which has finished its injected sequence
+ */
+static void adcConfirmComplete(ADC_HandleTypeDef* hadc)
+{
+    uint32_t index = adcGetInstanceIndex(hadc);
+
+    for (uint32_t rank = 0; rank < gConfirm.rankCount[index]; rank++)
+    {
+        gConfirm.rawValues[gConfirm.rankChannel[index][rank]] = (int32_t)HAL_ADCEx_InjectedGetValue(hadc, ADC_HAL_INJECTED_RANKS[rank]);
+    }
+
+    /* Give the injected sequence of the master back to the housekeeping group */
+    if (hadc == &gADCHandle)
+    {
+        hadc->Instance->JSQR = gHousekeepingJSQR;
+    }
+
+    gConfirm.pendingADCs &= ~(1U << index);
+
+    if (gConfirm.pendingADCs == 0)
+    {
+        gConfirm.pCallback(gConfirm.channelMask, gConfirm.rawValues);
+        gConfirm.active = false;
+    }
+}
+
+/**
+ * @brief Cancels a running confirmation conversion (the conversion of the
+ * ADCs has already been stopped)
+ */
+static void adcConfirmCancel(void)
+{
+    if (gConfirm.active)
+    {
+        gADCHandle.Instance->JSQR = gHousekeepingJSQR;
+        gConfirm.pendingADCs = 0;
+        gConfirm.active = false;
+    }
+}
+
+/**
+ * @brief Publishes a complete conversion sequence of the fast group
+ *
+ * The fast group interrupt also starts the housekeeping group as soon as
+ * its interval has elapsed.
+ *
+ * @param pSequence     Pointer to the stable (packed) sequence inside the DMA buffer
+ */
+static void adcPublishSequence(const uint32_t* pSequence)
+{
+    int32_t values[ADC_CHANNEL_COUNT] = {0};
+
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        if (ADC_CHANNEL_TABLE[i].group != ADC_GROUP_FAST)
+        {
+            continue;
+        }
+
+        uint32_t word = pSequence[ADC_CHANNEL_TABLE[i].rank - 1];
+
+        if (ADC_CHANNEL_TABLE[i].pHandle == &gADC2Handle)
+        {
+            values[i] = (int32_t)ADC_SLAVE_DATA(word);
+        }
+        else
+        {
+            values[i] = (int32_t)ADC_MASTER_DATA(word);
+        }
+    }
+
+    adcPublishSnapshot(ADC_GROUP_FAST, values);
+
+    if (gCapture.state == ADC_CAPTURE_RUNNING)
+    {
+        adcCaptureSequence(values);
+    }
+
+    uint32_t intervalMs = gHousekeepingIntervalMs;
+    if (gHousekeepingPending || (intervalMs != 0 && (HAL_GetTick() - gHousekeepingTick) >= intervalMs))
+    {
+        adcStartHousekeeping();
+    }
+}
+
+/**
+ * @brief Publishes the results of the injected housekeeping sequence
+ */
+static void adcPublishHousekeeping(void)
+{
+    int32_t values[ADC_CHANNEL_COUNT] = {0};
+
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        if (ADC_CHANNEL_TABLE[i].group == ADC_GROUP_HOUSEKEEPING)
+        {
+            values[i] = (int32_t)HAL_ADCEx_InjectedGetValue(&gADCHandle, ADC_HAL_INJECTED_RANKS[ADC_CHANNEL_TABLE[i].rank - 1]);
+        }
+    }
+
+    adcPublishSnapshot(ADC_GROUP_HOUSEKEEPING, values);
+}
+
+/**
+ * @brief Publishes a complete conversion sequence of a group as new snapshot
+ * and calls the callback of the group
+ *
+ * Writer side of the sequence lock: the lock counter is odd while the
+ * snapshot is updated, so readers can detect a concurrent update.
+ *
+ * @param group         Acquisition group
+ * @param pValues       Raw values of the sequence, indexed by ADC_Channel_t
+ */
+static void adcPublishSnapshot(ADC_Group_t group, const int32_t* pValues)
+{
+    volatile ADCSnapshot_t* pSnapshot = &gSnapshot[group];
+
+    gSnapshotLock[group]++;
+    __DMB();
+
+    pSnapshot->sequenceNumber++;
+    pSnapshot->timestamp = HAL_GetTick();
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        pSnapshot->rawValues[i] = pValues[i];
+    }
+
+    __DMB();
+    gSnapshotLock[group]++;
+
+    if (gGroupCallback[group] != 0)
+    {
+        /* Only this interrupt writes the snapshot, so it is stable during the call */
+        gGroupCallback[group](group, (const ADCSnapshot_t*)pSnapshot);
+    }
+}
+
+/**
+ * @brief Appends the selected channels of a conversion sequence to the
+ * capture buffer (called from the DMA interrupt)
+ *
+ * @param pValues       Raw values of the sequence, indexed by ADC_Channel_t
+ */
+static void adcCaptureSequence(const int32_t* pValues)
+{
+    uint32_t sampleCount = gCapture.sampleCount;
+
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        if (gCapture.channelMask & (1U << i))
+        {
+            gCaptureBuffer[sampleCount++] = (uint16_t)pValues[i];
+        }
+    }
+
+    gCapture.sampleCount = sampleCount;
+
+    /* The trigger rate is restored by adcCaptureProcess() outside of the interrupt */
+    if (sampleCount >= gCapture.sampleTarget)
+    {
+        gCapture.state = ADC_CAPTURE_COMPLETE;
+    }
+}
+
+/**
+ * @brief Writes a 16 bit value little endian into a byte buffer
+ *
+ * @param pBuffer       Destination buffer (at least 2 bytes)
+ * @param value         Value to write
+ */
+static void adcPutU16(uint8_t* pBuffer, uint16_t value)
+{
+    pBuffer[0] = (uint8_t)(value);
+    pBuffer[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Writes a 32 bit value little endian into a byte buffer
+ *
+ * @param pBuffer       Destination buffer (at least 4 bytes)
+ * @param value         Value to write
+ */
+static void adcPutU32(uint8_t* pBuffer, uint32_t value)
+{
+    pBuffer[0] = (uint8_t)(value);
+    pBuffer[1] = (uint8_t)(value >> 8);
+    pBuffer[2] = (uint8_t)(value >> 16);
+    pBuffer[3] = (uint8_t)(value >> 24);
+}
+
 /**
   * @brief This function handles DMA1 channel1 global interrupt.
   */
@@ -291,11 +1364,12 @@ void DMA1_Channel1_IRQHandler(void)
 }
 
 /**
-  * @brief This function handles ADC1 global interrupt.
+  * @brief This function handles ADC1 and ADC2 global interrupt.
   */
 void ADC1_2_IRQHandler(void)
 {
     HAL_ADC_IRQHandler(&gADCHandle);
+    HAL_ADC_IRQHandler(&gADC2Handle);
 }
 
 
@@ -24,6 +24,19 @@
 /***** MACROS ****************************************************************/
 #define ADC_ERR_OK                  0               //!< No error occured
 #define ADC_ERR_INIT_FAILURE        -1              //!< Error during ADC initialization
+#define ADC_ERR_INVALID_PARAM       -2              //!< Invalid parameter (channel, watchdog, thresholds)
+#define ADC_ERR_CONFIG              -3              //!< Error during (re-)configuration of the ADC
+#define ADC_ERR_BUSY                -4              //!< Requested operation not possible in the current state
+
+#define ADC_MICROVOLTS_PER_DIGIT    805             //!< 805 µV / digit at the ADC input (3.3 V reference, 12 bit)
+
+#define ADC_MIN_SAMPLE_RATE_HZ      1               //!< Minimum trigger rate of the conversion sequence
+#define ADC_MAX_SAMPLE_RATE_HZ      20000           //!< Maximum trigger rate of the conversion sequence
+
+#define ADC_HOUSEKEEPING_MS         1000            //!< Default interval of the housekeeping conversion in ms
+
+#define ADC_CAPTURE_MAX_SAMPLES     4096            //!< Size of the raw capture buffer in samples (16 bit each)
+#define ADC_CAPTURE_MAX_RATE_HZ     ADC_MAX_SAMPLE_RATE_HZ  //!< Maximum trigger rate for a raw capture
 
 /***** TYPES *****************************************************************/
 
@@ -37,9 +50,95 @@ typedef enum _ADC_Channel_
     ADC_INPUT1,             //!< ADC Channel 1 used for Pot 2 (Flow Rate Sensor)
     ADC_TEMP,               //!< ADC Channel 2 used for internal Temperature Sensor
     ADC_VBAT,               //!< ADC Channel 3 used for internal VBat voltage
-    ADC_VREF                //!< ADC Channel 4 used for internal reference voltage
+    ADC_VREF,               //!< ADC Channel 4 used for internal reference voltage
+    ADC_CHANNEL_COUNT       //!< Total number of used ADC channels
 } ADC_Channel_t;
 
+/**
+ * @brief Acquisition groups of the ADC
+ *
+ */
+typedef enum _ADC_Group_
+{
+    ADC_GROUP_FAST,             //!< Gas sensors: regular dual ADC sequence, triggered by TIM3 with the sample rate
+    ADC_GROUP_HOUSEKEEPING,     //!< Temperature, VBat, VRef: injected conversion at a low rate or on demand
+    ADC_GROUP_COUNT             //!< Number of acquisition groups
+} ADC_Group_t;
+
+/**
+ * @brief Enumeration for the analog watchdogs of the ADC
+ *
+ * Watchdog 1 compares with the full 12 bit resolution, watchdog 2 and 3
+ * only use the 8 most significant bits of the conversion result (~13 mV steps)
+ */
+typedef enum _ADC_Watchdog_
+{
+    ADC_WATCHDOG1,          //!< Analog watchdog 1 (12 bit thresholds)
+    ADC_WATCHDOG2,          //!< Analog watchdog 2 (8 bit thresholds)
+    ADC_WATCHDOG3,          //!< Analog watchdog 3 (8 bit thresholds)
+    ADC_WATCHDOG_COUNT      //!< Number of available analog watchdogs
+} ADC_Watchdog_t;
+
+/**
+ * @brief Consistent copy of all ADC channels of one complete conversion
+ * sequence of an acquisition group
+ *
+ */
+typedef struct _ADCSnapshot
+{
+    uint32_t sequenceNumber;                    //!< Monotonically increasing number of the conversion sequence
+    uint32_t timestamp;                         //!< HAL tick [ms] at which the sequence has been completed
+    int32_t rawValues[ADC_CHANNEL_COUNT];       //!< Raw values in digits, indexed by ADC_Channel_t (only channels of the group are valid)
+} ADCSnapshot_t;
+
+/**
+ * @brief States of the raw capture diagnostic mode
+ *
+ */
+typedef enum _ADC_CaptureState_
+{
+    ADC_CAPTURE_IDLE,           //!< No capture active
+    ADC_CAPTURE_RUNNING,        //!< Samples are written to the capture buffer
+    ADC_CAPTURE_COMPLETE,       //!< Capture buffer is full, dump not yet started
+    ADC_CAPTURE_STREAMING       //!< Dump of the capture buffer is in progress
+} ADC_CaptureState_t;
+
+/**
+ * @brief Function pointer to write dump data to an output (e.g. uartWriteDebug)
+ *
+ * The writer returns 0 if it took all data. Any other value means nothing
+ * was written and the same data is passed again with the next call.
+ */
+typedef int32_t (*ADCDumpWriter)(uint8_t* pData, int32_t length);
+
+/**
+ * @brief Function pointer for the analog watchdog callback
+ *
+ * The callback is called from the ADC interrupt as soon as a conversion of
+ * the monitored channel is outside of the configured window. Therefore, the
+ * callback should only post an event and return.
+ */
+typedef void (*ADCWatchdogCallback)(ADC_Watchdog_t watchdog, ADC_Channel_t adcChannel);
+
+/**
+ * @brief Function pointer for the callback of an acquisition group
+ *
+ * The callback is called from interrupt context after a complete sequence
+ * of the group has been published. The snapshot is only valid during the call.
+ */
+typedef void (*ADCGroupCallback)(ADC_Group_t group, const ADCSnapshot_t* pSnapshot);
+
+/**
+ * @brief Function pointer for the callback of a confirmation conversion
+ *
+ * The callback is called from the ADC interrupt as soon as all requested
+ * channels have been converted.
+ *
+ * @param channelMask       Bit mask of converted channels (bit n = ADC_Channel_t n)
+ * @param pRawValues        Raw values in digits, indexed by ADC_Channel_t (only valid during the call)
+ */
+typedef void (*ADCConfirmCallback)(uint32_t channelMask, const int32_t* pRawValues);
+
 
 /***** PROTOTYPES ************************************************************/
 
@@ -52,7 +151,10 @@ int32_t adcInitialize();
 
 /**
  * @brief Reads an ADC channel by returning the global ADC value read via
- * interrupt and DMA and converts it to millivolt
+ * interrupt and DMA and converts it to microvolt
+ *
+ * The scaling of the channel is applied, e.g. ADC_VBAT returns the VBAT
+ * voltage and not the voltage behind the internal divider.
  *
  * @param adcChannel Channel to read
  *
@@ -70,5 +172,203 @@ int32_t adcReadChannel(ADC_Channel_t adcChannel);
  */
 int32_t adcReadChannelRaw(ADC_Channel_t adcChannel);
 
+/**
+ * @brief Reads the values of the fast group channels which belong to the
+ * same (latest complete) conversion sequence
+ *
+ * The snapshot is protected by a sequence lock: the reader retries if the
+ * ADC interrupt has published a new sequence during the copy. Interrupts
+ * are never disabled.
+ *
+ * @param pSnapshot         Pointer to the snapshot to fill
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcGetSnapshot(ADCSnapshot_t* pSnapshot);
+
+/**
+ * @brief Reads the latest complete conversion sequence of an acquisition group
+ *
+ * @param group             Acquisition group to read
+ * @param pSnapshot         Pointer to the snapshot to fill
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcGetGroupSnapshot(ADC_Group_t group, ADCSnapshot_t* pSnapshot);
+
+/**
+ * @brief Registers the callback of an acquisition group
+ *
+ * @param group             Acquisition group
+ * @param pCallback         Callback function (0 to remove the callback)
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcRegisterGroupCallback(ADC_Group_t group, ADCGroupCallback pCallback);
+
+/**
+ * @brief Sets the interval of the housekeeping conversion
+ *
+ * The housekeeping group is started from the fast group interrupt once the
+ * interval has elapsed. The resolution is therefore one fast sample period.
+ *
+ * @param intervalMs        Interval in ms (0 = only on demand via adcTriggerHousekeeping())
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcSetHousekeepingInterval(uint32_t intervalMs);
+
+/**
+ * @brief Starts a conversion of the housekeeping group immediately
+ *
+ * @return Returns ADC_ERR_OK if the conversion has been started, ADC_ERR_BUSY
+ * if an injected conversion is still ongoing
+ */
+int32_t adcTriggerHousekeeping();
+
+/**
+ * @brief Starts an immediate injected conversion of the selected channels
+ * to confirm a threshold crossing without waiting for the next trigger
+ *
+ * The channels are converted by the injected group of their ADC (POT1 on
+ * ADC1 and POT2 on ADC2 in parallel). The injected conversion interrupts the
+ * regular sequence, which resumes afterwards without losing data. A running
+ * housekeeping conversion is aborted and repeated later. The function does
+ * not use the HAL lock and can therefore be called from interrupt context
+ * (e.g. the analog watchdog callback).
+ *
+ * A running confirmation is cancelled without callback if the conversion
+ * is stopped (sample rate change or watchdog configuration).
+ *
+ * @param channelMask       Bit mask of channels to convert (max. 4 channels per ADC)
+ * @param pCallback         Callback which receives the result
+ *
+ * @return Returns ADC_ERR_OK if the conversion has been started, ADC_ERR_BUSY
+ * if a confirmation is still running
+ */
+int32_t adcConfirmStart(uint32_t channelMask, ADCConfirmCallback pCallback);
+
+/**
+ * @brief Changes the trigger rate of the conversion sequence
+ *
+ * The conversion and the DMA transfer are stopped, the trigger timer is
+ * reprogrammed and the conversion is restarted at the beginning of the DMA
+ * buffer. The snapshot keeps the last complete sequence in the meantime.
+ * Used e.g. to sample faster in diagnostics or Emergency and slower in
+ * Pre-Operational to save power.
+ *
+ * @param sampleRateHz      Requested trigger rate in Hz (ADC_MIN_SAMPLE_RATE_HZ..ADC_MAX_SAMPLE_RATE_HZ)
+ * @param pActualHz         Optional pointer to return the actually achieved rate in Hz (can be 0)
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_BUSY during a raw capture
+ */
+int32_t adcSetSampleRate(uint32_t sampleRateHz, uint32_t* pActualHz);
+
+/**
+ * @brief Returns the current trigger rate of the conversion sequence
+ *
+ * @return Trigger rate in Hz
+ */
+uint32_t adcGetSampleRate();
+
+/**
+ * @brief Starts a raw capture of the selected ADC channels
+ *
+ * Only channels of the fast group can be captured.
+ *
+ * The ADC trigger rate is raised to the requested sample rate and the raw
+ * values of the selected channels are written to a RAM buffer for the
+ * given number of conversion sequences. After the capture the previous
+ * trigger rate is restored and the buffer can be dumped via adcCaptureProcess().
+ *
+ * @param channelMask       Bit mask of channels to capture (bit n = ADC_Channel_t n)
+ * @param sampleRateHz      Trigger rate during the capture in Hz
+ * @param sequenceCount     Number of conversion sequences to capture
+ *
+ * @return Returns ADC_ERR_OK if the capture has been started
+ */
+int32_t adcCaptureStart(uint32_t channelMask, uint32_t sampleRateHz, uint32_t sequenceCount);
+
+/**
+ * @brief Aborts a running capture or dump and restores the trigger rate
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcCaptureAbort();
+
+/**
+ * @brief Returns the current state of the raw capture
+ *
+ * @return Current capture state
+ */
+ADC_CaptureState_t adcCaptureGetState();
+
+/**
+ * @brief Cyclic function for the raw capture. As soon as the capture is
+ * complete, the buffer is streamed in small chunks (one chunk per call)
+ * to the provided writer in the following binary format (little endian):
+ *
+ *  - Header (32 bytes): magic "ADCD", version, channel count, channel mask,
+ *    sample rate [Hz], sequence count, µV per digit, VREFINT_CAL, TS_CAL1,
+ *    TS_CAL2, reserved, HAL tick at capture start
+ *  - Samples: sequence count x channel count 16 bit raw values, interleaved
+ *    in channel order
+ *  - Trailer (4 bytes): 32 bit sum of all 16 bit samples
+ *
+ * @param pWriter           Function used to write the dump data
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcCaptureProcess(ADCDumpWriter pWriter);
+
+/**
+ * @brief Configures an analog watchdog to monitor a single ADC channel
+ * against a window [lowMicroVolt, highMicroVolt]
+ *
+ * The ADC conversion is stopped shortly during the configuration. The
+ * watchdog interrupt is armed afterwards.
+ *
+ * @param watchdog          Analog watchdog to configure
+ * @param adcChannel        Channel which should be monitored
+ * @param lowMicroVolt      Lower window threshold in microvolt [µV]
+ * @param highMicroVolt     Upper window threshold in microvolt [µV]
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcConfigureWatchdog(ADC_Watchdog_t watchdog, ADC_Channel_t adcChannel, int32_t lowMicroVolt, int32_t highMicroVolt);
+
+/**
+ * @brief Changes the window thresholds of an already configured analog
+ * watchdog. This can be done while the ADC is running.
+ *
+ * @param watchdog          Analog watchdog to retune
+ * @param lowMicroVolt      Lower window threshold in microvolt [µV]
+ * @param highMicroVolt     Upper window threshold in microvolt [µV]
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcSetWatchdogThresholds(ADC_Watchdog_t watchdog, int32_t lowMicroVolt, int32_t highMicroVolt);
+
+/**
+ * @brief Re-enables the interrupt of an analog watchdog
+ *
+ * After a watchdog has fired, its interrupt is disabled to avoid an
+ * interrupt for every following conversion outside of the window.
+ *
+ * @param watchdog          Analog watchdog to re-arm
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcRearmWatchdog(ADC_Watchdog_t watchdog);
+
+/**
+ * @brief Registers the callback which is called if any analog watchdog fires
+ *
+ * @param pCallback         Callback function (0 to remove the callback)
+ *
+ * @return Returns ADC_ERR_OK if no error occured
+ */
+int32_t adcRegisterWatchdogCallback(ADCWatchdogCallback pCallback);
+
 
 #endif
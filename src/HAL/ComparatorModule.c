@@ -0,0 +1,264 @@
+/******************************************************************************
+ * @file ComparatorModule.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the Comparator Module
+ *
+ * Hardware trip path for the gas sensors, independent of the scheduler:
+ * DAC3 channel 1 (internal only) generates the threshold voltage, COMP3 and
+ * COMP1 compare POT1 and POT2 against it. The comparator interrupt switches
+ * the buzzer on within microseconds.
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "stm32g4xx_hal.h"
+
+#include "System.h"
+#include "HardwareConfig.h"
+#include "ComparatorModule.h"
+#include "GasScale/GasScale.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void compTrip(CompTripInput_t input);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static DAC_HandleTypeDef gDAC3Handle;                   //!< Global handle for DAC3 (threshold voltage)
+static COMP_HandleTypeDef gCompHandles[TRIP_INPUT_COUNT];   //!< Global handles for the comparators (indexed by CompTripInput_t)
+
+static volatile bool gTripped = false;                  //!< Flag whether the trip has fired since the last acknowledge
+static CompTripCallback gTripCallback = 0;              //!< Callback which is called if the trip fires
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t compInitialize(int32_t thresholdMicroVolt)
+{
+    DAC_ChannelConfTypeDef sConfig = {0};
+
+    /* DAC3 is only connected internally (to the comparators), therefore no
+     * output buffer is used */
+    gDAC3Handle.Instance = DAC3;
+    if (HAL_DAC_Init(&gDAC3Handle) != HAL_OK)
+    {
+        return COMP_ERR_INIT_FAILURE;
+    }
+
+    sConfig.DAC_HighFrequency           = DAC_HIGH_FREQUENCY_INTERFACE_MODE_AUTOMATIC;
+    sConfig.DAC_DMADoubleDataMode       = DISABLE;
+    sConfig.DAC_SignedFormat            = DISABLE;
+    sConfig.DAC_SampleAndHold           = DAC_SAMPLEANDHOLD_DISABLE;
+    sConfig.DAC_Trigger                 = DAC_TRIGGER_NONE;
+    sConfig.DAC_Trigger2                = DAC_TRIGGER_NONE;
+    sConfig.DAC_OutputBuffer            = DAC_OUTPUTBUFFER_DISABLE;
+    sConfig.DAC_ConnectOnChipPeripheral = DAC_CHIPCONNECT_INTERNAL;
+    sConfig.DAC_UserTrimming            = DAC_TRIMMING_FACTORY;
+
+    if (HAL_DAC_ConfigChannel(&gDAC3Handle, &sConfig, DAC_CHANNEL_1) != HAL_OK)
+    {
+        return COMP_ERR_INIT_FAILURE;
+    }
+
+    if (compSetThreshold(thresholdMicroVolt) != COMP_ERR_OK)
+    {
+        return COMP_ERR_INVALID_PARAM;
+    }
+
+    if (HAL_DAC_Start(&gDAC3Handle, DAC_CHANNEL_1) != HAL_OK)
+    {
+        return COMP_ERR_INIT_FAILURE;
+    }
+
+    /* Both comparators use the same threshold. The hysteresis suppresses
+     * multiple interrupts caused by noise at the threshold */
+    gCompHandles[TRIP_INPUT_POT1].Instance = COMP3;     // INP = PA0 (POT1)
+    gCompHandles[TRIP_INPUT_POT2].Instance = COMP1;     // INP = PA1 (POT2)
+
+    for (int32_t i = 0; i < TRIP_INPUT_COUNT; i++)
+    {
+        COMP_HandleTypeDef* pComp = &gCompHandles[i];
+
+        pComp->Init.InputPlus       = COMP_INPUT_PLUS_IO1;
+        pComp->Init.InputMinus      = COMP_INPUT_MINUS_DAC3_CH1;
+        pComp->Init.OutputPol       = COMP_OUTPUTPOL_NONINVERTED;
+        pComp->Init.Hysteresis      = COMP_HYSTERESIS_20MV;
+        pComp->Init.BlankingSrce    = COMP_BLANKINGSRC_NONE;
+        pComp->Init.TriggerMode     = COMP_TRIGGERMODE_IT_RISING;
+
+        if (HAL_COMP_Init(pComp) != HAL_OK)
+        {
+            return COMP_ERR_INIT_FAILURE;
+        }
+
+        if (HAL_COMP_Start(pComp) != HAL_OK)
+        {
+            return COMP_ERR_INIT_FAILURE;
+        }
+    }
+
+    /* An input which is already above the threshold generates no edge */
+    for (int32_t i = 0; i < TRIP_INPUT_COUNT; i++)
+    {
+        if (compIsAboveThreshold((CompTripInput_t)i))
+        {
+            compTrip((CompTripInput_t)i);
+        }
+    }
+
+    return COMP_ERR_OK;
+}
+
+int32_t compSetThreshold(int32_t thresholdMicroVolt)
+{
+    if (thresholdMicroVolt < 0)
+    {
+        return COMP_ERR_INVALID_PARAM;
+    }
+
+    uint32_t digits = (uint32_t)gasScaleMicroVoltToDacDigits(thresholdMicroVolt);
+
+    /* Without trigger the new value is transferred to the output with the
+     * next APB clock cycle */
+    if (HAL_DAC_SetValue(&gDAC3Handle, DAC_CHANNEL_1, DAC_ALIGN_12B_R, digits) != HAL_OK)
+    {
+        return COMP_ERR_INVALID_PARAM;
+    }
+
+    return COMP_ERR_OK;
+}
+
+bool compIsTripped()
+{
+    return gTripped;
+}
+
+bool compIsAboveThreshold(CompTripInput_t input)
+{
+    if (input >= TRIP_INPUT_COUNT)
+    {
+        return false;
+    }
+
+    return HAL_COMP_GetOutputLevel(&gCompHandles[input]) == COMP_OUTPUT_LEVEL_HIGH;
+}
+
+int32_t compAcknowledgeTrip()
+{
+    for (int32_t i = 0; i < TRIP_INPUT_COUNT; i++)
+    {
+        if (compIsAboveThreshold((CompTripInput_t)i))
+        {
+            return COMP_ERR_OK;
+        }
+    }
+
+    gTripped = false;
+    HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_SET);
+
+    return COMP_ERR_OK;
+}
+
+int32_t compRegisterTripCallback(CompTripCallback pCallback)
+{
+    gTripCallback = pCallback;
+
+    return COMP_ERR_OK;
+}
+
+/**
+* @brief COMP MSP Initialization
+*
+* @param hcomp: COMP handle pointer
+*
+* @remark: this HAL_COMP_MspInit function is called automatically by the
+* STM32 HAL library
+*/
+void HAL_COMP_MspInit(COMP_HandleTypeDef* hcomp)
+{
+    /* The comparators are clocked via SYSCFG. The input pins are already
+     * configured as analog inputs by the ADC module */
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+    HAL_NVIC_SetPriority(COMP1_2_3_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(COMP1_2_3_IRQn);
+}
+
+/**
+* @brief DAC MSP Initialization
+*
+* @param hdac: DAC handle pointer
+*
+* @remark: this HAL_DAC_MspInit function is called automatically by the
+* STM32 HAL library
+*/
+void HAL_DAC_MspInit(DAC_HandleTypeDef* hdac)
+{
+    if (hdac->Instance == DAC3)
+    {
+        __HAL_RCC_DAC3_CLK_ENABLE();
+    }
+}
+
+/**
+ * @brief Comparator trigger callback
+ *
+ * @param hcomp: COMP handle pointer
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_COMP_IRQHandler()
+ */
+void HAL_COMP_TriggerCallback(COMP_HandleTypeDef* hcomp)
+{
+    for (int32_t i = 0; i < TRIP_INPUT_COUNT; i++)
+    {
+        if (hcomp == &gCompHandles[i])
+        {
+            compTrip((CompTripInput_t)i);
+        }
+    }
+}
+
+/**
+  * @brief This function handles COMP1, COMP2 and COMP3 interrupts through EXTI lines 21, 22 and 29.
+  */
+void COMP1_2_3_IRQHandler(void)
+{
+    HAL_COMP_IRQHandler(&gCompHandles[TRIP_INPUT_POT2]);
+    HAL_COMP_IRQHandler(&gCompHandles[TRIP_INPUT_POT1]);
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Switches the buzzer on (active low) and notifies the application
+ *
+ * @param input         Input which has exceeded the threshold
+ */
+static void compTrip(CompTripInput_t input)
+{
+    HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_RESET);
+    gTripped = true;
+
+    if (gTripCallback != 0)
+    {
+        gTripCallback(input);
+    }
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+ * @file ComparatorModule.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the Comparator Module (hardware trip of the gas
+ * sensor inputs)
+ *
+ *
+ *****************************************************************************/
+#ifndef _COMPARATOR_MODULE_H_
+#define _COMPARATOR_MODULE_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define COMP_ERR_OK                 0               //!< No error occured
+#define COMP_ERR_INIT_FAILURE       -1              //!< Error during initialization of COMP or DAC
+#define COMP_ERR_INVALID_PARAM      -2              //!< Invalid parameter (threshold out of range)
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Inputs monitored by the hardware trip
+ *
+ */
+typedef enum _CompTripInput_
+{
+    TRIP_INPUT_POT1,            //!< POT1 (PA0) monitored by COMP3
+    TRIP_INPUT_POT2,            //!< POT2 (PA1) monitored by COMP1
+    TRIP_INPUT_COUNT            //!< Number of monitored inputs
+} CompTripInput_t;
+
+/**
+ * @brief Function pointer for the trip callback
+ *
+ * The callback is called from the comparator interrupt after the buzzer
+ * has been switched on. Therefore, the callback should only post an event
+ * and return.
+ */
+typedef void (*CompTripCallback)(CompTripInput_t input);
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes the hardware trip: DAC3 channel 1 provides the
+ * threshold voltage for COMP3 (POT1) and COMP1 (POT2). A rising comparator
+ * output triggers an EXTI interrupt which switches the buzzer on.
+ *
+ * The analog inputs are configured by the ADC module.
+ *
+ * @param thresholdMicroVolt    Initial trip threshold in microvolt [µV]
+ *
+ * @return Returns COMP_ERR_OK if no error occured
+ */
+int32_t compInitialize(int32_t thresholdMicroVolt);
+
+/**
+ * @brief Sets the trip threshold (DAC output voltage). A threshold above the
+ * DAC output range is limited to the maximum DAC value.
+ *
+ * @param thresholdMicroVolt    Trip threshold in microvolt [µV]
+ *
+ * @return Returns COMP_ERR_OK if no error occured
+ */
+int32_t compSetThreshold(int32_t thresholdMicroVolt);
+
+/**
+ * @brief Returns whether the hardware trip has fired since the last
+ * acknowledge
+ *
+ * @return Returns true if the trip has fired
+ */
+bool compIsTripped();
+
+/**
+ * @brief Returns whether an input is currently above the threshold
+ *
+ * @param input                 Monitored input
+ *
+ * @return Returns true if the input is above the threshold
+ */
+bool compIsAboveThreshold(CompTripInput_t input);
+
+/**
+ * @brief Acknowledges a trip and switches the buzzer off
+ *
+ * If an input is still above the threshold, the trip remains active.
+ *
+ * @return Returns COMP_ERR_OK if no error occured
+ */
+int32_t compAcknowledgeTrip();
+
+/**
+ * @brief Registers the callback which is called if the hardware trip fires
+ *
+ * @param pCallback             Callback function (0 to remove the callback)
+ *
+ * @return Returns COMP_ERR_OK if no error occured
+ */
+int32_t compRegisterTripCallback(CompTripCallback pCallback);
+
+#endif
@@ -27,16 +27,25 @@
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define TIMER_DEFAULT_FREQUENCY_HZ  100U        //!< Trigger frequency after initialization (10ms cycle)
+#define TIMER_MIN_PERIOD            2U          //!< Minimum number of counts per trigger period
+#define TIMER_MAX_PERIOD            65536U      //!< Maximum number of counts per trigger period (16 bit timer)
+#define TIMER_MAX_PRESCALER         65536U      //!< Maximum division factor of the prescaler (16 bit)
 
 
 /***** PRIVATE TYPES *********************************************************/
 
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t timerGetClockFrequency();
+static int32_t timerCalculateDivider(uint32_t frequencyHz, uint32_t* pPrescaler, uint32_t* pPeriod, uint32_t* pActualHz);
+static int32_t timerInitializeTimebase();
 
 
 /***** PRIVATE VARIABLES *****************************************************/
 static TIM_HandleTypeDef gTimer3Handle;         //! Global handle for Timer 3 (TIM3) peripheral
+static TIM_HandleTypeDef gTimer2Handle;         //! Global handle for Timer 2 (TIM2) peripheral (timebase)
+static uint32_t gTriggerFrequencyHz;            //!< Actual trigger frequency of TIM3 in Hz
 
 
 /***** PUBLIC FUNCTIONS ******************************************************/
@@ -45,16 +54,27 @@ int32_t timerInitialize()
 {
     TIM_ClockConfigTypeDef sClockSourceConfig = {0};
     TIM_MasterConfigTypeDef sMasterConfig = {0};
+    uint32_t prescaler;
+    uint32_t period;
 
-    /* Initialize the Timer to get a 10ms cycle
-     * 128 MHz Peripheral Clock ==> divided by Prescaler ==> 128e6 / 1280 = 100000
-     * Timer Frequency of 100.000 = 100kHz to count to 1000 (0-999) and then generate interrupt
-     * ==> 100kHz / 1000 = 100Hz ==> 10ms
+    /* Initialize the Timer with the default trigger rate of 100Hz (10ms)
+     * timerCalculateDivider() derives PSC and ARR from the requested rate and
+     * the actual timer clock, e.g. 128 MHz / 100Hz = 1280000 counts
+     * ==> prescaler 20 (PSC = 19) and period 64000 (ARR = 63999)
+     *
+     * The update event is only routed to TRGO to start the ADC sequence, no
+     * update interrupt is enabled. timerSetTriggerFrequency() recalculates
+     * PSC and ARR the same way to change the rate during runtime
     */
+    if (timerCalculateDivider(TIMER_DEFAULT_FREQUENCY_HZ, &prescaler, &period, &gTriggerFrequencyHz) != TIMER_ERR_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
     gTimer3Handle.Instance                  = TIM3;
-    gTimer3Handle.Init.Prescaler            = 1280;
+    gTimer3Handle.Init.Prescaler            = prescaler - 1;
     gTimer3Handle.Init.CounterMode          = TIM_COUNTERMODE_UP;
-    gTimer3Handle.Init.Period               = 999;
+    gTimer3Handle.Init.Period               = period - 1;
     gTimer3Handle.Init.ClockDivision        = TIM_CLOCKDIVISION_DIV1;
     gTimer3Handle.Init.AutoReloadPreload    = TIM_AUTORELOAD_PRELOAD_ENABLE;
 
@@ -78,11 +98,56 @@ int32_t timerInitialize()
         return TIMER_ERR_INIT_FAILURE;
     }
 
-    HAL_TIM_Base_Start_IT(&gTimer3Handle);
+    if (HAL_TIM_Base_Start(&gTimer3Handle) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    return timerInitializeTimebase();
+}
+
+int32_t timerSetTriggerFrequency(uint32_t frequencyHz, uint32_t* pActualHz)
+{
+    uint32_t prescaler;
+    uint32_t period;
+    uint32_t actualHz;
+
+    if (timerCalculateDivider(frequencyHz, &prescaler, &period, &actualHz) != TIMER_ERR_OK)
+    {
+        return TIMER_ERR_INVALID_PARAM;
+    }
+
+    /* Stop the counter, load prescaler and period immediately via an update
+     * event (without update interrupt) and restart with a full period */
+    __HAL_TIM_DISABLE(&gTimer3Handle);
+    __HAL_TIM_SET_PRESCALER(&gTimer3Handle, prescaler - 1);
+    __HAL_TIM_SET_AUTORELOAD(&gTimer3Handle, period - 1);
+    __HAL_TIM_URS_ENABLE(&gTimer3Handle);
+    gTimer3Handle.Instance->EGR = TIM_EGR_UG;
+    __HAL_TIM_URS_DISABLE(&gTimer3Handle);
+    __HAL_TIM_SET_COUNTER(&gTimer3Handle, 0);
+    __HAL_TIM_ENABLE(&gTimer3Handle);
+
+    gTriggerFrequencyHz = actualHz;
+
+    if (pActualHz != 0)
+    {
+        *pActualHz = actualHz;
+    }
 
     return TIMER_ERR_OK;
 }
 
+uint32_t timerGetTriggerFrequency()
+{
+    return gTriggerFrequencyHz;
+}
+
+uint32_t timerGetMicroseconds()
+{
+    return TIM2->CNT;
+}
+
 /**
 * @brief TIM_Base MSP Initialization
 * This function configures the hardware resources used in this example
@@ -96,22 +161,116 @@ void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* htim_base)
 {
     if(htim_base->Instance==TIM3)
     {
-        /* Peripheral clock enable */
+        /* Peripheral clock enable, the trigger timer runs without interrupt */
         __HAL_RCC_TIM3_CLK_ENABLE();
+    }
+    else if (htim_base->Instance==TIM2)
+    {
+        /* Peripheral clock enable, the timebase runs without interrupt */
+        __HAL_RCC_TIM2_CLK_ENABLE();
+    }
+}
 
-        /* TIM3 interrupt Init */
-        HAL_NVIC_SetPriority(TIM3_IRQn, 2, 0);
-        HAL_NVIC_EnableIRQ(TIM3_IRQn);
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Returns the counter clock of TIM2 and TIM3 before the prescaler
+ *
+ * The APB1 timers run with twice the PCLK1 frequency if the APB1 prescaler
+ * is not 1.
+ *
+ * @return Timer clock in Hz
+ */
+static uint32_t timerGetClockFrequency()
+{
+    uint32_t clockHz = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        clockHz *= 2;
     }
+
+    return clockHz;
 }
 
 /**
-  * @brief This function handles TIM3 global interrupt.
-  */
-void TIM3_IRQHandler(void)
+ * @brief Starts TIM2 as free running 32 bit counter with 1 MHz
+ *
+ * @return Returns TIMER_ERR_OK if no error occured, otherwise TIMER_ERR_INIT_FAILURE
+ */
+static int32_t timerInitializeTimebase()
 {
-    HAL_TIM_IRQHandler(&gTimer3Handle);
+    uint32_t clockHz = timerGetClockFrequency();
+
+    /* 128 MHz timer clock ==> divided by Prescaler 128 ==> 1 MHz */
+    if (clockHz % TIMER_TIMEBASE_FREQUENCY_HZ != 0 ||
+        clockHz / TIMER_TIMEBASE_FREQUENCY_HZ > TIMER_MAX_PRESCALER)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    gTimer2Handle.Instance                  = TIM2;
+    gTimer2Handle.Init.Prescaler            = clockHz / TIMER_TIMEBASE_FREQUENCY_HZ - 1;
+    gTimer2Handle.Init.CounterMode          = TIM_COUNTERMODE_UP;
+    gTimer2Handle.Init.Period               = 0xFFFFFFFFU;
+    gTimer2Handle.Init.ClockDivision        = TIM_CLOCKDIVISION_DIV1;
+    gTimer2Handle.Init.AutoReloadPreload    = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+    if (HAL_TIM_Base_Init(&gTimer2Handle) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    if (HAL_TIM_Base_Start(&gTimer2Handle) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    return TIMER_ERR_OK;
 }
 
+/**
+ * @brief Calculates prescaler and period for the requested trigger frequency
+ *
+ * The smallest possible prescaler is used, which gives the finest period
+ * resolution and therefore the smallest frequency error.
+ *
+ * @param frequencyHz   Requested trigger frequency in Hz
+ * @param pPrescaler    Division factor of the prescaler (1..65536)
+ * @param pPeriod       Number of counts per trigger period (2..65536)
+ * @param pActualHz     Actually achieved trigger frequency (rounded)
+ *
+ * @return Returns TIMER_ERR_OK if the frequency can be generated, otherwise TIMER_ERR_INVALID_PARAM
+ */
+static int32_t timerCalculateDivider(uint32_t frequencyHz, uint32_t* pPrescaler, uint32_t* pPeriod, uint32_t* pActualHz)
+{
+    uint32_t clockHz = timerGetClockFrequency();
 
-/***** PRIVATE FUNCTIONS *****************************************************/
+    if (frequencyHz == 0 || frequencyHz > clockHz / TIMER_MIN_PERIOD)
+    {
+        return TIMER_ERR_INVALID_PARAM;
+    }
+
+    uint64_t totalCounts = ((uint64_t)clockHz + frequencyHz / 2) / frequencyHz;
+    uint64_t prescaler = (totalCounts + TIMER_MAX_PERIOD - 1) / TIMER_MAX_PERIOD;
+
+    if (prescaler > TIMER_MAX_PRESCALER)
+    {
+        return TIMER_ERR_INVALID_PARAM;
+    }
+
+    uint64_t period = (totalCounts + prescaler / 2) / prescaler;
+    if (period > TIMER_MAX_PERIOD)
+    {
+        period = TIMER_MAX_PERIOD;
+    }
+
+    uint64_t divider = prescaler * period;
+
+    *pPrescaler = (uint32_t)prescaler;
+    *pPeriod    = (uint32_t)period;
+    *pActualHz  = (uint32_t)((clockHz + divider / 2) / divider);
+
+    return TIMER_ERR_OK;
+}
@@ -21,11 +21,13 @@
 #include <stdint.h>
 
 /***** CONSTANTS *************************************************************/
+#define TIMER_TIMEBASE_FREQUENCY_HZ   1000000U  //!< Count frequency of the microsecond timebase (TIM2)
 
 
 /***** MACROS ****************************************************************/
 #define TIMER_ERR_OK                  0         //!< No error occured
 #define TIMER_ERR_INIT_FAILURE        -1        //!< Error during timer initialization
+#define TIMER_ERR_INVALID_PARAM       -2        //!< Invalid parameter (e.g. frequency out of range)
 
 
 /***** TYPES *****************************************************************/
@@ -36,8 +38,43 @@
 /**
  * @brief Initializes the Timer Module
  *
+ * Starts the ADC trigger timer (TIM3) and the free running microsecond
+ * timebase (TIM2).
+ *
  * @return Returns TIMER_ERR_OK if no error occured, otherwiese TIMER_ERR_INIT_FAILURE
  */
 int32_t timerInitialize();
 
+/**
+ * @brief Sets the frequency of the ADC trigger timer (TIM3)
+ *
+ * Prescaler and period are calculated from the current timer clock. The
+ * timer is restarted with the new setting, so the first trigger occurs one
+ * full period after the call.
+ *
+ * @param frequencyHz   Requested trigger frequency in Hz
+ * @param pActualHz     Optional pointer to return the actually achieved frequency in Hz (can be 0)
+ *
+ * @return Returns TIMER_ERR_OK if no error occured, otherwise TIMER_ERR_INVALID_PARAM
+ */
+int32_t timerSetTriggerFrequency(uint32_t frequencyHz, uint32_t* pActualHz);
+
+/**
+ * @brief Returns the actual frequency of the ADC trigger timer
+ *
+ * @return Trigger frequency in Hz (rounded)
+ */
+uint32_t timerGetTriggerFrequency();
+
+/**
+ * @brief Returns the current value of the microsecond timebase
+ *
+ * The 32 bit counter of TIM2 runs freely and wraps around after about
+ * 71 minutes, so only differences of time stamps (unsigned arithmetic)
+ * are meaningful. Can be called from interrupt context.
+ *
+ * @return Time stamp in us
+ */
+uint32_t timerGetMicroseconds();
+
 #endif
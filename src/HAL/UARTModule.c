@@ -10,125 +10,442 @@
  *
  * @brief Implementation of the UART Module
  *
+ * Every port has its own instance with the HAL handles, ring buffers and
+ * statistics. The fixed hardware assignment (peripheral, pins, DMA
+ * channels) is taken from gUARTConfig.
  *
  *****************************************************************************/
 
 
 /***** INCLUDES **************************************************************/
+#include <stdbool.h>
+
 #include "stm32g4xx_hal.h"
 
 #include "System.h"
 #include "HardwareConfig.h"
 #include "UARTModule.h"
+#include "UARTRing.h"
 
 /***** PRIVATE CONSTANTS *****************************************************/
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define UART_LPUART_BRR_MIN         0x00000300U     //!< Minimum LPUART BRR value
+#define UART_LPUART_BRR_MAX         0x000FFFFFU     //!< Maximum LPUART BRR value
+#define UART_USART_BRR_MIN          0x00000010U     //!< Minimum USART BRR value (16 times oversampling)
+#define UART_USART_BRR_MAX          0x0000FFFFU     //!< Maximum USART BRR value
+#define UART_USART_OVERSAMPLING     16U             //!< Oversampling of the USART
+#define UART_PRESCALER_COUNT        12              //!< Number of kernel clock prescalers (see UARTPrescTable)
 
+#define UART_PORT_VALID(port)       ((uint32_t)(port) < UART_PORT_COUNT)     //!< Checks a port passed to the API
 
 /***** PRIVATE TYPES *********************************************************/
 
+/**
+ * @brief Hardware assignment of a UART port
+ *
+ */
+typedef struct _UARTPortConfig_
+{
+    USART_TypeDef* pInstance;               //!< UART peripheral (LPUART or USART)
+    IRQn_Type uartIrq;                      //!< Interrupt of the UART peripheral
+    GPIO_TypeDef* pGpioPort;                //!< GPIO port of the TX and RX pin
+    uint32_t gpioPins;                      //!< TX and RX pin
+    uint32_t gpioAlternate;                 //!< Alternate function of the pins
+    DMA_Channel_TypeDef* pRxDmaChannel;     //!< DMA channel for the reception
+    uint32_t rxDmaRequest;                  //!< DMAMUX request of the reception
+    IRQn_Type rxDmaIrq;                     //!< Interrupt of the RX DMA channel
+    DMA_Channel_TypeDef* pTxDmaChannel;     //!< DMA channel for the transmission
+    uint32_t txDmaRequest;                  //!< DMAMUX request of the transmission
+    IRQn_Type txDmaIrq;                     //!< Interrupt of the TX DMA channel
+} UARTPortConfig_t;
+
+/**
+ * @brief State of a UART port
+ *
+ * The RX head is only written in interrupt context, the RX tail only by
+ * the reader. The TX ring buffer is only modified with interrupts disabled
+ * or from the UART interrupt.
+ */
+typedef struct _UARTInstance_
+{
+    UART_HandleTypeDef handle;              //!< HAL handle of the UART
+    DMA_HandleTypeDef rxDmaHandle;          //!< HAL handle of the DMA channel used for reception
+    DMA_HandleTypeDef txDmaHandle;          //!< HAL handle of the DMA channel used for transmission
+
+    UARTRxRing_t rxRing;                    //!< RX ring buffer, written by the DMA in circular mode
+    uint32_t rxDmaPosition;                 //!< Buffer index of the DMA at the last RX event
+    volatile uint8_t rxEnabled;             //!< Reception is active (cleared by uartStopReception())
+    volatile UARTRxCallback rxCallback;     //!< Called after new data has been published
+
+    UARTTxRing_t txRing;                    //!< TX ring buffer, drained by the DMA
+
+    UARTIrqStats_t irqStats;                //!< Interrupt counters, only written in interrupt context
+
+    uint32_t actualBaudrate;                //!< Baudrate actually generated by the UART
+    int32_t baudrateErrorPpm;               //!< Deviation of the actual from the requested baudrate in ppm
+} UARTInstance_t;
+
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static void uartEnableClocks(UARTPort_t port);
+static uint32_t uartGetKernelClock(UARTPort_t port);
+static int32_t uartCalculatePrescaler(UARTPort_t port, uint32_t baudrate, uint32_t* pPrescaler, uint32_t* pActualBaudrate, int32_t* pErrorPpm);
+static void uartInitializeDMA(UARTPort_t port);
+static UARTInstance_t* uartFindInstance(UART_HandleTypeDef* huart);
+static int32_t uartStartReception(UARTInstance_t* pUART);
+static void uartTxStart(UARTInstance_t* pUART);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
-static UART_HandleTypeDef gUARTHandle;     //!< Global handle for UART 2
+static const UARTPortConfig_t gUARTConfig[UART_PORT_COUNT] =
+{
+    [UART_PORT_DEBUG] =
+    {
+        .pInstance      = LPUART1,
+        .uartIrq        = LPUART1_IRQn,
+        .pGpioPort      = USART_TX_GPIO_PORT,
+        .gpioPins       = USART_TX_PIN | USART_RX_PIN,
+        .gpioAlternate  = GPIO_AF12_LPUART1,
+        .pRxDmaChannel  = DMA1_Channel2,
+        .rxDmaRequest   = DMA_REQUEST_LPUART1_RX,
+        .rxDmaIrq       = DMA1_Channel2_IRQn,
+        .pTxDmaChannel  = DMA1_Channel3,
+        .txDmaRequest   = DMA_REQUEST_LPUART1_TX,
+        .txDmaIrq       = DMA1_Channel3_IRQn
+    },
+    [UART_PORT_SENSOR] =
+    {
+        .pInstance      = USART1,
+        .uartIrq        = USART1_IRQn,
+        .pGpioPort      = SENSOR_USART_TX_GPIO_PORT,
+        .gpioPins       = SENSOR_USART_TX_PIN | SENSOR_USART_RX_PIN,
+        .gpioAlternate  = GPIO_AF7_USART1,
+        .pRxDmaChannel  = DMA1_Channel4,
+        .rxDmaRequest   = DMA_REQUEST_USART1_RX,
+        .rxDmaIrq       = DMA1_Channel4_IRQn,
+        .pTxDmaChannel  = DMA1_Channel5,
+        .txDmaRequest   = DMA_REQUEST_USART1_TX,
+        .txDmaIrq       = DMA1_Channel5_IRQn
+    }
+};
+
+static UARTInstance_t gUART[UART_PORT_COUNT];      //!< State of the UART ports
 
 /***** PUBLIC FUNCTIONS ******************************************************/
 
 
-int32_t uartInitialize(uint32_t baudrate)
+int32_t uartInitialize(UARTPort_t port, uint32_t baudrate)
 {
     int32_t result = UART_ERR_OK;
+    uint32_t prescaler = UART_PRESCALER_DIV1;
 
     GPIO_InitTypeDef GPIO_InitStruct = { 0 };
-    RCC_PeriphCLKInitTypeDef PeriphClkInit = { 0 };
-
-    PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_LPUART1;
-    PeriphClkInit.Lpuart1ClockSelection = RCC_LPUART1CLKSOURCE_PCLK1;
 
-    if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
+    if (!UART_PORT_VALID(port))
     {
-        Error_Handler();
+        return UART_ERR_INVALID_PARAM;
     }
 
-    /* LPUART1 clock enable */
-    __HAL_RCC_LPUART1_CLK_ENABLE();
+    const UARTPortConfig_t* pConfig = &gUARTConfig[port];
+    UARTInstance_t* pUART = &gUART[port];
 
-    __HAL_RCC_GPIOA_CLK_ENABLE();
+    if (uartCalculatePrescaler(port, baudrate, &prescaler, &pUART->actualBaudrate, &pUART->baudrateErrorPpm) != UART_ERR_OK)
+    {
+        return UART_ERR_BAUDRATE;
+    }
 
-    /**LPUART1 GPIO Configuration
-     PA2     ------> LPUART1_TX
-     PA3     ------> LPUART1_RX
-     */
-    GPIO_InitStruct.Pin = USART_TX_PIN | USART_RX_PIN;
+    uartEnableClocks(port);
+
+    GPIO_InitStruct.Pin = pConfig->gpioPins;
     GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-    GPIO_InitStruct.Alternate = GPIO_AF12_LPUART1;
-    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    GPIO_InitStruct.Alternate = pConfig->gpioAlternate;
+    HAL_GPIO_Init(pConfig->pGpioPort, &GPIO_InitStruct);
+
+    pUART->handle.Instance = pConfig->pInstance;
+    pUART->handle.Init.BaudRate = baudrate;
+    pUART->handle.Init.WordLength = UART_WORDLENGTH_8B;
+    pUART->handle.Init.StopBits = UART_STOPBITS_1;
+    pUART->handle.Init.Parity = UART_PARITY_NONE;
+    pUART->handle.Init.Mode = UART_MODE_TX_RX;
+    pUART->handle.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    pUART->handle.Init.OverSampling = UART_OVERSAMPLING_16;
+    pUART->handle.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
+    pUART->handle.Init.ClockPrescaler = prescaler;
+    pUART->handle.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
+
+    if (HAL_UART_Init(&pUART->handle) != HAL_OK)
+    {
+        Error_Handler();
+    }
 
-    /**USART2 GPIO Configuration
-     PA2     ------> USART2_TX
-     PA3     ------> USART2_RX
+    /*
+     * The 8 byte FIFOs buffer the data between the shift registers and the
+     * DMA, so a delayed DMA request (e.g. while the ADC DMA owns the bus)
+     * does not lead to an overrun. The DMA is requested as long as the RX
+     * FIFO is not empty and the TX FIFO is not full, the thresholds only
+     * matter for interrupt driven transfers.
      */
-    gUARTHandle.Instance = LPUART1;
-    gUARTHandle.Init.BaudRate = 115200;
-    gUARTHandle.Init.WordLength = UART_WORDLENGTH_8B;
-    gUARTHandle.Init.StopBits = UART_STOPBITS_1;
-    gUARTHandle.Init.Parity = UART_PARITY_NONE;
-    gUARTHandle.Init.Mode = UART_MODE_TX_RX;
-    gUARTHandle.Init.HwFlowCtl = UART_HWCONTROL_NONE;
-    gUARTHandle.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
-    gUARTHandle.Init.ClockPrescaler = UART_PRESCALER_DIV1;
-    gUARTHandle.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
-
-    if (HAL_UART_Init(&gUARTHandle) != HAL_OK)
+    if (HAL_UARTEx_SetTxFifoThreshold(&pUART->handle, UART_TXFIFO_THRESHOLD_1_8) != HAL_OK)
     {
         Error_Handler();
     }
 
-    if (HAL_UARTEx_SetTxFifoThreshold(&gUARTHandle, UART_TXFIFO_THRESHOLD_1_8) != HAL_OK)
+    if (HAL_UARTEx_SetRxFifoThreshold(&pUART->handle, UART_RXFIFO_THRESHOLD_1_8) != HAL_OK)
     {
         Error_Handler();
     }
 
-    if (HAL_UARTEx_SetRxFifoThreshold(&gUARTHandle, UART_RXFIFO_THRESHOLD_1_8) != HAL_OK)
+    if (HAL_UARTEx_EnableFifoMode(&pUART->handle) != HAL_OK)
     {
         Error_Handler();
     }
 
-    if (HAL_UARTEx_DisableFifoMode(&gUARTHandle) != HAL_OK)
+    uartInitializeDMA(port);
+
+    /* UART interrupt is needed for the IDLE line detection and errors */
+    HAL_NVIC_SetPriority(pConfig->uartIrq, 1, 0);
+    HAL_NVIC_EnableIRQ(pConfig->uartIrq);
+
+    uartRxRingReset(&pUART->rxRing);
+    pUART->rxEnabled = 1;
+
+    uartTxRingReset(&pUART->txRing);
+    pUART->irqStats = (UARTIrqStats_t){ 0 };
+
+    if (uartStartReception(pUART) != UART_ERR_OK)
     {
-        Error_Handler();
+        result = UART_ERR_INIT_FAILURE;
     }
 
     return result;
 }
 
-int32_t uartSendData(uint8_t* pDataBuffer, int32_t bufferLength)
+int32_t uartGetBaudrate(UARTPort_t port, uint32_t* pActualBaudrate, int32_t* pErrorPpm)
 {
-    int32_t result = UART_ERR_OK;
+    if (!UART_PORT_VALID(port) || pActualBaudrate == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
 
-    HAL_StatusTypeDef halStatus = HAL_UART_Transmit(&gUARTHandle, pDataBuffer, bufferLength, HAL_MAX_DELAY);
+    *pActualBaudrate = gUART[port].actualBaudrate;
 
-    if (halStatus != HAL_OK )
+    if (pErrorPpm != 0)
     {
-        result = UART_ERR_TRANSMIT;
+        *pErrorPpm = gUART[port].baudrateErrorPpm;
     }
 
+    return UART_ERR_OK;
+}
+
+int32_t uartSendData(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    int32_t result;
+
+    if (!UART_PORT_VALID(port) || pDataBuffer == 0 || bufferLength < 0)
+    {
+        return UART_ERR_TRANSMIT;
+    }
+
+    UARTInstance_t* pUART = &gUART[port];
+    uint32_t length = (uint32_t)bufferLength;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    result = uartTxRingWrite(&pUART->txRing, pDataBuffer, length);
+
+    if (pUART->txRing.inFlight == 0)
+    {
+        uartTxStart(pUART);
+    }
+
+    __set_PRIMASK(primask);
+
     return result;
 }
 
-int32_t uartReceiveData(uint8_t* pDataBuffer, int32_t bufferLength)
+int32_t uartWriteDebug(uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    return uartSendData(UART_PORT_DEBUG, pDataBuffer, bufferLength);
+}
+
+int32_t uartSetTxPolicy(UARTPort_t port, UART_TxPolicy_t policy)
+{
+    if (!UART_PORT_VALID(port) ||
+        (policy != UART_TX_POLICY_DROP_NEW && policy != UART_TX_POLICY_OVERWRITE_OLDEST))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    gUART[port].txRing.policy = policy;
+
+    return UART_ERR_OK;
+}
+
+int32_t uartFlush(UARTPort_t port, uint32_t timeoutMs)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_TRANSMIT;
+    }
+
+    UARTInstance_t* pUART = &gUART[port];
+    uint32_t startTick = HAL_GetTick();
+
+    while (!uartTxRingIsIdle(&pUART->txRing) ||
+           __HAL_UART_GET_FLAG(&pUART->handle, UART_FLAG_TC) == RESET)
+    {
+        if ((HAL_GetTick() - startTick) >= timeoutMs)
+        {
+            return UART_ERR_TRANSMIT;
+        }
+    }
+
+    return UART_ERR_OK;
+}
+
+int32_t uartGetTxStats(UARTPort_t port, UARTTxStats_t* pStats)
+{
+    if (!UART_PORT_VALID(port) || pStats == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    *pStats = gUART[port].txRing.stats;
+
+    __set_PRIMASK(primask);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartGetIrqStats(UARTPort_t port, UARTIrqStats_t* pStats)
+{
+    if (!UART_PORT_VALID(port) || pStats == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    *pStats = gUART[port].irqStats;
+
+    __set_PRIMASK(primask);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartReceiveData(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    if (!UART_PORT_VALID(port) || pDataBuffer == 0 || bufferLength < 0 ||
+        (uint32_t)bufferLength > uartRxRingPending(&gUART[port].rxRing))
+    {
+        return UART_ERR_RECEIVE;
+    }
+
+    uartRxRingCopy(&gUART[port].rxRing, pDataBuffer, (uint32_t)bufferLength);
+    uartRxRingConsume(&gUART[port].rxRing, (uint32_t)bufferLength);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartHasData(UARTPort_t port, int8_t* pHasData)
+{
+	if (!UART_PORT_VALID(port) || pHasData == 0)
+	{
+		return UART_ERR_RECEIVE;
+	}
+
+	*pHasData = (uartRxRingPending(&gUART[port].rxRing) > 0) ? 1 : 0;
+
+	return UART_ERR_OK;
+}
+
+int32_t uartAvailable(UARTPort_t port)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    return (int32_t)uartRxRingPending(&gUART[port].rxRing);
+}
+
+int32_t uartRead(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    int32_t count = uartPeek(port, pDataBuffer, bufferLength);
+
+    if (count > 0)
+    {
+        uartRxRingConsume(&gUART[port].rxRing, (uint32_t)count);
+    }
+
+    return count;
+}
+
+int32_t uartPeek(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    if (!UART_PORT_VALID(port) || pDataBuffer == 0 || bufferLength < 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    uint32_t count = uartRxRingPending(&gUART[port].rxRing);
+
+    if (count > (uint32_t)bufferLength)
+    {
+        count = (uint32_t)bufferLength;
+    }
+
+    uartRxRingCopy(&gUART[port].rxRing, pDataBuffer, count);
+
+    return (int32_t)count;
+}
+
+uint32_t uartGetRxOverflowCount(UARTPort_t port)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return 0;
+    }
+
+    return gUART[port].rxRing.overflowCount;
+}
+
+int32_t uartSetRxCallback(UARTPort_t port, UARTRxCallback pCallback)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    gUART[port].rxCallback = pCallback;
+
+    return UART_ERR_OK;
+}
+
+int32_t uartStopReception(UARTPort_t port)
 {
     int32_t result = UART_ERR_OK;
 
-    HAL_StatusTypeDef halStatus = HAL_UART_Receive(&gUARTHandle, pDataBuffer, bufferLength, HAL_MAX_DELAY);
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_RECEIVE;
+    }
+
+    gUART[port].rxEnabled = 0;
+
+    /* The UART interrupt stays enabled, it is still needed for the transmission */
+    HAL_NVIC_DisableIRQ(gUARTConfig[port].rxDmaIrq);
 
-    if (halStatus != HAL_OK )
+    if (HAL_UART_AbortReceive(&gUART[port].handle) != HAL_OK)
     {
         result = UART_ERR_RECEIVE;
     }
@@ -136,20 +453,427 @@ int32_t uartReceiveData(uint8_t* pDataBuffer, int32_t bufferLength)
     return result;
 }
 
-int32_t uartHasData(int8_t* pHasData)
+/**
+ * @brief Reception event callback (IDLE line, DMA half transfer and transfer complete)
+ *
+ * Publishes the new DMA write position as head of the RX ring buffer.
+ *
+ * @param huart     Handle of the UART which received data
+ * @param Size      Current DMA position within the RX buffer
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_UART_IRQHandler()
+ * and the DMA callbacks
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 {
-	int32_t result = UART_ERR_OK;
+    UARTInstance_t* pUART = uartFindInstance(huart);
 
-	if (__HAL_UART_GET_FLAG(&gUARTHandle, UART_FLAG_RXNE)==SET)
-	{
-		*pHasData = 1;
-	}
-	else
-	{
-		*pHasData = 0;
-	}
+    if (pUART == 0)
+    {
+        return;
+    }
+
+    /* At most half a buffer lies between two events, so the delta is unambiguous */
+    uint32_t position = (uint32_t)Size & UART_RX_BUFFER_MASK;
+    uint32_t received = (position - pUART->rxDmaPosition) & UART_RX_BUFFER_MASK;
+
+    pUART->rxRing.head += received;
+    pUART->rxDmaPosition = position;
+
+    pUART->irqStats.rxEventCount++;
+    pUART->irqStats.rxBytes += received;
+
+    UARTRxCallback pCallback = pUART->rxCallback;
+    if (received != 0 && pCallback != 0)
+    {
+        pCallback((UARTPort_t)(pUART - gUART));
+    }
+}
+
+/**
+ * @brief Transmission complete callback
+ *
+ * Releases the transmitted bytes and chains the next DMA transfer.
+ *
+ * @param huart     Handle of the UART which completed the transmission
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_UART_IRQHandler()
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    UARTInstance_t* pUART = uartFindInstance(huart);
+
+    if (pUART == 0)
+    {
+        return;
+    }
+
+    uartTxRingComplete(&pUART->txRing, pUART->txRing.inFlight);
+    uartTxStart(pUART);
+}
+
+/**
+ * @brief UART error callback
+ *
+ * In DMA mode the HAL aborts the reception on every receive error (overrun,
+ * framing, noise), so the reception is restarted here. A failed DMA
+ * transmission drops the running transfer and continues with the next one.
+ *
+ * @param huart     Handle of the UART with the error
+ *
+ * @remark: this callback is called by the STM32 HAL library from HAL_UART_IRQHandler()
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    UARTInstance_t* pUART = uartFindInstance(huart);
+
+    if (pUART == 0)
+    {
+        return;
+    }
+
+    pUART->irqStats.errorCount++;
+
+    if (huart->gState == HAL_UART_STATE_READY && pUART->txRing.inFlight != 0)
+    {
+        uartTxRingComplete(&pUART->txRing, 0);
+        uartTxStart(pUART);
+    }
+
+    if (huart->RxState == HAL_UART_STATE_READY && pUART->rxEnabled)
+    {
+        uartStartReception(pUART);
+    }
+}
+
+/**
+ * @brief Interrupt handler for the debug UART RX DMA channel
+ *
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+    gUART[UART_PORT_DEBUG].irqStats.rxDmaIrqCount++;
+    HAL_DMA_IRQHandler(&gUART[UART_PORT_DEBUG].rxDmaHandle);
+}
+
+/**
+ * @brief Interrupt handler for the debug UART TX DMA channel
+ *
+ */
+void DMA1_Channel3_IRQHandler(void)
+{
+    gUART[UART_PORT_DEBUG].irqStats.txDmaIrqCount++;
+    HAL_DMA_IRQHandler(&gUART[UART_PORT_DEBUG].txDmaHandle);
+}
+
+/**
+ * @brief Interrupt handler for LPUART1 (debug UART)
+ *
+ */
+void LPUART1_IRQHandler(void)
+{
+    gUART[UART_PORT_DEBUG].irqStats.uartIrqCount++;
+    HAL_UART_IRQHandler(&gUART[UART_PORT_DEBUG].handle);
+}
+
+/**
+ * @brief Interrupt handler for the sensor UART RX DMA channel
+ *
+ */
+void DMA1_Channel4_IRQHandler(void)
+{
+    gUART[UART_PORT_SENSOR].irqStats.rxDmaIrqCount++;
+    HAL_DMA_IRQHandler(&gUART[UART_PORT_SENSOR].rxDmaHandle);
+}
 
-	return result;
+/**
+ * @brief Interrupt handler for the sensor UART TX DMA channel
+ *
+ */
+void DMA1_Channel5_IRQHandler(void)
+{
+    gUART[UART_PORT_SENSOR].irqStats.txDmaIrqCount++;
+    HAL_DMA_IRQHandler(&gUART[UART_PORT_SENSOR].txDmaHandle);
+}
+
+/**
+ * @brief Interrupt handler for USART1 (sensor UART)
+ *
+ */
+void USART1_IRQHandler(void)
+{
+    gUART[UART_PORT_SENSOR].irqStats.uartIrqCount++;
+    HAL_UART_IRQHandler(&gUART[UART_PORT_SENSOR].handle);
 }
 
 /***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Selects the kernel clock of the UART and enables the clocks of
+ * the UART and its GPIO port
+ *
+ * @param port          UART port
+ */
+static void uartEnableClocks(UARTPort_t port)
+{
+    RCC_PeriphCLKInitTypeDef PeriphClkInit = { 0 };
+
+    if (port == UART_PORT_DEBUG)
+    {
+        PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_LPUART1;
+        PeriphClkInit.Lpuart1ClockSelection = RCC_LPUART1CLKSOURCE_PCLK1;
+    }
+    else
+    {
+        PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_USART1;
+        PeriphClkInit.Usart1ClockSelection = RCC_USART1CLKSOURCE_PCLK2;
+    }
+
+    if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    if (port == UART_PORT_DEBUG)
+    {
+        /**LPUART1 GPIO Configuration
+         PA2     ------> LPUART1_TX
+         PA3     ------> LPUART1_RX
+         */
+        __HAL_RCC_LPUART1_CLK_ENABLE();
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+    }
+    else
+    {
+        /**USART1 GPIO Configuration
+         PC4     ------> USART1_TX
+         PC5     ------> USART1_RX
+         */
+        __HAL_RCC_USART1_CLK_ENABLE();
+        __HAL_RCC_GPIOC_CLK_ENABLE();
+    }
+}
+
+/**
+ * @brief Returns the kernel clock of a UART (see uartEnableClocks())
+ *
+ * @param port          UART port
+ *
+ * @return Kernel clock in Hz
+ */
+static uint32_t uartGetKernelClock(UARTPort_t port)
+{
+    return (port == UART_PORT_DEBUG) ? HAL_RCC_GetPCLK1Freq() : HAL_RCC_GetPCLK2Freq();
+}
+
+/**
+ * @brief Selects the kernel clock prescaler for a baudrate
+ *
+ * The smallest prescaler with a valid BRR value gives the finest baudrate
+ * resolution. The LPUART requires a kernel clock between 3 and 4096 times
+ * the baudrate, the USART (16 times oversampling) a BRR of at least 16.
+ *
+ * @param port              UART port
+ * @param baudrate          Requested baudrate
+ * @param pPrescaler        Pointer to store the prescaler (UART_PRESCALER_DIVx) to
+ * @param pActualBaudrate   Pointer to store the actual baudrate to
+ * @param pErrorPpm         Pointer to store the baudrate deviation in ppm to
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_BAUDRATE
+ */
+static int32_t uartCalculatePrescaler(UARTPort_t port, uint32_t baudrate, uint32_t* pPrescaler, uint32_t* pActualBaudrate, int32_t* pErrorPpm)
+{
+    uint32_t clock = uartGetKernelClock(port);
+    bool lowPower = IS_LPUART_INSTANCE(gUARTConfig[port].pInstance);
+
+    if (baudrate == 0)
+    {
+        return UART_ERR_BAUDRATE;
+    }
+
+    for (uint32_t prescaler = 0; prescaler < UART_PRESCALER_COUNT; prescaler++)
+    {
+        uint64_t kernelClock = clock / UARTPrescTable[prescaler];
+        uint32_t brr;
+        uint32_t actual;
+
+        if (lowPower)
+        {
+            if (kernelClock < 3ULL * baudrate)
+            {
+                /* Larger prescalers only get slower */
+                break;
+            }
+
+            if (kernelClock > 4096ULL * baudrate)
+            {
+                continue;
+            }
+
+            brr = UART_DIV_LPUART(clock, baudrate, prescaler);
+
+            if (brr < UART_LPUART_BRR_MIN || brr > UART_LPUART_BRR_MAX)
+            {
+                continue;
+            }
+
+            actual = (uint32_t)((kernelClock * 256U + brr / 2U) / brr);
+        }
+        else
+        {
+            brr = UART_DIV_SAMPLING16(clock, baudrate, prescaler);
+
+            if (brr < UART_USART_BRR_MIN)
+            {
+                break;
+            }
+
+            if (brr > UART_USART_BRR_MAX)
+            {
+                continue;
+            }
+
+            actual = (uint32_t)((kernelClock + brr / 2U) / brr);
+        }
+
+        int32_t errorPpm = (int32_t)((((int64_t)actual - (int64_t)baudrate) * 1000000LL) / baudrate);
+
+        if (errorPpm > UART_MAX_BAUDRATE_ERROR_PPM || errorPpm < -UART_MAX_BAUDRATE_ERROR_PPM)
+        {
+            continue;
+        }
+
+        *pPrescaler = prescaler;
+        *pActualBaudrate = actual;
+        *pErrorPpm = errorPpm;
+
+        return UART_ERR_OK;
+    }
+
+    return UART_ERR_BAUDRATE;
+}
+
+/**
+ * @brief Initializes the DMA channels used for the reception and
+ * transmission of a UART port
+ *
+ * @param port          UART port
+ */
+static void uartInitializeDMA(UARTPort_t port)
+{
+    const UARTPortConfig_t* pConfig = &gUARTConfig[port];
+    UARTInstance_t* pUART = &gUART[port];
+
+    /* DMA controller clock enable */
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    pUART->rxDmaHandle.Instance                 = pConfig->pRxDmaChannel;
+    pUART->rxDmaHandle.Init.Request             = pConfig->rxDmaRequest;
+    pUART->rxDmaHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    pUART->rxDmaHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    pUART->rxDmaHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    pUART->rxDmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    pUART->rxDmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    pUART->rxDmaHandle.Init.Mode                = DMA_CIRCULAR;
+    pUART->rxDmaHandle.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+    if (HAL_DMA_Init(&pUART->rxDmaHandle) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    __HAL_LINKDMA(&pUART->handle, hdmarx, pUART->rxDmaHandle);
+
+    pUART->txDmaHandle.Instance                 = pConfig->pTxDmaChannel;
+    pUART->txDmaHandle.Init.Request             = pConfig->txDmaRequest;
+    pUART->txDmaHandle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    pUART->txDmaHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    pUART->txDmaHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    pUART->txDmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    pUART->txDmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    pUART->txDmaHandle.Init.Mode                = DMA_NORMAL;
+    pUART->txDmaHandle.Init.Priority            = DMA_PRIORITY_LOW;
+
+    if (HAL_DMA_Init(&pUART->txDmaHandle) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    __HAL_LINKDMA(&pUART->handle, hdmatx, pUART->txDmaHandle);
+
+    HAL_NVIC_SetPriority(pConfig->rxDmaIrq, 1, 0);
+    HAL_NVIC_EnableIRQ(pConfig->rxDmaIrq);
+
+    HAL_NVIC_SetPriority(pConfig->txDmaIrq, 1, 0);
+    HAL_NVIC_EnableIRQ(pConfig->txDmaIrq);
+}
+
+/**
+ * @brief Returns the port instance of a HAL handle
+ *
+ * @param huart         HAL handle passed to a HAL callback
+ *
+ * @return Port instance, 0 if the handle belongs to no port
+ */
+static UARTInstance_t* uartFindInstance(UART_HandleTypeDef* huart)
+{
+    for (uint32_t port = 0; port < UART_PORT_COUNT; port++)
+    {
+        if (huart == &gUART[port].handle)
+        {
+            return &gUART[port];
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief (Re-)starts the circular DMA reception into the RX ring buffer
+ *
+ * The DMA always starts at the beginning of the buffer. Data still pending
+ * from a previous (aborted) reception is discarded by the reader.
+ *
+ * @param pUART         Port instance
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_RECEIVE
+ */
+static int32_t uartStartReception(UARTInstance_t* pUART)
+{
+    uartRxRingRestart(&pUART->rxRing);
+    pUART->rxDmaPosition = 0;
+
+    if (HAL_UARTEx_ReceiveToIdle_DMA(&pUART->handle, pUART->rxRing.buffer, UART_RX_BUFFER_SIZE) != HAL_OK)
+    {
+        return UART_ERR_RECEIVE;
+    }
+
+    return UART_ERR_OK;
+}
+
+/**
+ * @brief Starts a DMA transfer of the waiting bytes of the TX ring buffer
+ *
+ * A transfer ends at the end of the buffer, the remaining bytes follow
+ * with the next transfer from HAL_UART_TxCpltCallback().
+ *
+ * @param pUART         Port instance
+ *
+ * @remark: must be called with interrupts disabled or from the UART interrupt
+ */
+static void uartTxStart(UARTInstance_t* pUART)
+{
+    uint32_t index = 0;
+    uint32_t length = uartTxRingNext(&pUART->txRing, UART_TX_BUFFER_SIZE, &index);
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    if (HAL_UART_Transmit_DMA(&pUART->handle, &pUART->txRing.buffer[index], (uint16_t)length) == HAL_OK)
+    {
+        uartTxRingStart(&pUART->txRing, length);
+    }
+}
@@ -10,6 +10,12 @@
  *
  * @brief Header File for UART module
  *
+ * The module drives several UART ports with their own peripheral, DMA
+ * channels and ring buffers, so the traffic of one port (e.g. a burst of
+ * log output) does not delay the data of another port.
+ *
+ *   UART_PORT_DEBUG    LPUART1 PA2/PA3, DMA1 channel 2 (RX) / 3 (TX)
+ *   UART_PORT_SENSOR   USART1  PC4/PC5, DMA1 channel 4 (RX) / 5 (TX)
  *
  *****************************************************************************/
 #ifndef _UART_MODULE_H_
@@ -19,6 +25,9 @@
 #include <stdint.h>
 
 /***** CONSTANTS *************************************************************/
+#define UART_RX_BUFFER_SIZE          256        //!< Size of the RX ring buffer in bytes (must be a power of two)
+#define UART_TX_BUFFER_SIZE          1024       //!< Size of the TX ring buffer in bytes (must be a power of two)
+#define UART_MAX_BAUDRATE_ERROR_PPM  20000      //!< Maximum accepted deviation of the actual baudrate (2 %)
 
 
 /***** MACROS ****************************************************************/
@@ -26,55 +35,275 @@
 #define UART_ERR_INIT_FAILURE        -1         //!< Error during UART initialization
 #define UART_ERR_TRANSMIT            -2         //!< Error during UART tranmission
 #define UART_ERR_RECEIVE             -3         //!< Error during UART receive
+#define UART_ERR_INVALID_PARAM       -4         //!< Invalid parameter passed to a function
+#define UART_ERR_BAUDRATE            -5         //!< Baudrate can't be generated within UART_MAX_BAUDRATE_ERROR_PPM
 
 
 /***** TYPES *****************************************************************/
 
+/**
+ * @brief UART ports of the board
+ *
+ */
+typedef enum _UARTPort_
+{
+    UART_PORT_DEBUG = 0,                //!< LPUART1: debug output, frame multiplexer and authenticator
+    UART_PORT_SENSOR,                   //!< USART1: water sensor line
+    UART_PORT_COUNT                     //!< Number of UART ports
+} UARTPort_t;
+
+/**
+ * @brief Behaviour of uartSendData() if the TX ring buffer is full
+ *
+ */
+typedef enum _UART_TxPolicy_
+{
+    UART_TX_POLICY_DROP_NEW,            //!< The new data is dropped completely, queued data is kept
+    UART_TX_POLICY_OVERWRITE_OLDEST     //!< The oldest queued (not yet transmitting) data is discarded
+} UART_TxPolicy_t;
+
+/**
+ * @brief Statistics of the TX ring buffer
+ *
+ */
+typedef struct _UARTTxStats_
+{
+    uint32_t bytesQueued;               //!< Number of bytes accepted into the TX ring buffer
+    uint32_t bytesDropped;              //!< Number of bytes dropped because the TX ring buffer was full
+    uint32_t peakFill;                  //!< Maximum fill level of the TX ring buffer in bytes
+} UARTTxStats_t;
+
+/**
+ * @brief Interrupt counters of the UART driver, used to measure the
+ * interrupt load (e.g. interrupts per received byte)
+ *
+ */
+typedef struct _UARTIrqStats_
+{
+    uint32_t uartIrqCount;              //!< Number of UART interrupts (IDLE line, TX complete, errors)
+    uint32_t rxDmaIrqCount;             //!< Number of RX DMA interrupts (half transfer, transfer complete)
+    uint32_t txDmaIrqCount;             //!< Number of TX DMA interrupts
+    uint32_t rxEventCount;              //!< Number of RX events publishing new data
+    uint32_t rxBytes;                   //!< Number of bytes received
+    uint32_t errorCount;                //!< Number of UART errors (overrun, framing, noise, DMA)
+} UARTIrqStats_t;
+
+/**
+ * @brief Callback which is called when new received data has been published
+ * to the RX ring buffer
+ *
+ * Called in interrupt context (RX event of the UART), the callback may read
+ * the new data with uartRead().
+ *
+ * @param port      Port which received the data
+ */
+typedef void (*UARTRxCallback)(UARTPort_t port);
+
 
 /***** PROTOTYPES ************************************************************/
 
 
 /**
- * @brief Initializes the UART2 peripheral to the specified baudrate
+ * @brief Initializes a UART port to the specified baudrate
  *
  * Additionally, the communication parameter are set to 8 data bit,
  * 1 stop bit and none parity
  *
+ * The kernel clock prescaler is chosen so that the baudrate is generated
+ * with the finest resolution. With the 128 MHz PCLK1/PCLK2 the LPUART
+ * reaches up to 42 Mbaud, the USART (16 times oversampling) up to 8 Mbaud.
+ *
+ * @param port     Port to initialize
  * @param baudrate Baudrate to setup the UART to
  *
- * @return Returns UART_ERR_OK if no error occured
+ * @return Returns UART_ERR_OK if no error occured, UART_ERR_BAUDRATE if the
+ * baudrate deviates more than UART_MAX_BAUDRATE_ERROR_PPM
+ */
+int32_t uartInitialize(UARTPort_t port, uint32_t baudrate);
+
+/**
+ * @brief Returns the baudrate which is actually generated
+ *
+ * @param port      UART port
+ * @param pActualBaudrate   Pointer to store the actual baudrate to
+ * @param pErrorPpm         Optional pointer to store the deviation from the
+ *                          requested baudrate to (in ppm), may be 0
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
  */
-int32_t uartInitialize(uint32_t baudrate);
+int32_t uartGetBaudrate(UARTPort_t port, uint32_t* pActualBaudrate, int32_t* pErrorPpm);
 
 /**
  * @brief Sends data to the UART interface
  *
+ * The data is copied into the TX ring buffer and the function returns
+ * immediately. The ring buffer is drained by the DMA in the background.
+ * If the ring buffer is full, the configured TX policy applies.
+ *
+ * @param port      UART port
+ * @param pDataBuffer Pointer to the data buffer which should be send out
+ * @param bufferLength Length of the buffer (number of bytes) to send
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_TRANSMIT
+ * (also if data had to be dropped)
+ */
+int32_t uartSendData(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength);
+
+/**
+ * @brief Sends data to the debug port (see uartSendData())
+ *
+ * Has the signature of the log and ADC dump writers.
+ *
  * @param pDataBuffer Pointer to the data buffer which should be send out
  * @param bufferLength Length of the buffer (number of bytes) to send
  *
  * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_TRANSMIT
  */
-int32_t uartSendData(uint8_t* pDataBuffer, int32_t bufferLength);
+int32_t uartWriteDebug(uint8_t* pDataBuffer, int32_t bufferLength);
+
+/**
+ * @brief Sets the behaviour of uartSendData() if the TX ring buffer is full
+ *
+ * @param port      UART port
+ * @param policy    TX policy (default is UART_TX_POLICY_DROP_NEW)
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartSetTxPolicy(UARTPort_t port, UART_TxPolicy_t policy);
+
+/**
+ * @brief Waits until all queued data has been transmitted
+ *
+ * Must not be called with interrupts disabled.
+ *
+ * @param port      UART port
+ * @param timeoutMs Maximum time to wait in ms
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_TRANSMIT
+ */
+int32_t uartFlush(UARTPort_t port, uint32_t timeoutMs);
+
+/**
+ * @brief Returns the statistics of the TX ring buffer
+ *
+ * @param port      UART port
+ * @param pStats    Pointer to store the statistics to
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartGetTxStats(UARTPort_t port, UARTTxStats_t* pStats);
+
+/**
+ * @brief Returns the interrupt counters of the UART driver
+ *
+ * @param port      UART port
+ * @param pStats    Pointer to store the counters to
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartGetIrqStats(UARTPort_t port, UARTIrqStats_t* pStats);
 
 /**
  * @brief Receives data from the UART interface
  *
+ * The function does not block. The bytes are taken from the RX ring buffer
+ * only if all bufferLength bytes are available, otherwise nothing is consumed.
+ *
+ * @param port      UART port
  * @param pDataBuffer Pointer to the data buffer which is used to store the recevied bytes
  * @param bufferLength Length of the buffer (number of bytes)
  *
  * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_RECEIVE
  */
-int32_t uartReceiveData(uint8_t* pDataBuffer, int32_t bufferLength);
+int32_t uartReceiveData(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength);
 
 /**
  * @brief Checks for available data in the UART RX buffer
  *
+ * @param port      UART port
  * @param pHasData	Pointer to store flag whether data is available.
  * 					0 = no data available
  * 					1 = data available
  *
  * 	@return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_RECEIVE
  */
-int32_t uartHasData(int8_t* pHasData);
+int32_t uartHasData(UARTPort_t port, int8_t* pHasData);
+
+/**
+ * @brief Returns the number of received bytes waiting in the RX ring buffer
+ *
+ * The DMA write position is published on IDLE line, half transfer and
+ * transfer complete events, so bytes of a burst which is still ongoing
+ * become visible at the latest after half a buffer or the next idle line.
+ *
+ * @param port      UART port
+ *
+ * @return Number of bytes which can be read without blocking, or
+ * UART_ERR_INVALID_PARAM
+ */
+int32_t uartAvailable(UARTPort_t port);
+
+/**
+ * @brief Reads up to bufferLength received bytes from the RX ring buffer
+ *
+ * @param port      UART port
+ * @param pDataBuffer Pointer to the buffer to store the bytes to
+ * @param bufferLength Maximum number of bytes to read
+ *
+ * @return Number of bytes read (0 if no data is available), or
+ * UART_ERR_INVALID_PARAM
+ */
+int32_t uartRead(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength);
+
+/**
+ * @brief Copies up to bufferLength received bytes from the RX ring buffer
+ * without consuming them
+ *
+ * @param port      UART port
+ * @param pDataBuffer Pointer to the buffer to store the bytes to
+ * @param bufferLength Maximum number of bytes to copy
+ *
+ * @return Number of bytes copied (0 if no data is available), or
+ * UART_ERR_INVALID_PARAM
+ */
+int32_t uartPeek(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength);
+
+/**
+ * @brief Returns how often unread data in the RX ring buffer has been
+ * overwritten by the DMA or discarded after a receive error
+ *
+ * @param port      UART port
+ *
+ * @return Number of RX overflows since initialization
+ */
+uint32_t uartGetRxOverflowCount(UARTPort_t port);
+
+/**
+ * @brief Registers a callback for new received data
+ *
+ * Allows to process (and time stamp) received data right after its
+ * reception instead of polling the RX ring buffer.
+ *
+ * @param port      UART port
+ * @param pCallback     Callback function, 0 removes the callback
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartSetRxCallback(UARTPort_t port, UARTRxCallback pCallback);
+
+/**
+ * @brief Stops the background reception (DMA and interrupts)
+ *
+ * Has to be called before the control is handed over to another image
+ * (e.g. the Authenticator starting the Application), so that the DMA does
+ * not keep writing into RAM owned by the new image. Transmission with
+ * uartSendData() is still possible afterwards, call uartFlush() before the
+ * hand over so that no TX transfer is running anymore.
+ *
+ * @param port      UART port
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_RECEIVE
+ */
+int32_t uartStopReception(UARTPort_t port);
 
 #endif
@@ -0,0 +1,202 @@
+/******************************************************************************
+ * @file UARTRing.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the RX and TX ring buffers of the UART module
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "UARTRing.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+void uartRxRingReset(UARTRxRing_t* pRing)
+{
+    pRing->head = 0;
+    pRing->tail = 0;
+    pRing->resync = 0;
+    pRing->overflowCount = 0;
+}
+
+void uartRxRingRestart(UARTRxRing_t* pRing)
+{
+    pRing->head = (pRing->head + UART_RX_BUFFER_MASK) & ~(uint32_t)UART_RX_BUFFER_MASK;
+    pRing->resync = 1;
+}
+
+uint32_t uartRxRingPending(UARTRxRing_t* pRing)
+{
+    if (pRing->resync != 0)
+    {
+        pRing->resync = 0;
+
+        if (pRing->tail != pRing->head)
+        {
+            pRing->overflowCount++;
+        }
+
+        pRing->tail = pRing->head;
+    }
+
+    uint32_t pending = pRing->head - pRing->tail;
+
+    if (pending > UART_RX_BUFFER_SIZE)
+    {
+        pRing->overflowCount++;
+        pRing->tail += pending;
+        pending = 0;
+    }
+
+    return pending;
+}
+
+void uartRxRingCopy(const UARTRxRing_t* pRing, uint8_t* pDataBuffer, uint32_t count)
+{
+    uint32_t index = pRing->tail & UART_RX_BUFFER_MASK;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pDataBuffer[i] = pRing->buffer[index];
+        index = (index + 1) & UART_RX_BUFFER_MASK;
+    }
+}
+
+void uartRxRingConsume(UARTRxRing_t* pRing, uint32_t count)
+{
+    pRing->tail += count;
+}
+
+void uartTxRingReset(UARTTxRing_t* pRing)
+{
+    pRing->head = 0;
+    pRing->tail = 0;
+    pRing->inFlight = 0;
+    pRing->stats = (UARTTxStats_t){ 0 };
+}
+
+int32_t uartTxRingWrite(UARTTxRing_t* pRing, const uint8_t* pDataBuffer, uint32_t length)
+{
+    int32_t result = UART_ERR_OK;
+
+    uint32_t used = pRing->head - pRing->tail + pRing->inFlight;
+    uint32_t free = UART_TX_BUFFER_SIZE - used;
+
+    if (length > free)
+    {
+        result = UART_ERR_TRANSMIT;
+
+        if (pRing->policy == UART_TX_POLICY_DROP_NEW)
+        {
+            pRing->stats.bytesDropped += length;
+            length = 0;
+        }
+        else
+        {
+            /* Only the part of the new data which fits next to the running transfer is kept */
+            uint32_t capacity = UART_TX_BUFFER_SIZE - pRing->inFlight;
+            if (length > capacity)
+            {
+                pRing->stats.bytesDropped += length - capacity;
+                pDataBuffer += length - capacity;
+                length = capacity;
+            }
+
+            /* Discard the oldest waiting bytes */
+            uint32_t discard = length - free;
+            if (discard > pRing->head - pRing->tail)
+            {
+                discard = pRing->head - pRing->tail;
+            }
+
+            pRing->tail += discard;
+            pRing->stats.bytesDropped += discard;
+        }
+    }
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        pRing->buffer[(pRing->head + i) & UART_TX_BUFFER_MASK] = pDataBuffer[i];
+    }
+
+    pRing->head += length;
+    pRing->stats.bytesQueued += length;
+
+    used = pRing->head - pRing->tail + pRing->inFlight;
+    if (used > pRing->stats.peakFill)
+    {
+        pRing->stats.peakFill = used;
+    }
+
+    return result;
+}
+
+uint32_t uartTxRingNext(const UARTTxRing_t* pRing, uint32_t maxLength, uint32_t* pIndex)
+{
+    uint32_t waiting = pRing->head - pRing->tail;
+
+    if (waiting == 0 || pRing->inFlight != 0)
+    {
+        return 0;
+    }
+
+    uint32_t index = pRing->tail & UART_TX_BUFFER_MASK;
+    uint32_t length = UART_TX_BUFFER_SIZE - index;
+
+    if (length > waiting)
+    {
+        length = waiting;
+    }
+
+    if (length > maxLength)
+    {
+        length = maxLength;
+    }
+
+    *pIndex = index;
+
+    return length;
+}
+
+void uartTxRingStart(UARTTxRing_t* pRing, uint32_t length)
+{
+    pRing->tail += length;
+    pRing->inFlight = length;
+}
+
+void uartTxRingComplete(UARTTxRing_t* pRing, uint32_t sent)
+{
+    if (sent < pRing->inFlight)
+    {
+        pRing->stats.bytesDropped += pRing->inFlight - sent;
+    }
+
+    pRing->inFlight = 0;
+}
+
+bool uartTxRingIsIdle(const UARTTxRing_t* pRing)
+{
+    return pRing->head == pRing->tail && pRing->inFlight == 0;
+}
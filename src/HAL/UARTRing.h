@@ -0,0 +1,196 @@
+/******************************************************************************
+ * @file UARTRing.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the RX and TX ring buffers of the UART module
+ *
+ * The ring buffers do not use the STM32 HAL, so the same code is built for
+ * the target (src/HAL/UARTModule.c) and the host implementation of the UART
+ * module (tools/host/UARTModuleHost.c).
+ *
+ * Head and tail are free running byte counts, the ring buffer index is
+ * derived by masking. None of the functions locks, the caller serializes
+ * the access (interrupts disabled on the target, the TX lock on the host).
+ *
+ *****************************************************************************/
+#ifndef _UART_RING_H_
+#define _UART_RING_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "UARTModule.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define UART_RX_BUFFER_MASK         (UART_RX_BUFFER_SIZE - 1)       //!< Mask to map a byte count to a ring buffer index
+
+#if (UART_RX_BUFFER_SIZE & UART_RX_BUFFER_MASK) != 0
+#error "UART_RX_BUFFER_SIZE must be a power of two"
+#endif
+
+#define UART_TX_BUFFER_MASK         (UART_TX_BUFFER_SIZE - 1)       //!< Mask to map a byte count to a ring buffer index
+
+#if (UART_TX_BUFFER_SIZE & UART_TX_BUFFER_MASK) != 0
+#error "UART_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief RX ring buffer
+ *
+ * The head is only advanced by the writer (DMA event, receive thread), the
+ * tail only by the reader.
+ */
+typedef struct _UARTRxRing_
+{
+    uint8_t buffer[UART_RX_BUFFER_SIZE];    //!< Ring buffer, written by the DMA in circular mode
+    volatile uint32_t head;                 //!< Number of bytes received (published per RX event)
+    volatile uint32_t tail;                 //!< Number of bytes consumed by the reader
+    volatile uint8_t resync;                //!< Set when the reception was restarted and pending data is invalid
+    uint32_t overflowCount;                 //!< Number of detected RX overflows
+} UARTRxRing_t;
+
+/**
+ * @brief TX ring buffer
+ *
+ * The bytes [tail - inFlight, tail) are currently transmitted, the bytes
+ * [tail, head) are waiting.
+ */
+typedef struct _UARTTxRing_
+{
+    uint8_t buffer[UART_TX_BUFFER_SIZE];    //!< Ring buffer, drained by the DMA
+    volatile uint32_t head;                 //!< Number of bytes written into the ring buffer
+    volatile uint32_t tail;                 //!< Number of bytes handed over to the transmission
+    volatile uint32_t inFlight;             //!< Length of the running transmission
+    UART_TxPolicy_t policy;                 //!< Behaviour if the ring buffer is full
+    UARTTxStats_t stats;                    //!< Statistics of the ring buffer
+} UARTTxRing_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Resets the RX ring buffer (no pending data, counters cleared)
+ *
+ * @param pRing         RX ring buffer
+ */
+void uartRxRingReset(UARTRxRing_t* pRing);
+
+/**
+ * @brief Marks the pending data as invalid after a restart of the reception
+ *
+ * The head is aligned to the buffer start where the DMA continues, the
+ * reader discards the data still pending (see uartRxRingPending()).
+ *
+ * @param pRing         RX ring buffer
+ */
+void uartRxRingRestart(UARTRxRing_t* pRing);
+
+/**
+ * @brief Returns the number of valid bytes in the RX ring buffer
+ *
+ * Discards the pending data if the writer has overwritten unread data or
+ * the reception was restarted, both are counted as an overflow.
+ *
+ * @param pRing         RX ring buffer
+ *
+ * @return Number of bytes which can be read
+ */
+uint32_t uartRxRingPending(UARTRxRing_t* pRing);
+
+/**
+ * @brief Copies bytes from the tail of the RX ring buffer without consuming them
+ *
+ * @param pRing         RX ring buffer
+ * @param pDataBuffer   Destination buffer
+ * @param count         Number of bytes to copy, must not exceed the pending bytes
+ */
+void uartRxRingCopy(const UARTRxRing_t* pRing, uint8_t* pDataBuffer, uint32_t count);
+
+/**
+ * @brief Consumes bytes at the tail of the RX ring buffer
+ *
+ * @param pRing         RX ring buffer
+ * @param count         Number of bytes to consume, must not exceed the pending bytes
+ */
+void uartRxRingConsume(UARTRxRing_t* pRing, uint32_t count);
+
+/**
+ * @brief Resets the TX ring buffer (empty, statistics cleared)
+ *
+ * The TX policy is kept.
+ *
+ * @param pRing         TX ring buffer
+ */
+void uartTxRingReset(UARTTxRing_t* pRing);
+
+/**
+ * @brief Writes bytes into the TX ring buffer
+ *
+ * If the bytes don't fit, the policy of the ring buffer decides: with
+ * UART_TX_POLICY_DROP_NEW all new bytes are dropped, with
+ * UART_TX_POLICY_OVERWRITE_OLDEST the oldest waiting bytes are discarded
+ * (and only the last part of the new data is kept if it does not even fit
+ * next to the running transmission).
+ *
+ * @param pRing         TX ring buffer
+ * @param pDataBuffer   Bytes to write
+ * @param length        Number of bytes
+ *
+ * @return UART_ERR_OK if all bytes were written without dropping anything,
+ * otherwise UART_ERR_TRANSMIT
+ */
+int32_t uartTxRingWrite(UARTTxRing_t* pRing, const uint8_t* pDataBuffer, uint32_t length);
+
+/**
+ * @brief Returns the next block of waiting bytes for a transmission
+ *
+ * The block is contiguous in the buffer, so it ends at the latest at the
+ * end of the buffer. Nothing is returned while a transmission is running.
+ *
+ * @param pRing         TX ring buffer
+ * @param maxLength     Maximum length of the block
+ * @param pIndex        Returns the buffer index of the first byte
+ *
+ * @return Length of the block, 0 if there is nothing to transmit
+ */
+uint32_t uartTxRingNext(const UARTTxRing_t* pRing, uint32_t maxLength, uint32_t* pIndex);
+
+/**
+ * @brief Hands a block returned by uartTxRingNext() over to the transmission
+ *
+ * @param pRing         TX ring buffer
+ * @param length        Length of the started transmission
+ */
+void uartTxRingStart(UARTTxRing_t* pRing, uint32_t length);
+
+/**
+ * @brief Releases the running transmission
+ *
+ * @param pRing         TX ring buffer
+ * @param sent          Number of bytes actually sent, the rest is counted as dropped
+ */
+void uartTxRingComplete(UARTTxRing_t* pRing, uint32_t sent);
+
+/**
+ * @brief Checks whether all bytes have been transmitted
+ *
+ * @param pRing         TX ring buffer
+ *
+ * @return true if no byte is waiting and no transmission is running
+ */
+bool uartTxRingIsIdle(const UARTTxRing_t* pRing);
+
+#endif
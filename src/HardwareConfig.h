@@ -83,6 +83,14 @@
 #define USART_RX_PIN                            GPIO_PIN_3
 #define USART_RX_GPIO_PORT                      GPIOA
 
+/*
+ * Sensor USART Pin Configuration
+*/
+#define SENSOR_USART_TX_PIN                     GPIO_PIN_4
+#define SENSOR_USART_TX_GPIO_PORT               GPIOC
+#define SENSOR_USART_RX_PIN                     GPIO_PIN_5
+#define SENSOR_USART_RX_GPIO_PORT               GPIOC
+
 /*
  * Input (Button) Pins
 */
@@ -34,6 +34,7 @@
 
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static void schedRunSlot(uint32_t halTick, uint32_t* pLastTick, uint32_t period, CyclicFunction pTask);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
@@ -44,6 +45,17 @@
 
 int32_t schedInitialize(Scheduler* pScheduler)
 {
+    // Check for valid pointer
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    uint32_t halTick = pScheduler->pGetHALTick();
+
+    pScheduler->halTick_1ms     = halTick;
+    pScheduler->halTick_10ms    = halTick;
+    pScheduler->halTick_100ms   = halTick;
+    pScheduler->halTick_250ms   = halTick;
+    pScheduler->halTick_1000ms  = halTick;
 
     return SCHED_ERR_OK;
 }
@@ -51,10 +63,48 @@ int32_t schedInitialize(Scheduler* pScheduler)
 
 int32_t schedCycle(Scheduler* pScheduler)
 {
+    // Check for valid pointer
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0)
+        return SCHED_ERR_INVALID_PTR;
 
+    uint32_t halTick = pScheduler->pGetHALTick();
+
+    schedRunSlot(halTick, &pScheduler->halTick_1ms,     HAL_TICK_VALUE_1MS,     pScheduler->pTask_1ms);
+    schedRunSlot(halTick, &pScheduler->halTick_10ms,    HAL_TICK_VALUE_10MS,    pScheduler->pTask_10ms);
+    schedRunSlot(halTick, &pScheduler->halTick_100ms,   HAL_TICK_VALUE_100MS,   pScheduler->pTask_100ms);
+    schedRunSlot(halTick, &pScheduler->halTick_250ms,   HAL_TICK_VALUE_250MS,   pScheduler->pTask_250ms);
+    schedRunSlot(halTick, &pScheduler->halTick_1000ms,  HAL_TICK_VALUE_1000MS,  pScheduler->pTask_1000ms);
 
     return SCHED_ERR_OK;
 }
 
 
 /***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Runs the task of a time slot if its period has elapsed
+ *
+ * @param halTick       Current HAL tick
+ * @param pLastTick     Start of the current period of the slot
+ * @param period        Period of the slot in HAL ticks
+ * @param pTask         Task function of the slot (can be 0)
+ */
+static void schedRunSlot(uint32_t halTick, uint32_t* pLastTick, uint32_t period, CyclicFunction pTask)
+{
+    // Unsigned difference, so the wrap around of the HAL tick does not matter
+    if ((uint32_t)(halTick - *pLastTick) < period)
+        return;
+
+    // Keep the slots aligned to the period, but do not start a late task
+    // several times in a row to catch up
+    *pLastTick += period;
+    if ((uint32_t)(halTick - *pLastTick) >= period)
+    {
+        *pLastTick = halTick;
+    }
+
+    if (pTask != 0)
+    {
+        pTask();
+    }
+}
@@ -78,7 +78,8 @@ typedef struct _Scheduler
  * Initializes the internal values for the timestamps.
  *
  * @remark: This function doesn't initialize the function
- * pointers in the Scheduler struct!
+ * pointers in the Scheduler struct! pGetHALTick has to be set
+ * before, the task pointers can be 0 for unused slots.
  *
  * @param pScheduler Pointer to scheduler struct
  *
@@ -94,6 +95,9 @@ int32_t schedInitialize(Scheduler* pScheduler);
  *
  * @param pScheduler Pointer to scheduler struct
  *
+ * A task which is late by more than one period is started only once
+ * and its time slot is realigned to the current tick.
+ *
  * @return SCHED_ERR_OK if no error occured
  */
 int32_t schedCycle(Scheduler* pScheduler);
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * @file DualChannelGasSensor.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the redundant gas sensor on the two fast ADC inputs
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "DualChannelGasSensor.h"
+#include "GasScale/GasScale.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define GAS_SENSOR_PPM_SPAN         (GAS_PPM_MAX - GAS_PPM_MIN)                 //!< Span of the measurement range [ppm]
+#define GAS_SENSOR_MICROVOLT_SPAN   (GAS_MICROVOLT_MAX - GAS_MICROVOLT_MIN)     //!< Span of the sensor voltage [µV]
+
+/**
+ * ppm = GAS_PPM_MIN + round((µV - GAS_MICROVOLT_MIN) * GAS_SENSOR_PPM_SPAN / GAS_SENSOR_MICROVOLT_SPAN)
+ * with the division replaced by the reciprocal GAS_SENSOR_PPM_FACTOR / 2^GAS_SENSOR_PPM_SHIFT.
+ * The factor is rounded up, so exact halves are rounded up like in
+ * gasScaleMicroVoltToPpm(). With a shift of 35 the error of the factor stays
+ * below one step of the rounding decision (1e-4 ppm) over the full voltage
+ * span and the factor still fits into 32 bit (single 32x32->64 multiply).
+ */
+#define GAS_SENSOR_PPM_SHIFT        35
+#define GAS_SENSOR_PPM_FACTOR       ((((uint64_t)GAS_SENSOR_PPM_SPAN << GAS_SENSOR_PPM_SHIFT) + GAS_SENSOR_MICROVOLT_SPAN - 1) / GAS_SENSOR_MICROVOLT_SPAN)
+#define GAS_SENSOR_PPM_ROUNDING     ((uint64_t)1 << (GAS_SENSOR_PPM_SHIFT - 1))
+
+#define GAS_SENSOR_CHANNEL1         0           //!< Index of channel 1 (ADC_INPUT0)
+#define GAS_SENSOR_CHANNEL2         1           //!< Index of channel 2 (ADC_INPUT1)
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static bool gasSensorChannelUpdate(GasSensorChannel_t* pChannel, int32_t microVolt);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t gasSensorInitialize(DualChannelGasSensor_t* pSensor)
+{
+    if (pSensor == 0)
+    {
+        return GAS_SENSOR_ERR_INVALID_PARAM;
+    }
+
+    *pSensor = (DualChannelGasSensor_t){ 0 };
+    for (int32_t i = 0; i < GAS_SENSOR_CHANNEL_COUNT; i++)
+    {
+        filterInitEMA(&pSensor->channel[i].filter, GAS_SENSOR_FILTER_SCALING, GAS_SENSOR_FILTER_ALPHA, true);
+    }
+
+    return GAS_SENSOR_ERR_OK;
+}
+
+int32_t gasSensorProcessSnapshot(DualChannelGasSensor_t* pSensor, const ADCSnapshot_t* pSnapshot)
+{
+    if (pSensor == 0 || pSnapshot == 0)
+    {
+        return GAS_SENSOR_ERR_INVALID_PARAM;
+    }
+
+    if (pSnapshot->sequenceNumber == pSensor->sequenceNumber)
+    {
+        return pSensor->valid ? gasSensorGetPpm(pSensor, 0) : GAS_SENSOR_ERR_NO_DATA;
+    }
+
+    pSensor->sequenceNumber = pSnapshot->sequenceNumber;
+
+    // Both gas inputs are connected without divider
+    return gasSensorProcess(pSensor,
+                            pSnapshot->rawValues[ADC_INPUT0] * ADC_MICROVOLTS_PER_DIGIT,
+                            pSnapshot->rawValues[ADC_INPUT1] * ADC_MICROVOLTS_PER_DIGIT);
+}
+
+int32_t gasSensorProcess(DualChannelGasSensor_t* pSensor, int32_t microVolt1, int32_t microVolt2)
+{
+    if (pSensor == 0)
+    {
+        return GAS_SENSOR_ERR_INVALID_PARAM;
+    }
+
+    GasSensorChannel_t* pChannel1 = &pSensor->channel[GAS_SENSOR_CHANNEL1];
+    GasSensorChannel_t* pChannel2 = &pSensor->channel[GAS_SENSOR_CHANNEL2];
+    uint32_t flags = 0;
+
+    if (!gasSensorChannelUpdate(pChannel1, microVolt1))
+    {
+        flags |= GAS_SENSOR_FLAG_RANGE_CH1;
+    }
+
+    if (!gasSensorChannelUpdate(pChannel2, microVolt2))
+    {
+        flags |= GAS_SENSOR_FLAG_RANGE_CH2;
+    }
+
+    // A channel out of range is already a defect, its (limited) value says
+    // nothing about the consistency of the sensors
+    if (flags == 0 && !gasSensorIsConsistent(pChannel1->ppm, pChannel2->ppm))
+    {
+        flags |= GAS_SENSOR_FLAG_INCONSISTENT;
+        pSensor->inconsistencies++;
+    }
+
+    pSensor->ppm = (pChannel1->ppm + pChannel2->ppm + 1) >> 1;
+    pSensor->flags = flags;
+    pSensor->valid = true;
+    pSensor->samples++;
+
+    return (flags == 0) ? GAS_SENSOR_ERR_OK : GAS_SENSOR_ERR_DEFECT;
+}
+
+int32_t gasSensorGetPpm(const DualChannelGasSensor_t* pSensor, int32_t* pPpm)
+{
+    if (pSensor == 0)
+    {
+        return GAS_SENSOR_ERR_INVALID_PARAM;
+    }
+
+    if (!pSensor->valid)
+    {
+        return GAS_SENSOR_ERR_NO_DATA;
+    }
+
+    if (pPpm != 0)
+    {
+        *pPpm = pSensor->ppm;
+    }
+
+    return (pSensor->flags == 0) ? GAS_SENSOR_ERR_OK : GAS_SENSOR_ERR_DEFECT;
+}
+
+uint32_t gasSensorGetFlags(const DualChannelGasSensor_t* pSensor)
+{
+    return (pSensor != 0) ? pSensor->flags : 0;
+}
+
+int32_t gasSensorMicroVoltToPpm(int32_t microVolt)
+{
+    if (microVolt < GAS_MICROVOLT_MIN)
+    {
+        microVolt = GAS_MICROVOLT_MIN;
+    }
+    else if (microVolt > GAS_MICROVOLT_MAX)
+    {
+        microVolt = GAS_MICROVOLT_MAX;
+    }
+
+    uint64_t scaled = (uint64_t)(uint32_t)(microVolt - GAS_MICROVOLT_MIN) * (uint32_t)GAS_SENSOR_PPM_FACTOR;
+
+    return GAS_PPM_MIN + (int32_t)((scaled + GAS_SENSOR_PPM_ROUNDING) >> GAS_SENSOR_PPM_SHIFT);
+}
+
+bool gasSensorIsConsistent(int32_t ppm1, int32_t ppm2)
+{
+    int32_t difference = (ppm1 > ppm2) ? (ppm1 - ppm2) : (ppm2 - ppm1);
+
+    // |ppm1 - ppm2| <= pct / 100 * (ppm1 + ppm2) / 2, multiplied by 200
+    return difference * 200 <= GAS_SENSOR_MAX_DEVIATION_PCT * (ppm1 + ppm2);
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Filters a sample of a channel and converts it to ppm
+ *
+ * The range is checked on the unfiltered sample, so a broken wire is
+ * detected with the first sample.
+ *
+ * @param pChannel      State of the channel
+ * @param microVolt     Sample [µV]
+ *
+ * @return true if the sample is within the valid voltage range
+ */
+static bool gasSensorChannelUpdate(GasSensorChannel_t* pChannel, int32_t microVolt)
+{
+    bool inRange = (microVolt >= GAS_MICROVOLT_MIN) && (microVolt <= GAS_MICROVOLT_MAX);
+
+    if (!inRange)
+    {
+        pChannel->rangeErrors++;
+    }
+
+    pChannel->microVolt = microVolt;
+    pChannel->filteredMicroVolt = filterEMA(&pChannel->filter, microVolt);
+    pChannel->ppm = gasSensorMicroVoltToPpm(pChannel->filteredMicroVolt);
+
+    return inRange;
+}
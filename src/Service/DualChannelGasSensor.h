@@ -0,0 +1,166 @@
+/******************************************************************************
+ * @file DualChannelGasSensor.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the redundant gas sensor on the two fast ADC inputs
+ *
+ * Both sensors measure the same gas concentration (0.5 V .. 2.5 V for
+ * 200 ppm .. 10000 ppm, see GasScale.h). The samples of both channels are
+ * taken from the same conversion sequence (adcGetSnapshot()), filtered,
+ * converted to ppm and averaged. A channel outside of the voltage range and
+ * a disagreement of both channels of more than GAS_SENSOR_MAX_DEVIATION_PCT
+ * of their mean are flagged as sensor defect.
+ *
+ * The conversion uses a precomputed reciprocal (multiply and shift), the
+ * consistency check compares cross products, so no division is needed per
+ * sample.
+ *
+ *****************************************************************************/
+#ifndef _DUAL_CHANNEL_GAS_SENSOR_H_
+#define _DUAL_CHANNEL_GAS_SENSOR_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ADCModule.h"
+#include "Filter/Filter.h"
+
+/***** CONSTANTS *************************************************************/
+#define GAS_SENSOR_CHANNEL_COUNT        2           //!< Number of redundant sensors
+#define GAS_SENSOR_MAX_DEVIATION_PCT    10          //!< Maximum difference of both channels relative to their mean [%]
+
+#define GAS_SENSOR_FILTER_SCALING       1024        //!< Scaling factor of the EMA filter of the samples (power of 2, no division)
+#define GAS_SENSOR_FILTER_ALPHA         256         //!< Filter constant of the EMA filter (0.25, scaled)
+
+
+/***** MACROS ****************************************************************/
+#define GAS_SENSOR_ERR_OK               0           //!< No error occured
+#define GAS_SENSOR_ERR_INVALID_PARAM    -1          //!< Invalid parameter (Null Pointer)
+#define GAS_SENSOR_ERR_NO_DATA          -2          //!< No sample processed yet
+#define GAS_SENSOR_ERR_DEFECT           -3          //!< Last sample out of range or channels inconsistent
+
+#define GAS_SENSOR_FLAG_RANGE_CH1       0x01        //!< Voltage of channel 1 (ADC_INPUT0) outside of the valid range
+#define GAS_SENSOR_FLAG_RANGE_CH2       0x02        //!< Voltage of channel 2 (ADC_INPUT1) outside of the valid range
+#define GAS_SENSOR_FLAG_INCONSISTENT    0x04        //!< Both channels differ by more than GAS_SENSOR_MAX_DEVIATION_PCT
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief State of one of the redundant sensors
+ *
+ */
+typedef struct _GasSensorChannel_
+{
+    int32_t microVolt;              //!< Last sample [µV]
+    int32_t filteredMicroVolt;      //!< EMA filtered samples [µV]
+    int32_t ppm;                    //!< Gas concentration of the filtered samples (limited to the measurement range)
+    EMAFilterData_t filter;         //!< State of the EMA filter
+    uint32_t rangeErrors;           //!< Number of samples outside of the valid voltage range
+} GasSensorChannel_t;
+
+/**
+ * @brief Instance of the dual channel gas sensor
+ *
+ */
+typedef struct _DualChannelGasSensor_
+{
+    GasSensorChannel_t channel[GAS_SENSOR_CHANNEL_COUNT];   //!< State of both sensors
+    bool valid;                     //!< At least one sample has been processed
+    uint32_t flags;                 //!< GAS_SENSOR_FLAG_xxx of the last sample
+    int32_t ppm;                    //!< Mean gas concentration of both channels
+    uint32_t sequenceNumber;        //!< Sequence number of the last processed ADC snapshot
+    uint32_t samples;               //!< Number of processed samples
+    uint32_t inconsistencies;       //!< Number of samples with inconsistent channels
+} DualChannelGasSensor_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes a gas sensor instance
+ *
+ * @param pSensor       Sensor instance
+ *
+ * @return Returns GAS_SENSOR_ERR_OK if no error occured, otherwise GAS_SENSOR_ERR_INVALID_PARAM
+ */
+int32_t gasSensorInitialize(DualChannelGasSensor_t* pSensor);
+
+/**
+ * @brief Processes the gas sensor channels of an ADC snapshot
+ *
+ * Snapshots with the sequence number of the last processed snapshot are
+ * skipped, so the function can be called faster than the ADC sample rate.
+ *
+ * @param pSensor       Sensor instance
+ * @param pSnapshot     Snapshot of the fast acquisition group (adcGetSnapshot())
+ *
+ * @return GAS_SENSOR_ERR_OK, GAS_SENSOR_ERR_NO_DATA or GAS_SENSOR_ERR_DEFECT
+ * (see gasSensorGetPpm())
+ */
+int32_t gasSensorProcessSnapshot(DualChannelGasSensor_t* pSensor, const ADCSnapshot_t* pSnapshot);
+
+/**
+ * @brief Processes one sample of both channels
+ *
+ * @param pSensor       Sensor instance
+ * @param microVolt1    Voltage of channel 1 [µV]
+ * @param microVolt2    Voltage of channel 2 [µV]
+ *
+ * @return GAS_SENSOR_ERR_OK or GAS_SENSOR_ERR_DEFECT (see gasSensorGetPpm())
+ */
+int32_t gasSensorProcess(DualChannelGasSensor_t* pSensor, int32_t microVolt1, int32_t microVolt2);
+
+/**
+ * @brief Returns the mean gas concentration of both channels
+ *
+ * The value is also written if the sensor is defect, e.g. for diagnostics.
+ *
+ * @param pSensor       Sensor instance
+ * @param pPpm          Pointer to store the gas concentration [ppm] to
+ *
+ * @return GAS_SENSOR_ERR_OK, GAS_SENSOR_ERR_NO_DATA (value is not written) or
+ * GAS_SENSOR_ERR_DEFECT
+ */
+int32_t gasSensorGetPpm(const DualChannelGasSensor_t* pSensor, int32_t* pPpm);
+
+/**
+ * @brief Returns the flags of the last processed sample
+ *
+ * @param pSensor       Sensor instance
+ *
+ * @return GAS_SENSOR_FLAG_xxx bit mask, 0 if the sensor is ok
+ */
+uint32_t gasSensorGetFlags(const DualChannelGasSensor_t* pSensor);
+
+/**
+ * @brief Converts a sensor voltage to the gas concentration
+ *
+ * Same result as gasScaleMicroVoltToPpm(), but with a multiplication by the
+ * precomputed reciprocal of the voltage span instead of a division.
+ *
+ * @param microVolt     Sensor voltage in µV (limited to the valid range)
+ *
+ * @return Gas concentration in ppm (rounded)
+ */
+int32_t gasSensorMicroVoltToPpm(int32_t microVolt);
+
+/**
+ * @brief Checks whether two gas concentrations agree within
+ * GAS_SENSOR_MAX_DEVIATION_PCT of their mean
+ *
+ * @param ppm1          Gas concentration of channel 1 [ppm]
+ * @param ppm2          Gas concentration of channel 2 [ppm]
+ *
+ * @return true if both values are consistent
+ */
+bool gasSensorIsConsistent(int32_t ppm1, int32_t ppm2);
+
+#endif
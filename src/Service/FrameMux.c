@@ -0,0 +1,395 @@
+/******************************************************************************
+ * @file FrameMux.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the Frame Multiplexer (COBS framing with channel
+ * ID and CRC16 on top of the UART module)
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stddef.h>
+
+#include "UARTModule.h"
+#include "FrameMux.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define FRAMEMUX_DELIMITER          0x00    //!< End of frame marker
+#define FRAMEMUX_CRC_START          0xFFFF  //!< Start value of the CRC16-CCITT
+#define FRAMEMUX_CRC_POLYNOMIAL     0x1021  //!< Polynomial of the CRC16-CCITT
+#define FRAMEMUX_COBS_MAX_BLOCK     0xFF    //!< Code of a COBS block with 254 data bytes and no zero
+
+#define FRAMEMUX_MAX_RAW            (1 + FRAMEMUX_MAX_PAYLOAD + 2)                      //!< Channel, payload and CRC
+#define FRAMEMUX_MAX_ENCODED        (FRAMEMUX_MAX_RAW + (FRAMEMUX_MAX_RAW / 254) + 2)   //!< COBS overhead and delimiter
+
+#define FRAMEMUX_RX_CHUNK           32      //!< Number of bytes read from the UART at once
+#define FRAMEMUX_UART_PORT          UART_PORT_DEBUG     //!< UART port carrying the frames
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief State of the COBS encoder
+ *
+ */
+typedef struct _CobsEncoder_
+{
+    uint8_t* pBuffer;               //!< Output buffer
+    uint32_t position;              //!< Next write position in the output buffer
+    uint32_t codePosition;          //!< Position of the code byte of the current block
+    uint8_t code;                   //!< Code of the current block (number of bytes + 1)
+} CobsEncoder_t;
+
+/**
+ * @brief State of the streaming COBS decoder
+ *
+ */
+typedef struct _CobsDecoder_
+{
+    uint8_t buffer[FRAMEMUX_MAX_RAW];   //!< Decoded frame (channel, payload, CRC)
+    uint32_t length;                //!< Number of decoded bytes
+    uint8_t remaining;              //!< Number of data bytes left in the current block
+    uint8_t code;                   //!< Code of the current block, 0 at the start of a frame
+    uint8_t discard;                //!< Frame is invalid, discard until the next delimiter
+} CobsDecoder_t;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint16_t frameMuxCrcUpdate(uint16_t crc, uint8_t data);
+static void frameMuxEncodeByte(CobsEncoder_t* pEncoder, uint8_t data);
+static int32_t frameMuxWriteChannel(uint8_t channel, uint8_t* pData, int32_t length);
+static int32_t frameMuxDecodeByte(uint8_t data);
+static void frameMuxDecoderAppend(uint8_t data);
+static int32_t frameMuxDispatch(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static FrameMuxConsumer gConsumers[FRAMEMUX_MAX_CHANNELS];     //!< Consumer per channel
+static CobsDecoder_t gDecoder;                                  //!< Decoder for the received data
+static FrameMuxStats_t gStats;                                  //!< Statistics
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t frameMuxInitialize(void)
+{
+    for (uint32_t i = 0; i < FRAMEMUX_MAX_CHANNELS; i++)
+    {
+        gConsumers[i] = 0;
+    }
+
+    gDecoder.length = 0;
+    gDecoder.remaining = 0;
+    gDecoder.code = 0;
+    gDecoder.discard = 0;
+
+    gStats = (FrameMuxStats_t){ 0 };
+
+    return FRAMEMUX_ERR_OK;
+}
+
+int32_t frameMuxRegisterConsumer(uint8_t channel, FrameMuxConsumer pConsumer)
+{
+    if (channel >= FRAMEMUX_MAX_CHANNELS)
+    {
+        return FRAMEMUX_ERR_INVALID_PARAM;
+    }
+
+    gConsumers[channel] = pConsumer;
+
+    return FRAMEMUX_ERR_OK;
+}
+
+int32_t frameMuxSend(uint8_t channel, const uint8_t* pPayload, uint16_t length)
+{
+    if (channel >= FRAMEMUX_MAX_CHANNELS || length > FRAMEMUX_MAX_PAYLOAD || (pPayload == 0 && length > 0))
+    {
+        return FRAMEMUX_ERR_INVALID_PARAM;
+    }
+
+    /* Encoded on the stack, so frames can be sent from any context */
+    uint8_t frame[FRAMEMUX_MAX_ENCODED];
+    CobsEncoder_t encoder = { frame, 1, 0, 1 };
+    uint16_t crc = frameMuxCrcUpdate(FRAMEMUX_CRC_START, channel);
+
+    frameMuxEncodeByte(&encoder, channel);
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc = frameMuxCrcUpdate(crc, pPayload[i]);
+        frameMuxEncodeByte(&encoder, pPayload[i]);
+    }
+
+    frameMuxEncodeByte(&encoder, (uint8_t)(crc & 0xFF));
+    frameMuxEncodeByte(&encoder, (uint8_t)(crc >> 8));
+
+    frame[encoder.codePosition] = encoder.code;
+    frame[encoder.position++] = FRAMEMUX_DELIMITER;
+
+    if (uartSendData(FRAMEMUX_UART_PORT, frame, (int32_t)encoder.position) != UART_ERR_OK)
+    {
+        gStats.framesDropped++;
+        return FRAMEMUX_ERR_TRANSMIT;
+    }
+
+    gStats.framesSent++;
+
+    return FRAMEMUX_ERR_OK;
+}
+
+int32_t frameMuxWriteLog(uint8_t* pData, int32_t length)
+{
+    return frameMuxWriteChannel(FRAME_CHANNEL_LOG, pData, length);
+}
+
+int32_t frameMuxWriteTelemetry(uint8_t* pData, int32_t length)
+{
+    return frameMuxWriteChannel(FRAME_CHANNEL_TELEMETRY, pData, length);
+}
+
+int32_t frameMuxProcess(void)
+{
+    uint8_t chunk[FRAMEMUX_RX_CHUNK];
+    int32_t frameCount = 0;
+    int32_t count;
+
+    while ((count = uartRead(FRAMEMUX_UART_PORT, chunk, FRAMEMUX_RX_CHUNK)) > 0)
+    {
+        for (int32_t i = 0; i < count; i++)
+        {
+            frameCount += frameMuxDecodeByte(chunk[i]);
+        }
+    }
+
+    return frameCount;
+}
+
+int32_t frameMuxGetStats(FrameMuxStats_t* pStats)
+{
+    if (pStats == 0)
+    {
+        return FRAMEMUX_ERR_INVALID_PARAM;
+    }
+
+    *pStats = gStats;
+
+    return FRAMEMUX_ERR_OK;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Updates the CRC16-CCITT with one byte
+ *
+ * @param crc           Current CRC value
+ * @param data          Data byte
+ *
+ * @return Updated CRC value
+ */
+static uint16_t frameMuxCrcUpdate(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t)data << 8;
+
+    for (int32_t bit = 0; bit < 8; bit++)
+    {
+        if (crc & 0x8000)
+        {
+            crc = (uint16_t)((crc << 1) ^ FRAMEMUX_CRC_POLYNOMIAL);
+        }
+        else
+        {
+            crc = (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Adds one byte to the COBS encoded output
+ *
+ * @param pEncoder      Encoder state
+ * @param data          Byte to encode
+ */
+static void frameMuxEncodeByte(CobsEncoder_t* pEncoder, uint8_t data)
+{
+    if (data != 0)
+    {
+        pEncoder->pBuffer[pEncoder->position++] = data;
+        pEncoder->code++;
+    }
+
+    /* A zero as well as a full block closes the current block */
+    if (data == 0 || pEncoder->code == FRAMEMUX_COBS_MAX_BLOCK)
+    {
+        pEncoder->pBuffer[pEncoder->codePosition] = pEncoder->code;
+        pEncoder->codePosition = pEncoder->position++;
+        pEncoder->code = 1;
+    }
+}
+
+/**
+ * @brief Sends data on a channel, split into frames of at most FRAMEMUX_MAX_PAYLOAD bytes
+ *
+ * @param channel       Channel number
+ * @param pData         Pointer to the data
+ * @param length        Number of bytes
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured, otherwise FRAMEMUX_ERR_TRANSMIT
+ */
+static int32_t frameMuxWriteChannel(uint8_t channel, uint8_t* pData, int32_t length)
+{
+    int32_t result = FRAMEMUX_ERR_OK;
+
+    if (pData == 0 || length < 0)
+    {
+        return FRAMEMUX_ERR_TRANSMIT;
+    }
+
+    while (length > 0)
+    {
+        uint16_t chunk = (length > FRAMEMUX_MAX_PAYLOAD) ? FRAMEMUX_MAX_PAYLOAD : (uint16_t)length;
+
+        if (frameMuxSend(channel, pData, chunk) != FRAMEMUX_ERR_OK)
+        {
+            result = FRAMEMUX_ERR_TRANSMIT;
+        }
+
+        pData += chunk;
+        length -= chunk;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Feeds one received byte into the COBS decoder
+ *
+ * @param data          Received byte
+ *
+ * @return 1 if a valid frame was completed and dispatched, otherwise 0
+ */
+static int32_t frameMuxDecodeByte(uint8_t data)
+{
+    int32_t result = 0;
+
+    if (data == FRAMEMUX_DELIMITER)
+    {
+        if (!gDecoder.discard && gDecoder.code != 0)
+        {
+            if (gDecoder.remaining != 0)
+            {
+                /* Frame ended within a block */
+                gStats.framingErrors++;
+            }
+            else
+            {
+                result = frameMuxDispatch();
+            }
+        }
+
+        gDecoder.length = 0;
+        gDecoder.remaining = 0;
+        gDecoder.code = 0;
+        gDecoder.discard = 0;
+
+        return result;
+    }
+
+    if (gDecoder.discard)
+    {
+        return 0;
+    }
+
+    if (gDecoder.remaining == 0)
+    {
+        /* Code byte: the block before implies a zero unless it was a full block */
+        if (gDecoder.code != 0 && gDecoder.code != FRAMEMUX_COBS_MAX_BLOCK)
+        {
+            frameMuxDecoderAppend(0);
+        }
+
+        gDecoder.code = data;
+        gDecoder.remaining = data - 1;
+    }
+    else
+    {
+        frameMuxDecoderAppend(data);
+        gDecoder.remaining--;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Appends a decoded byte to the frame buffer
+ *
+ * @param data          Decoded byte
+ */
+static void frameMuxDecoderAppend(uint8_t data)
+{
+    if (gDecoder.length >= FRAMEMUX_MAX_RAW)
+    {
+        gStats.framingErrors++;
+        gDecoder.discard = 1;
+        return;
+    }
+
+    gDecoder.buffer[gDecoder.length++] = data;
+}
+
+/**
+ * @brief Checks a completely decoded frame and passes it to the consumer of its channel
+ *
+ * @return 1 if the frame was valid, otherwise 0
+ */
+static int32_t frameMuxDispatch(void)
+{
+    if (gDecoder.length < 3)
+    {
+        gStats.framingErrors++;
+        return 0;
+    }
+
+    uint32_t dataLength = gDecoder.length - 2;
+    uint16_t crc = FRAMEMUX_CRC_START;
+
+    for (uint32_t i = 0; i < dataLength; i++)
+    {
+        crc = frameMuxCrcUpdate(crc, gDecoder.buffer[i]);
+    }
+
+    uint16_t frameCrc = (uint16_t)(gDecoder.buffer[dataLength] | (gDecoder.buffer[dataLength + 1] << 8));
+
+    if (crc != frameCrc)
+    {
+        gStats.crcErrors++;
+        return 0;
+    }
+
+    uint8_t channel = gDecoder.buffer[0];
+
+    gStats.framesReceived++;
+
+    if (channel >= FRAMEMUX_MAX_CHANNELS || gConsumers[channel] == 0)
+    {
+        gStats.unhandledFrames++;
+        return 1;
+    }
+
+    /* Zero copy: the consumer works on the decode buffer */
+    gConsumers[channel](channel, &gDecoder.buffer[1], (uint16_t)(dataLength - 1));
+
+    return 1;
+}
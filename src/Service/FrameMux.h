@@ -0,0 +1,161 @@
+/******************************************************************************
+ * @file FrameMux.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the Frame Multiplexer, which carries several
+ * logical channels (log, sensor, telemetry, ...) over the single UART
+ *
+ * Wire format of a frame:
+ *
+ *  COBS( channel | payload[0..FRAMEMUX_MAX_PAYLOAD] | CRC16 low | CRC16 high ) 0x00
+ *
+ * The CRC16 is a CRC-CCITT (polynomial 0x1021, start value 0xFFFF) over the
+ * channel byte and the payload. COBS removes all 0x00 bytes from the frame,
+ * so 0x00 marks the end of a frame and the receiver resynchronizes on it.
+ * See tools/frame_demux.py for the host side.
+ *
+ *****************************************************************************/
+#ifndef _FRAME_MUX_H_
+#define _FRAME_MUX_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+/***** CONSTANTS *************************************************************/
+#define FRAMEMUX_MAX_PAYLOAD        128     //!< Maximum number of payload bytes of a frame
+#define FRAMEMUX_MAX_CHANNELS       8       //!< Number of logical channels
+
+
+/***** MACROS ****************************************************************/
+#define FRAMEMUX_ERR_OK             0       //!< No error occured
+#define FRAMEMUX_ERR_INVALID_PARAM  -1      //!< Invalid parameter (channel, pointer or length)
+#define FRAMEMUX_ERR_TRANSMIT       -2      //!< Frame could not be queued for transmission
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Logical channels of the frame multiplexer
+ *
+ */
+typedef enum _FrameChannel_
+{
+    FRAME_CHANNEL_CONTROL = 0,      //!< Control messages (commands from the host)
+    FRAME_CHANNEL_LOG = 1,          //!< Text output of outputLog()/outputLogf()
+    FRAME_CHANNEL_SENSOR = 2,       //!< Water sensor frames
+    FRAME_CHANNEL_TELEMETRY = 3,    //!< Binary telemetry and ADC dumps
+    FRAME_CHANNEL_DIAGNOSTIC = 4    //!< Diagnostic data
+} FrameChannel_t;
+
+/**
+ * @brief Function pointer for a channel consumer
+ *
+ * The payload points directly into the receive buffer of the multiplexer
+ * and is only valid during the call.
+ */
+typedef void (*FrameMuxConsumer)(uint8_t channel, const uint8_t* pPayload, uint16_t length);
+
+/**
+ * @brief Statistics of the frame multiplexer
+ *
+ */
+typedef struct _FrameMuxStats_
+{
+    uint32_t framesSent;            //!< Number of frames queued for transmission
+    uint32_t framesDropped;         //!< Number of frames which could not be queued
+    uint32_t framesReceived;        //!< Number of valid frames received
+    uint32_t crcErrors;             //!< Number of received frames with a wrong CRC
+    uint32_t framingErrors;         //!< Number of received frames with invalid COBS encoding or length
+    uint32_t unhandledFrames;       //!< Number of valid frames without consumer for the channel
+} FrameMuxStats_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes the frame multiplexer (resets the decoder, the
+ * consumers and the statistics)
+ *
+ * The UART has to be initialized separately.
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured
+ */
+int32_t frameMuxInitialize(void);
+
+/**
+ * @brief Registers the consumer for a channel
+ *
+ * @param channel       Channel number (0..FRAMEMUX_MAX_CHANNELS-1)
+ * @param pConsumer     Consumer to call for every valid frame of the channel, 0 to remove
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured, otherwise FRAMEMUX_ERR_INVALID_PARAM
+ */
+int32_t frameMuxRegisterConsumer(uint8_t channel, FrameMuxConsumer pConsumer);
+
+/**
+ * @brief Encodes the payload as a frame and queues it for transmission
+ *
+ * The frame is queued as a whole, so frames of different channels never
+ * interleave on the wire.
+ *
+ * @param channel       Channel number (0..FRAMEMUX_MAX_CHANNELS-1)
+ * @param pPayload      Pointer to the payload
+ * @param length        Length of the payload (0..FRAMEMUX_MAX_PAYLOAD)
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured, FRAMEMUX_ERR_TRANSMIT
+ * if the UART could not take the frame
+ */
+int32_t frameMuxSend(uint8_t channel, const uint8_t* pPayload, uint16_t length);
+
+/**
+ * @brief Sends data on the log channel, split into frames of at most
+ * FRAMEMUX_MAX_PAYLOAD bytes
+ *
+ * Has the signature of uartWriteDebug(), so it can be used as log writer.
+ *
+ * @param pData         Pointer to the data
+ * @param length        Number of bytes
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured, otherwise FRAMEMUX_ERR_TRANSMIT
+ */
+int32_t frameMuxWriteLog(uint8_t* pData, int32_t length);
+
+/**
+ * @brief Sends data on the telemetry channel, split into frames of at most
+ * FRAMEMUX_MAX_PAYLOAD bytes
+ *
+ * Has the signature of uartWriteDebug(), so it can be used as ADC dump writer.
+ *
+ * @param pData         Pointer to the data
+ * @param length        Number of bytes
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured, otherwise FRAMEMUX_ERR_TRANSMIT
+ */
+int32_t frameMuxWriteTelemetry(uint8_t* pData, int32_t length);
+
+/**
+ * @brief Decodes the received UART data and passes the valid frames to the
+ * registered consumers
+ *
+ * Has to be called cyclically (e.g. from the 10ms task). Does not block.
+ *
+ * @return Number of valid frames processed
+ */
+int32_t frameMuxProcess(void);
+
+/**
+ * @brief Returns the statistics of the frame multiplexer
+ *
+ * @param pStats        Pointer to store the statistics to
+ *
+ * @return Returns FRAMEMUX_ERR_OK if no error occured, otherwise FRAMEMUX_ERR_INVALID_PARAM
+ */
+int32_t frameMuxGetStats(FrameMuxStats_t* pStats);
+
+#endif
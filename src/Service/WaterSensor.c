@@ -0,0 +1,812 @@
+/******************************************************************************
+ * @file WaterSensor.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the streaming decoder of the RadioConnect water
+ * level sensor frames
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "WaterSensor.h"
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include "cmsis_compiler.h"
+#endif
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define WATER_HISTORY_MASK          (WATER_HISTORY_SIZE - 1)    //!< Mask for the circular history index
+#define WATER_MAX_FRAME_SIZE        WATER_ADDR_FRAME_SIZE(WATER_EXT_MAX_SAMPLES)    //!< Size of the largest frame
+
+#define WATER_OFFSET_VALUE          1       //!< Offset of the (first) value within a legacy or extended frame
+#define WATER_OFFSET_ID             1       //!< Offset of the probe ID within an addressed frame
+#define WATER_OFFSET_RESERVED       5       //!< Offset of the reserved word within a legacy frame
+
+#define WATER_CM_SPAN               (WATER_CM_MAX - WATER_CM_MIN)                   //!< Span of the measurement range [cm]
+#define WATER_MICROVOLT_SPAN        (WATER_MICROVOLT_MAX - WATER_MICROVOLT_MIN)     //!< Span of the sensor voltage [µV]
+
+/** Reserved word within the second word of a frame (little endian) */
+#define WATER_RESERVED_MASK         0x00FFFF00U
+#define WATER_RESERVED_WORD         ((uint32_t)WATER_FRAME_RESERVED << 8)
+
+/** Received byte, age 0 is the newest byte */
+#define WATER_HISTORY_BYTE(pSensor, age) \
+    ((pSensor)->history[((pSensor)->historyIndex - 1 - (age)) & WATER_HISTORY_MASK])
+
+#if (WATER_HISTORY_SIZE & (WATER_HISTORY_SIZE - 1)) != 0 || WATER_HISTORY_SIZE <= WATER_MAX_FRAME_SIZE
+#error "WATER_HISTORY_SIZE has to be a power of 2 larger than the largest frame"
+#endif
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t waterSensorFrameSize(const WaterSensor_t* pSensor, bool* pAddressed);
+static WaterChannel_t* waterSensorFindChannel(WaterSensor_t* pSensor, uint32_t frameSize, bool addressed, uint8_t* pSlot);
+static void waterSensorAcceptFrame(WaterSensor_t* pSensor, uint32_t frameSize, bool addressed, uint32_t nowUs);
+static uint32_t waterSensorSumBytes(uint32_t word0, uint32_t word1);
+static void waterChannelInitialize(WaterChannel_t* pChannel, uint32_t nowUs);
+static void waterChannelUpdateLink(WaterChannel_t* pChannel, uint32_t lostFrames, uint32_t periodUs, uint32_t nowUs);
+static uint32_t waterSensorRatePpm(uint32_t count, uint32_t total);
+static void waterBusUnlink(WaterBus_t* pBus, uint8_t slot);
+static void waterBusAppend(WaterBus_t* pBus, uint8_t slot);
+static void waterBusFrameReceived(WaterBus_t* pBus, uint8_t slot);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t waterSensorInitialize(WaterSensor_t* pSensor, uint32_t nowUs)
+{
+    if (pSensor == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    *pSensor = (WaterSensor_t){ 0 };
+    pSensor->framePeriodUs = WATER_FRAME_PERIOD_US;
+    waterChannelInitialize(&pSensor->channel, nowUs);
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterSensorSetSampleCallback(WaterSensor_t* pSensor, WaterSampleCallback pCallback)
+{
+    if (pSensor == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    pSensor->pSampleCallback = pCallback;
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterSensorSetFramePeriod(WaterSensor_t* pSensor, uint32_t periodUs)
+{
+    if (pSensor == 0 || periodUs == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    pSensor->framePeriodUs = periodUs;
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterSensorAttachBus(WaterSensor_t* pSensor, WaterBus_t* pBus)
+{
+    if (pSensor == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    pSensor->pBus = pBus;
+
+    return WATER_ERR_OK;
+}
+
+bool waterSensorProcessByte(WaterSensor_t* pSensor, uint8_t data, uint32_t nowUs)
+{
+    pSensor->streamSum += data;
+    pSensor->history[pSensor->historyIndex] = data;
+    pSensor->prefixSum[pSensor->historyIndex] = pSensor->streamSum;
+    pSensor->historyIndex = (pSensor->historyIndex + 1) & WATER_HISTORY_MASK;
+    pSensor->pendingCount++;
+
+    /* Not even the largest frame fits anymore, so bytes have been skipped */
+    if (pSensor->synchronized && pSensor->pendingCount > WATER_MAX_FRAME_SIZE)
+    {
+        pSensor->synchronized = false;
+        pSensor->stats.syncLosses++;
+    }
+
+    bool addressed;
+    uint32_t frameSize = waterSensorFrameSize(pSensor, &addressed);
+
+    if (frameSize == 0 || pSensor->pendingCount < frameSize)
+    {
+        return false;
+    }
+
+    /* Sum of the last frameSize bytes from the running sum in front of them */
+    uint8_t frameSum = (uint8_t)(pSensor->streamSum -
+                       pSensor->prefixSum[(pSensor->historyIndex - frameSize - 1) & WATER_HISTORY_MASK]);
+
+    if (frameSum != 0)
+    {
+        /* Only a frame right behind the previous one is known to be aligned */
+        if (pSensor->synchronized && pSensor->pendingCount == frameSize)
+        {
+            uint8_t slot;
+            WaterChannel_t* pChannel = waterSensorFindChannel(pSensor, frameSize, addressed, &slot);
+
+            pSensor->stats.checksumErrors++;
+            if (pChannel != 0)
+            {
+                pChannel->link.blockChecksumErrors++;
+            }
+        }
+
+        return false;
+    }
+
+    waterSensorAcceptFrame(pSensor, frameSize, addressed, nowUs);
+
+    return true;
+}
+
+int32_t waterSensorProcess(WaterSensor_t* pSensor, const uint8_t* pData, int32_t length, uint32_t nowUs)
+{
+    int32_t frameCount = 0;
+
+    if (pSensor == 0 || pData == 0)
+    {
+        return 0;
+    }
+
+    for (int32_t i = 0; i < length; i++)
+    {
+        if (waterSensorProcessByte(pSensor, pData[i], nowUs))
+        {
+            frameCount++;
+        }
+    }
+
+    return frameCount;
+}
+
+bool waterSensorCheckFrame(const uint8_t* pFrame)
+{
+    uint8_t sum = 0;
+
+    for (int32_t i = 0; i < WATER_FRAME_SIZE; i++)
+    {
+        sum += pFrame[i];
+    }
+
+    return sum == 0 &&
+           pFrame[WATER_OFFSET_RESERVED] == (WATER_FRAME_RESERVED & 0xFF) &&
+           pFrame[WATER_OFFSET_RESERVED + 1] == (WATER_FRAME_RESERVED >> 8);
+}
+
+int32_t waterSensorValidateFrames(const uint32_t* pFrames, int32_t frameCount, bool* pValid)
+{
+    int32_t validCount = 0;
+
+    if (pFrames == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    for (int32_t i = 0; i < frameCount; i++)
+    {
+        uint32_t word0 = pFrames[0];
+        uint32_t word1 = pFrames[1];
+
+        bool valid = ((waterSensorSumBytes(word0, word1) & 0xFF) == 0) &&
+                     ((word1 & WATER_RESERVED_MASK) == WATER_RESERVED_WORD);
+
+        if (pValid != 0)
+        {
+            pValid[i] = valid;
+        }
+
+        validCount += valid ? 1 : 0;
+        pFrames += WATER_FRAME_WORDS;
+    }
+
+    return validCount;
+}
+
+int32_t waterSensorCheckTimeout(WaterSensor_t* pSensor, uint32_t nowUs)
+{
+    if (pSensor == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    WaterChannel_t* pChannel = &pSensor->channel;
+
+    if ((nowUs - pChannel->lastFrameUs) > WATER_TIMEOUT_US)
+    {
+        if (!pChannel->timedOut)
+        {
+            pChannel->timedOut = true;
+            pChannel->valid = false;
+            pChannel->timeouts++;
+        }
+
+        return WATER_ERR_TIMEOUT;
+    }
+
+    return pChannel->valid ? WATER_ERR_OK : WATER_ERR_NO_DATA;
+}
+
+int32_t waterSensorGetLinkQuality(const WaterSensor_t* pSensor, WaterLinkQuality_t* pQuality)
+{
+    if (pSensor == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    return waterChannelGetLinkQuality(&pSensor->channel, pQuality);
+}
+
+int32_t waterSensorGetValue(const WaterSensor_t* pSensor, int32_t* pMicroVolt)
+{
+    if (pSensor == 0 || pMicroVolt == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    return waterChannelGetValue(&pSensor->channel, pMicroVolt, 0);
+}
+
+int32_t waterChannelGetValue(const WaterChannel_t* pChannel, int32_t* pMicroVolt, int32_t* pFilteredMicroVolt)
+{
+    if (pChannel == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    if (pChannel->timedOut)
+    {
+        return WATER_ERR_TIMEOUT;
+    }
+
+    if (!pChannel->valid)
+    {
+        return WATER_ERR_NO_DATA;
+    }
+
+    if (pMicroVolt != 0)
+    {
+        *pMicroVolt = pChannel->microVolt;
+    }
+
+    if (pFilteredMicroVolt != 0)
+    {
+        *pFilteredMicroVolt = pChannel->filteredMicroVolt;
+    }
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterSensorMicroVoltToCm(int32_t microVolt)
+{
+    if (microVolt < WATER_MICROVOLT_MIN)
+    {
+        microVolt = WATER_MICROVOLT_MIN;
+    }
+    else if (microVolt > WATER_MICROVOLT_MAX)
+    {
+        microVolt = WATER_MICROVOLT_MAX;
+    }
+
+    // 950cm * 2000000µV still fits into 32 bit, the division by the constant is a multiplication
+    uint32_t scaled = (uint32_t)(microVolt - WATER_MICROVOLT_MIN) * WATER_CM_SPAN;
+    return WATER_CM_MIN + (int32_t)((scaled + WATER_MICROVOLT_SPAN / 2) / WATER_MICROVOLT_SPAN);
+}
+
+int32_t waterChannelGetLinkQuality(const WaterChannel_t* pChannel, WaterLinkQuality_t* pQuality)
+{
+    if (pChannel == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    return waterLinkGetQuality(&pChannel->link, pQuality);
+}
+
+int32_t waterLinkGetQuality(const WaterLinkStats_t* pLink, WaterLinkQuality_t* pQuality)
+{
+    if (pLink == 0 || pQuality == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    *pQuality = (WaterLinkQuality_t){ 0 };
+
+    if (pLink->intervalCount != 0)
+    {
+        pQuality->intervalMinUs  = pLink->intervalMinUs;
+        pQuality->intervalMaxUs  = pLink->intervalMaxUs;
+        pQuality->intervalMeanUs = (uint32_t)(pLink->intervalSumUs / pLink->intervalCount);
+        pQuality->jitterMeanUs   = (uint32_t)(pLink->jitterSumUs / pLink->intervalCount);
+        pQuality->jitterMaxUs    = pLink->jitterMaxUs;
+    }
+
+    uint32_t expected = pLink->blockExpected + pLink->lastBlockExpected;
+
+    pQuality->lossRatePpm = waterSensorRatePpm(pLink->blockLost + pLink->lastBlockLost, expected);
+    pQuality->checksumErrorRatePpm = waterSensorRatePpm(pLink->blockChecksumErrors + pLink->lastBlockChecksumErrors, expected);
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterBusInitialize(WaterBus_t* pBus, WaterProbe_t* pProbes, uint32_t capacity)
+{
+    if (pBus == 0 || pProbes == 0 || capacity == 0 || capacity >= WATER_BUS_NO_SLOT)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    for (uint32_t id = 0; id < sizeof(pBus->slotOfId); id++)
+    {
+        pBus->slotOfId[id] = WATER_BUS_NO_SLOT;
+    }
+
+    pBus->pProbes = pProbes;
+    pBus->probeCapacity = (uint8_t)capacity;
+    pBus->probeCount = 0;
+    pBus->oldest = WATER_BUS_NO_SLOT;
+    pBus->newest = WATER_BUS_NO_SLOT;
+    pBus->defectCount = 0;
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterBusAddProbe(WaterBus_t* pBus, uint8_t id, uint32_t nowUs)
+{
+    if (pBus == 0 || pBus->pProbes == 0 || id == WATER_PROBE_ID_NONE)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    if (pBus->probeCount >= pBus->probeCapacity || pBus->slotOfId[id] != WATER_BUS_NO_SLOT)
+    {
+        return WATER_ERR_BUS_FULL;
+    }
+
+    uint8_t slot = pBus->probeCount++;
+    WaterProbe_t* pProbe = &pBus->pProbes[slot];
+
+    waterChannelInitialize(&pProbe->channel, nowUs);
+    pProbe->id = id;
+
+    // The supervision starts now, a probe which never sends times out as well
+    waterBusAppend(pBus, slot);
+    pBus->slotOfId[id] = slot;
+
+    return WATER_ERR_OK;
+}
+
+int32_t waterBusCheckTimeouts(WaterBus_t* pBus, uint32_t nowUs)
+{
+    if (pBus == 0)
+    {
+        return WATER_ERR_INVALID_PARAM;
+    }
+
+    // All probes behind the oldest one have newer frames
+    while (pBus->oldest != WATER_BUS_NO_SLOT)
+    {
+        uint8_t slot = pBus->oldest;
+        WaterChannel_t* pChannel = &pBus->pProbes[slot].channel;
+
+        if ((nowUs - pChannel->lastFrameUs) <= WATER_TIMEOUT_US)
+        {
+            break;
+        }
+
+        pChannel->timedOut = true;
+        pChannel->valid = false;
+        pChannel->timeouts++;
+        pBus->defectCount++;
+
+        waterBusUnlink(pBus, slot);
+    }
+
+    return pBus->defectCount;
+}
+
+const WaterChannel_t* waterBusGetChannel(const WaterBus_t* pBus, uint8_t id)
+{
+    if (pBus == 0 || pBus->slotOfId[id] == WATER_BUS_NO_SLOT)
+    {
+        return 0;
+    }
+
+    return &pBus->pProbes[pBus->slotOfId[id]].channel;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Sums up the bytes of a frame given as two little endian words
+ *
+ * Only the lower 8 bit of the result are relevant for the checksum.
+ *
+ * @param word0         Bytes 0..3 of the frame
+ * @param word1         Bytes 4..7 of the frame
+ *
+ * @return Sum of the 8 bytes
+ */
+static uint32_t waterSensorSumBytes(uint32_t word0, uint32_t word1)
+{
+#if defined(__ARM_FEATURE_SIMD32)
+    // |b - 0| summed over the four bytes of a word in one instruction
+    return __USADA8(word1, 0, __USAD8(word0, 0));
+#else
+    // Add the even and odd bytes in 16 bit lanes (at most 4 * 255 per lane)
+    uint32_t lanes = (word0 & 0x00FF00FFU) + ((word0 >> 8) & 0x00FF00FFU) +
+                     (word1 & 0x00FF00FFU) + ((word1 >> 8) & 0x00FF00FFU);
+
+    return lanes + (lanes >> 16);
+#endif
+}
+
+/**
+ * @brief Determines the size of a candidate frame ending with the newest
+ * byte from the reserved word in front of the checksum
+ *
+ * @param pSensor       Decoder instance
+ * @param pAddressed    Pointer to store whether it is an addressed frame to
+ *
+ * @return Size of the frame in bytes, 0 if there is no valid reserved word
+ */
+static uint32_t waterSensorFrameSize(const WaterSensor_t* pSensor, bool* pAddressed)
+{
+    uint8_t reservedLow = WATER_HISTORY_BYTE(pSensor, 2);
+    uint8_t reservedHigh = WATER_HISTORY_BYTE(pSensor, 1);
+    uint8_t sampleCount = reservedLow & 0x0F;
+
+    *pAddressed = false;
+
+    if (reservedHigh == (WATER_FRAME_RESERVED >> 8) && reservedLow == (WATER_FRAME_RESERVED & 0xFF))
+    {
+        return WATER_FRAME_SIZE;
+    }
+
+    if (reservedHigh != WATER_EXT_RESERVED_HIGH || sampleCount < 1 || sampleCount > WATER_EXT_MAX_SAMPLES)
+    {
+        return 0;
+    }
+
+    switch (reservedLow & 0xF0)
+    {
+        case WATER_EXT_VERSION:
+            return WATER_EXT_FRAME_SIZE(sampleCount);
+
+        case WATER_ADDR_VERSION:
+            *pAddressed = true;
+            return WATER_ADDR_FRAME_SIZE(sampleCount);
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Returns the sensor state a frame ending with the newest byte belongs to
+ *
+ * @param pSensor       Decoder instance
+ * @param frameSize     Size of the frame in bytes
+ * @param addressed     Frame is an addressed frame
+ * @param pSlot         Pointer to store the slot of the probe to (WATER_BUS_NO_SLOT if unaddressed)
+ *
+ * @return Sensor state, 0 for an addressed frame of an unknown probe
+ */
+static WaterChannel_t* waterSensorFindChannel(WaterSensor_t* pSensor, uint32_t frameSize, bool addressed, uint8_t* pSlot)
+{
+    *pSlot = WATER_BUS_NO_SLOT;
+
+    if (!addressed)
+    {
+        return &pSensor->channel;
+    }
+
+    if (pSensor->pBus == 0)
+    {
+        return 0;
+    }
+
+    uint8_t id = WATER_HISTORY_BYTE(pSensor, frameSize - 1 - WATER_OFFSET_ID);
+    uint8_t slot = pSensor->pBus->slotOfId[id];
+
+    if (slot == WATER_BUS_NO_SLOT)
+    {
+        return 0;
+    }
+
+    *pSlot = slot;
+
+    return &pSensor->pBus->pProbes[slot].channel;
+}
+
+/**
+ * @brief Takes over the frame which ends with the newest byte
+ *
+ * @param pSensor       Decoder instance
+ * @param frameSize     Size of the frame in bytes
+ * @param addressed     Frame is an addressed frame
+ * @param nowUs         Current time in us
+ */
+static void waterSensorAcceptFrame(WaterSensor_t* pSensor, uint32_t frameSize, bool addressed, uint32_t nowUs)
+{
+    int32_t samples[WATER_EXT_MAX_SAMPLES];
+    uint32_t valueOffset = addressed ? (WATER_OFFSET_ID + 1) : WATER_OFFSET_VALUE;
+    uint32_t sampleCount = (frameSize - valueOffset - 3) / 4;
+    uint8_t counter = WATER_HISTORY_BYTE(pSensor, frameSize - 1);
+    uint8_t slot;
+
+    /* The line is aligned, no matter to which sensor the frame belongs */
+    uint32_t skipped = pSensor->pendingCount - frameSize;
+    if (skipped != 0)
+    {
+        if (pSensor->synchronized)
+        {
+            pSensor->stats.syncLosses++;
+        }
+        pSensor->stats.bytesDiscarded += skipped;
+        pSensor->stats.resyncBytesLast = skipped;
+        if (skipped > pSensor->stats.resyncBytesMax)
+        {
+            pSensor->stats.resyncBytesMax = skipped;
+        }
+    }
+
+    pSensor->synchronized = true;
+    pSensor->pendingCount = 0;
+    pSensor->stats.framesReceived++;
+
+    WaterChannel_t* pChannel = waterSensorFindChannel(pSensor, frameSize, addressed, &slot);
+    if (pChannel == 0)
+    {
+        pSensor->stats.unknownProbeFrames++;
+        return;
+    }
+
+    for (uint32_t i = 0; i < sampleCount; i++)
+    {
+        uint32_t age = frameSize - 1 - valueOffset - 4 * i;
+
+        samples[i] = (int32_t)((uint32_t)WATER_HISTORY_BYTE(pSensor, age) |
+                               ((uint32_t)WATER_HISTORY_BYTE(pSensor, age - 1) << 8) |
+                               ((uint32_t)WATER_HISTORY_BYTE(pSensor, age - 2) << 16) |
+                               ((uint32_t)WATER_HISTORY_BYTE(pSensor, age - 3) << 24));
+
+        pChannel->filteredMicroVolt = filterEMA(&pChannel->filter, samples[i]);
+    }
+
+    /* The counter is only meaningful if the previous frame is not too old */
+    uint32_t lostFrames = 0;
+    if (pChannel->valid)
+    {
+        uint8_t expected = (uint8_t)(pChannel->counter + 1);
+        if (counter != expected)
+        {
+            lostFrames = (uint8_t)(counter - expected);
+            pChannel->counterErrors++;
+            pChannel->framesLost += lostFrames;
+            pSensor->stats.counterErrors++;
+            pSensor->stats.framesLost += lostFrames;
+        }
+    }
+
+    waterChannelUpdateLink(pChannel, lostFrames, pSensor->framePeriodUs, nowUs);
+
+    if (slot != WATER_BUS_NO_SLOT)
+    {
+        waterBusFrameReceived(pSensor->pBus, slot);
+    }
+
+    pChannel->counter = counter;
+    pChannel->microVolt = samples[sampleCount - 1];
+    pChannel->lastFrameUs = nowUs;
+    pChannel->valid = true;
+    pChannel->timedOut = false;
+    pChannel->framesReceived++;
+    pSensor->stats.samplesReceived += sampleCount;
+
+    if (pSensor->pSampleCallback != 0)
+    {
+        uint8_t probeId = addressed ? pSensor->pBus->pProbes[slot].id : WATER_PROBE_ID_NONE;
+        pSensor->pSampleCallback(probeId, samples, (uint8_t)sampleCount, nowUs);
+    }
+}
+
+/**
+ * @brief Resets the state of a sensor
+ *
+ * @param pChannel      State of the sensor
+ * @param nowUs         Current time in us (start of the timeout supervision)
+ */
+static void waterChannelInitialize(WaterChannel_t* pChannel, uint32_t nowUs)
+{
+    *pChannel = (WaterChannel_t){ 0 };
+    pChannel->lastFrameUs = nowUs;
+    filterInitEMA(&pChannel->filter, WATER_FILTER_SCALING, WATER_FILTER_ALPHA, true);
+}
+
+/**
+ * @brief Updates the link statistics with an accepted frame
+ *
+ * Has to be called before the time stamp of the previous frame is replaced.
+ *
+ * @param pChannel      State of the sensor
+ * @param lostFrames    Number of frames missing in front of this frame
+ * @param periodUs      Nominal frame interval in us
+ * @param nowUs         Arrival time of the frame in us
+ */
+static void waterChannelUpdateLink(WaterChannel_t* pChannel, uint32_t lostFrames, uint32_t periodUs, uint32_t nowUs)
+{
+    WaterLinkStats_t* pLink = &pChannel->link;
+
+    if (pChannel->framesReceived != 0)
+    {
+        uint32_t interval = nowUs - pChannel->lastFrameUs;
+        uint32_t bin = interval / WATER_LINK_BIN_WIDTH_US;
+
+        pLink->histogram[(bin < WATER_LINK_HISTOGRAM_BINS) ? bin : (WATER_LINK_HISTOGRAM_BINS - 1)]++;
+
+        /* Gaps caused by lost frames (or a timeout) are no jitter */
+        if (pChannel->valid && lostFrames == 0)
+        {
+            uint32_t jitter = (interval > periodUs) ? (interval - periodUs) : (periodUs - interval);
+
+            if (pLink->intervalCount == 0 || interval < pLink->intervalMinUs)
+            {
+                pLink->intervalMinUs = interval;
+            }
+            if (interval > pLink->intervalMaxUs)
+            {
+                pLink->intervalMaxUs = interval;
+            }
+            if (jitter > pLink->jitterMaxUs)
+            {
+                pLink->jitterMaxUs = jitter;
+            }
+
+            pLink->intervalCount++;
+            pLink->intervalSumUs += interval;
+            pLink->jitterSumUs += jitter;
+        }
+    }
+
+    pLink->blockExpected += lostFrames + 1;
+    pLink->blockLost += lostFrames;
+
+    if (pLink->blockExpected >= WATER_LINK_WINDOW_FRAMES)
+    {
+        pLink->lastBlockExpected = pLink->blockExpected;
+        pLink->lastBlockLost = pLink->blockLost;
+        pLink->lastBlockChecksumErrors = pLink->blockChecksumErrors;
+        pLink->blockExpected = 0;
+        pLink->blockLost = 0;
+        pLink->blockChecksumErrors = 0;
+    }
+}
+
+/**
+ * @brief Calculates a rate in ppm
+ *
+ * @param count         Number of events
+ * @param total         Number of opportunities
+ *
+ * @return count / total in ppm, 0 if total is 0
+ */
+static uint32_t waterSensorRatePpm(uint32_t count, uint32_t total)
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)count * 1000000U) / total);
+}
+
+/**
+ * @brief Removes a probe from the supervision list
+ *
+ * @param pBus          Probe table
+ * @param slot          Slot of the probe
+ */
+static void waterBusUnlink(WaterBus_t* pBus, uint8_t slot)
+{
+    WaterProbe_t* pProbe = &pBus->pProbes[slot];
+
+    if (pProbe->older != WATER_BUS_NO_SLOT)
+    {
+        pBus->pProbes[pProbe->older].newer = pProbe->newer;
+    }
+    else
+    {
+        pBus->oldest = pProbe->newer;
+    }
+
+    if (pProbe->newer != WATER_BUS_NO_SLOT)
+    {
+        pBus->pProbes[pProbe->newer].older = pProbe->older;
+    }
+    else
+    {
+        pBus->newest = pProbe->older;
+    }
+
+    pProbe->older = WATER_BUS_NO_SLOT;
+    pProbe->newer = WATER_BUS_NO_SLOT;
+}
+
+/**
+ * @brief Adds a probe as newest entry to the supervision list
+ *
+ * @param pBus          Probe table
+ * @param slot          Slot of the probe
+ */
+static void waterBusAppend(WaterBus_t* pBus, uint8_t slot)
+{
+    WaterProbe_t* pProbe = &pBus->pProbes[slot];
+
+    pProbe->older = pBus->newest;
+    pProbe->newer = WATER_BUS_NO_SLOT;
+
+    if (pBus->newest != WATER_BUS_NO_SLOT)
+    {
+        pBus->pProbes[pBus->newest].newer = slot;
+    }
+    else
+    {
+        pBus->oldest = slot;
+    }
+
+    pBus->newest = slot;
+}
+
+/**
+ * @brief Moves a probe with a new frame to the end of the supervision list
+ *
+ * Has to be called before the timeout flag of the probe is cleared.
+ *
+ * @param pBus          Probe table
+ * @param slot          Slot of the probe
+ */
+static void waterBusFrameReceived(WaterBus_t* pBus, uint8_t slot)
+{
+    if (pBus->pProbes[slot].channel.timedOut)
+    {
+        // Probe is back, it was removed from the list on the timeout
+        pBus->defectCount--;
+    }
+    else
+    {
+        waterBusUnlink(pBus, slot);
+    }
+
+    waterBusAppend(pBus, slot);
+}
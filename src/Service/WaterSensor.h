@@ -0,0 +1,462 @@
+/******************************************************************************
+ * @file WaterSensor.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the streaming decoder of the RadioConnect water
+ * level sensor frames
+ *
+ * Legacy frame layout (8 bytes, sent every 50 ms):
+ *
+ *  | 0       | 1..4                | 5..6            | 7        |
+ *  | counter | value [µV], LE      | 0xC0DE, LE      | checksum |
+ *
+ * Extended frame layout with N = 1..14 samples (4 * N + 4 bytes):
+ *
+ *  | 0       | 1..4N               | 4N+1..4N+2      | 4N+3     |
+ *  | counter | N values [µV], LE   | 0xC11N, LE      | checksum |
+ *
+ * Addressed frame layout for several probes on one line (4 * N + 5 bytes):
+ *
+ *  | 0       | 1        | 2..4N+1             | 4N+2..4N+3      | 4N+4     |
+ *  | counter | probe ID | N values [µV], LE   | 0xC12N, LE      | checksum |
+ *
+ * The reserved word of extended and addressed frames carries the format
+ * version (1 or 2) and the number of samples in its lowest byte. The
+ * samples are in chronological order. All formats can be mixed in one
+ * stream, legacy and extended frames belong to the unaddressed sensor,
+ * addressed frames to the probe with the given ID (see WaterBus_t).
+ *
+ * The checksum is the two's complement of the sum of all other bytes, so
+ * the sum of all bytes of a frame is 0 (mod 256). The counter increments
+ * with every frame and rolls over from 255 to 0.
+ *
+ *****************************************************************************/
+#ifndef _WATER_SENSOR_H_
+#define _WATER_SENSOR_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Filter/Filter.h"
+
+/***** CONSTANTS *************************************************************/
+#define WATER_FRAME_SIZE            8           //!< Size of a sensor frame in bytes
+#define WATER_FRAME_RESERVED        0xC0DE      //!< Value of the reserved word
+#define WATER_FRAME_PERIOD_US       50000       //!< Nominal interval of the sensor frames
+#define WATER_TIMEOUT_US            150000      //!< Maximum gap between two frames before the sensor is defect
+#define WATER_FRAME_WORDS           (WATER_FRAME_SIZE / 4)      //!< Size of a sensor frame in 32 bit words
+
+#define WATER_EXT_RESERVED_HIGH     0xC1        //!< Upper byte of the reserved word of an extended frame
+#define WATER_EXT_VERSION           0x10        //!< Version nibble of the reserved word of an extended frame
+#define WATER_ADDR_VERSION          0x20        //!< Version nibble of the reserved word of an addressed frame
+#define WATER_EXT_MAX_SAMPLES       14          //!< Maximum number of samples of an extended or addressed frame
+#define WATER_EXT_FRAME_SIZE(n)     (4 * (n) + 4)   //!< Size of an extended frame with n samples
+#define WATER_ADDR_FRAME_SIZE(n)    (4 * (n) + 5)   //!< Size of an addressed frame with n samples
+#define WATER_HISTORY_SIZE          64          //!< Received bytes kept by the decoder (power of 2, > largest frame)
+
+#define WATER_LINK_HISTOGRAM_BINS   16          //!< Number of bins of the inter-arrival histogram
+#define WATER_LINK_BIN_WIDTH_US     10000       //!< Width of a histogram bin (the last bin collects all longer intervals)
+#define WATER_LINK_WINDOW_FRAMES    200         //!< Expected frames per block of the rolling rates (10 s)
+
+#define WATER_FILTER_SCALING        1000        //!< Scaling factor of the EMA filter of the samples
+#define WATER_FILTER_ALPHA          200         //!< Filter constant of the EMA filter (0.2, scaled)
+
+#define WATER_PROBE_ID_NONE         0xFF        //!< ID of the unaddressed sensor (not allowed for probes)
+#define WATER_BUS_NO_SLOT           0xFF        //!< Marks an unused entry of the probe lookup table
+
+#define WATER_CM_MIN                50          //!< Lower end of the measurement range [cm]
+#define WATER_CM_MAX                1000        //!< Upper end of the measurement range [cm]
+#define WATER_MICROVOLT_MIN         500000      //!< Sensor voltage at WATER_CM_MIN [µV]
+#define WATER_MICROVOLT_MAX         2500000     //!< Sensor voltage at WATER_CM_MAX [µV]
+
+#define WATER_CM_WARNING            250         //!< Water level for a warning [cm]
+#define WATER_CM_EMERGENCY          300         //!< Water level for an emergency [cm]
+
+
+/***** MACROS ****************************************************************/
+#define WATER_ERR_OK                0           //!< No error occured
+#define WATER_ERR_INVALID_PARAM     -1          //!< Invalid parameter (Null Pointer)
+#define WATER_ERR_NO_DATA           -2          //!< No valid frame received yet
+#define WATER_ERR_TIMEOUT           -3          //!< No valid frame within WATER_TIMEOUT_US
+#define WATER_ERR_BUS_FULL          -4          //!< No free probe slot or probe ID already used
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Counters of the decoder (for all sensors on the line)
+ *
+ */
+typedef struct _WaterSensorStats_
+{
+    uint32_t framesReceived;        //!< Number of valid frames
+    uint32_t syncLosses;            //!< Number of times the frame alignment was lost (checksum or reserved word wrong)
+    uint32_t bytesDiscarded;        //!< Number of bytes skipped in front of valid frames
+    uint32_t counterErrors;         //!< Number of frames with an unexpected counter
+    uint32_t framesLost;            //!< Number of frames missing according to the counter
+    uint32_t unknownProbeFrames;    //!< Number of addressed frames of a probe which is not in the probe table
+    uint32_t resyncBytesLast;       //!< Bytes skipped before the last frame after a loss of the alignment
+    uint32_t resyncBytesMax;        //!< Maximum of resyncBytesLast
+    uint32_t checksumErrors;        //!< Number of frames with correct reserved word but wrong checksum
+    uint32_t samplesReceived;       //!< Number of samples of all valid frames
+} WaterSensorStats_t;
+
+/**
+ * @brief Timing and error counters of the radio link
+ *
+ * Updated with every accepted frame at constant cost. The rolling rates
+ * cover the current and the previous block of WATER_LINK_WINDOW_FRAMES
+ * expected frames.
+ */
+typedef struct _WaterLinkStats_
+{
+    uint32_t histogram[WATER_LINK_HISTOGRAM_BINS];  //!< Inter-arrival times of all consecutive accepted frames
+    uint32_t intervalCount;         //!< Number of intervals between frames without a counter gap
+    uint32_t intervalMinUs;         //!< Minimum of these intervals
+    uint32_t intervalMaxUs;         //!< Maximum of these intervals
+    uint64_t intervalSumUs;         //!< Sum of these intervals
+    uint64_t jitterSumUs;           //!< Sum of the deviations from the nominal frame period
+    uint32_t jitterMaxUs;           //!< Maximum deviation from the nominal frame period
+
+    uint32_t blockExpected;         //!< Expected frames (according to the counter) in the current block
+    uint32_t blockLost;             //!< Lost frames in the current block
+    uint32_t blockChecksumErrors;   //!< Checksum errors in the current block
+    uint32_t lastBlockExpected;     //!< Expected frames in the previous block
+    uint32_t lastBlockLost;         //!< Lost frames in the previous block
+    uint32_t lastBlockChecksumErrors;   //!< Checksum errors in the previous block
+} WaterLinkStats_t;
+
+/**
+ * @brief Summary of the link quality, derived from WaterLinkStats_t
+ *
+ */
+typedef struct _WaterLinkQuality_
+{
+    uint32_t intervalMinUs;         //!< Minimum inter-arrival time
+    uint32_t intervalMaxUs;         //!< Maximum inter-arrival time
+    uint32_t intervalMeanUs;        //!< Mean inter-arrival time
+    uint32_t jitterMeanUs;          //!< Mean deviation from the nominal frame period
+    uint32_t jitterMaxUs;           //!< Maximum deviation from the nominal frame period
+    uint32_t lossRatePpm;           //!< Rolling frame loss rate (counter gaps)
+    uint32_t checksumErrorRatePpm;  //!< Rolling checksum error rate
+} WaterLinkQuality_t;
+
+/**
+ * @brief Callback for the samples of a valid frame
+ *
+ * @param probeId       ID of the probe, WATER_PROBE_ID_NONE for the unaddressed sensor
+ * @param pMicroVolt    Samples of the frame [µV], oldest first
+ * @param count         Number of samples (1 for legacy frames)
+ * @param nowUs         Arrival time of the frame in us
+ */
+typedef void (*WaterSampleCallback)(uint8_t probeId, const int32_t* pMicroVolt, uint8_t count, uint32_t nowUs);
+
+/**
+ * @brief State of one sensor on the line (counter, timeout, filter, link)
+ *
+ */
+typedef struct _WaterChannel_
+{
+    bool valid;                     //!< At least one frame received and no timeout since
+    bool timedOut;                  //!< Timeout detected, sensor is defect until the next frame
+    uint8_t counter;                //!< Counter of the last valid frame
+    int32_t microVolt;              //!< Newest sample of the last valid frame [µV]
+    int32_t filteredMicroVolt;      //!< EMA filtered samples [µV]
+    EMAFilterData_t filter;         //!< State of the EMA filter
+    uint32_t lastFrameUs;           //!< Time stamp of the last valid frame (or of the initialization)
+    uint32_t framesReceived;        //!< Number of valid frames of this sensor
+    uint32_t counterErrors;         //!< Number of frames with an unexpected counter
+    uint32_t framesLost;            //!< Number of frames missing according to the counter
+    uint32_t timeouts;              //!< Number of detected timeouts
+    WaterLinkStats_t link;          //!< Timing and error counters of the radio link
+} WaterChannel_t;
+
+/**
+ * @brief Entry of the probe table
+ *
+ */
+typedef struct _WaterProbe_
+{
+    WaterChannel_t channel;         //!< State of the probe
+    uint8_t id;                     //!< ID of the probe (as sent in its frames)
+    uint8_t older;                  //!< Slot of the probe with the next older frame (WATER_BUS_NO_SLOT at the end)
+    uint8_t newer;                  //!< Slot of the probe with the next newer frame (WATER_BUS_NO_SLOT at the end)
+} WaterProbe_t;
+
+/**
+ * @brief Table of the addressed probes on one line (multi-drop)
+ *
+ * The probe of a frame is found with a lookup table indexed by the ID.
+ * The supervised probes are kept in a list ordered by the time of their
+ * last frame, so the timeout check only has to look at the oldest entry
+ * and its cost does not grow with the number of probes. Probes are
+ * removed from the list on a timeout and added again with their next frame.
+ */
+typedef struct _WaterBus_
+{
+    uint8_t slotOfId[256];          //!< Slot in pProbes per probe ID, WATER_BUS_NO_SLOT if unknown
+    WaterProbe_t* pProbes;          //!< Probe table (provided by the caller)
+    uint8_t probeCapacity;          //!< Number of entries of pProbes
+    uint8_t probeCount;             //!< Number of used entries of pProbes
+    uint8_t oldest;                 //!< Slot of the supervised probe with the oldest frame
+    uint8_t newest;                 //!< Slot of the supervised probe with the newest frame
+    uint8_t defectCount;            //!< Number of probes in timeout
+} WaterBus_t;
+
+/**
+ * @brief Instance of the water sensor decoder
+ *
+ * The last received bytes are kept together with the running sums of the
+ * stream. The reserved word in front of the newest byte gives the length
+ * of a candidate frame, the difference of two running sums its checksum.
+ * So every byte costs the same constant work and the decoder finds the
+ * frame alignment again right after a corruption.
+ */
+typedef struct _WaterSensor_
+{
+    uint8_t history[WATER_HISTORY_SIZE];    //!< Last received bytes (circular)
+    uint8_t prefixSum[WATER_HISTORY_SIZE];  //!< Running sum of the stream up to the byte in history (mod 256)
+    uint8_t historyIndex;           //!< Position of the next byte in history
+    uint8_t streamSum;              //!< Running sum of all received bytes (mod 256)
+    uint32_t pendingCount;          //!< Number of bytes received since the last frame
+    bool synchronized;              //!< Last frame was valid and no bytes have been skipped since
+    uint32_t framePeriodUs;         //!< Nominal frame interval for the jitter statistics
+    WaterSampleCallback pSampleCallback;    //!< Receives the samples of every valid frame (can be 0)
+    WaterBus_t* pBus;               //!< Probe table for addressed frames (can be 0)
+
+    WaterSensorStats_t stats;       //!< Counters of the decoder
+    WaterChannel_t channel;         //!< State of the unaddressed sensor (legacy and extended frames)
+} WaterSensor_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes a decoder instance
+ *
+ * @param pSensor       Decoder instance
+ * @param nowUs         Current time in us (start of the timeout supervision)
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterSensorInitialize(WaterSensor_t* pSensor, uint32_t nowUs);
+
+/**
+ * @brief Sets the callback for the samples of the valid frames
+ *
+ * Needed for extended frames, waterSensorGetValue() only returns the newest
+ * sample.
+ *
+ * @param pSensor       Decoder instance
+ * @param pCallback     Callback function, 0 removes the callback
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterSensorSetSampleCallback(WaterSensor_t* pSensor, WaterSampleCallback pCallback);
+
+/**
+ * @brief Sets the nominal frame interval used for the jitter statistics
+ *
+ * @param pSensor       Decoder instance
+ * @param periodUs      Nominal interval in us (WATER_FRAME_PERIOD_US after initialization)
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterSensorSetFramePeriod(WaterSensor_t* pSensor, uint32_t periodUs);
+
+/**
+ * @brief Attaches the probe table for addressed frames
+ *
+ * @param pSensor       Decoder instance
+ * @param pBus          Initialized probe table, 0 to detach it
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterSensorAttachBus(WaterSensor_t* pSensor, WaterBus_t* pBus);
+
+/**
+ * @brief Feeds one received byte into the decoder
+ *
+ * Takes a constant, small number of operations, so it may be called from
+ * the UART RX interrupt. The time stamp of the byte completing a frame is
+ * the arrival time of the frame for the link statistics, so the decoder
+ * should be fed right after the reception for meaningful jitter values.
+ *
+ * @param pSensor       Decoder instance
+ * @param data          Received byte
+ * @param nowUs         Current time in us
+ *
+ * @return true if the byte completed a valid frame
+ */
+bool waterSensorProcessByte(WaterSensor_t* pSensor, uint8_t data, uint32_t nowUs);
+
+/**
+ * @brief Feeds a block of received bytes into the decoder
+ *
+ * Intended for the blocks published by the UART RX DMA.
+ *
+ * @param pSensor       Decoder instance
+ * @param pData         Received bytes
+ * @param length        Number of bytes
+ * @param nowUs         Current time in us
+ *
+ * @return Number of valid frames completed by the bytes
+ */
+int32_t waterSensorProcess(WaterSensor_t* pSensor, const uint8_t* pData, int32_t length, uint32_t nowUs);
+
+/**
+ * @brief Checks checksum and reserved word of a single, aligned legacy frame
+ *
+ * Byte-wise reference for waterSensorValidateFrames().
+ *
+ * @param pFrame        Frame (WATER_FRAME_SIZE bytes)
+ *
+ * @return true if the frame is valid
+ */
+bool waterSensorCheckFrame(const uint8_t* pFrame);
+
+/**
+ * @brief Checks checksum and reserved word of a batch of aligned legacy frames
+ *
+ * Intended for frames which are received back to back into a DMA buffer.
+ * The frames are processed word-wise (with the USADA8 instruction on the
+ * Cortex-M4, with a SIMD-within-a-register fallback elsewhere) and give
+ * the same verdict as waterSensorCheckFrame(). Counter and timeout are not
+ * handled, valid frames still have to be passed to waterSensorProcess().
+ *
+ * @param pFrames       Frames, word aligned, WATER_FRAME_WORDS words per frame
+ * @param frameCount    Number of frames
+ * @param pValid        Array of frameCount flags to store the verdicts to (may be 0)
+ *
+ * @return Number of valid frames, WATER_ERR_INVALID_PARAM on a Null Pointer
+ */
+int32_t waterSensorValidateFrames(const uint32_t* pFrames, int32_t frameCount, bool* pValid);
+
+/**
+ * @brief Checks the frame timeout of the unaddressed sensor, has to be
+ * called cyclically (e.g. every 10 ms)
+ *
+ * @param pSensor       Decoder instance
+ * @param nowUs         Current time in us
+ *
+ * @return WATER_ERR_OK, WATER_ERR_NO_DATA or WATER_ERR_TIMEOUT
+ */
+int32_t waterSensorCheckTimeout(WaterSensor_t* pSensor, uint32_t nowUs);
+
+/**
+ * @brief Calculates the link quality summary of the unaddressed sensor
+ *
+ * @param pSensor       Decoder instance
+ * @param pQuality      Pointer to store the summary to
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterSensorGetLinkQuality(const WaterSensor_t* pSensor, WaterLinkQuality_t* pQuality);
+
+/**
+ * @brief Returns the value of the last valid frame of the unaddressed sensor
+ *
+ * @param pSensor       Decoder instance
+ * @param pMicroVolt    Pointer to store the value [µV] to
+ *
+ * @return WATER_ERR_OK, WATER_ERR_NO_DATA or WATER_ERR_TIMEOUT (value is only
+ * written on WATER_ERR_OK)
+ */
+int32_t waterSensorGetValue(const WaterSensor_t* pSensor, int32_t* pMicroVolt);
+
+/**
+ * @brief Returns the newest and the filtered value of a sensor
+ *
+ * @param pChannel          State of the sensor
+ * @param pMicroVolt        Pointer to store the newest sample [µV] to (can be 0)
+ * @param pFilteredMicroVolt    Pointer to store the filtered value [µV] to (can be 0)
+ *
+ * @return WATER_ERR_OK, WATER_ERR_NO_DATA or WATER_ERR_TIMEOUT (values are
+ * only written on WATER_ERR_OK)
+ */
+int32_t waterChannelGetValue(const WaterChannel_t* pChannel, int32_t* pMicroVolt, int32_t* pFilteredMicroVolt);
+
+/**
+ * @brief Converts a sensor voltage to the corresponding water level
+ *
+ * @param microVolt     Sensor voltage in µV (limited to the valid range)
+ *
+ * @return Water level in cm (rounded)
+ */
+int32_t waterSensorMicroVoltToCm(int32_t microVolt);
+
+/**
+ * @brief Calculates the link quality summary of a sensor
+ *
+ * @param pChannel      State of the sensor
+ * @param pQuality      Pointer to store the summary to
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterChannelGetLinkQuality(const WaterChannel_t* pChannel, WaterLinkQuality_t* pQuality);
+
+/**
+ * @brief Calculates the link quality summary from link statistics, e.g. from
+ * a copy taken while the decoder could not update them
+ *
+ * @param pLink         Link statistics of a sensor
+ * @param pQuality      Pointer to store the summary to
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterLinkGetQuality(const WaterLinkStats_t* pLink, WaterLinkQuality_t* pQuality);
+
+/**
+ * @brief Initializes an empty probe table
+ *
+ * @param pBus          Probe table
+ * @param pProbes       Memory for the probes
+ * @param capacity      Number of entries of pProbes (at most 255)
+ *
+ * @return Returns WATER_ERR_OK if no error occured, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterBusInitialize(WaterBus_t* pBus, WaterProbe_t* pProbes, uint32_t capacity);
+
+/**
+ * @brief Adds a probe to the table and starts its timeout supervision
+ *
+ * @param pBus          Probe table
+ * @param id            ID of the probe (0..254)
+ * @param nowUs         Current time in us
+ *
+ * @return Returns WATER_ERR_OK if no error occured, WATER_ERR_BUS_FULL if
+ * the table is full or the ID is already used, otherwise WATER_ERR_INVALID_PARAM
+ */
+int32_t waterBusAddProbe(WaterBus_t* pBus, uint8_t id, uint32_t nowUs);
+
+/**
+ * @brief Checks the frame timeout of all probes, has to be called
+ * cyclically (e.g. every 10 ms)
+ *
+ * Only the probes which time out in this call are visited.
+ *
+ * @param pBus          Probe table
+ * @param nowUs         Current time in us
+ *
+ * @return Number of probes in timeout, or WATER_ERR_INVALID_PARAM
+ */
+int32_t waterBusCheckTimeouts(WaterBus_t* pBus, uint32_t nowUs);
+
+/**
+ * @brief Returns the state of a probe
+ *
+ * @param pBus          Probe table
+ * @param id            ID of the probe
+ *
+ * @return State of the probe, 0 if the ID is not in the table
+ */
+const WaterChannel_t* waterBusGetChannel(const WaterBus_t* pBus, uint8_t id);
+
+#endif
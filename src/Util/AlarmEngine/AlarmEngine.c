@@ -0,0 +1,158 @@
+/******************************************************************************
+ * @file AlarmEngine.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the time-over-threshold alarm engine
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "AlarmEngine.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void alarmRuleReset(AlarmRule_t* pRule);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t alarmEngineInitialize(AlarmEngine_t* pEngine, AlarmRule_t* pRules, int32_t ruleCount, AlarmPostEventFunction pPostEvent)
+{
+    // Check for valid pointer
+    if (pEngine == 0 || (pRules == 0 && ruleCount > 0))
+        return ALARM_ERR_INVALID_PTR;
+
+    if (ruleCount < 0)
+        return ALARM_ERR_INVALID_PARAM;
+
+    for (int32_t i=0; i<ruleCount; i++)
+    {
+        if (pRules[i].hysteresis < 0)
+            return ALARM_ERR_INVALID_PARAM;
+
+        alarmRuleReset(&pRules[i]);
+    }
+
+    pEngine->pRules         = pRules;
+    pEngine->ruleCount      = ruleCount;
+    pEngine->pPostEvent     = pPostEvent;
+
+    return ALARM_ERR_OK;
+}
+
+int32_t alarmEngineUpdate(AlarmEngine_t* pEngine, int32_t signalID, int32_t value, uint32_t nowMs)
+{
+    // Check for valid pointer
+    if (pEngine == 0)
+        return ALARM_ERR_INVALID_PTR;
+
+    int32_t activeCount = 0;
+
+    for (int32_t i=0; i<pEngine->ruleCount; i++)
+    {
+        AlarmRule_t* pRule = &(pEngine->pRules[i]);
+
+        if (pRule->signalID != signalID)
+            continue;
+
+        if (value > pRule->threshold)
+        {
+            if (!pRule->exceeded)
+            {
+                pRule->exceeded = true;
+                pRule->exceededSinceMs = nowMs;
+            }
+        }
+        else if ((int64_t)value <= (int64_t)pRule->threshold - pRule->hysteresis)
+        {
+            // 64 bit, so a large hysteresis can not wrap around
+            alarmRuleReset(pRule);
+        }
+
+        // Unsigned difference, so the wrap around of the time stamp does not matter
+        if (pRule->exceeded && !pRule->active && (uint32_t)(nowMs - pRule->exceededSinceMs) >= pRule->holdTimeMs)
+        {
+            pRule->active = true;
+        }
+
+        if (pRule->active)
+        {
+            // Retry until the event is accepted (e.g. another event is still pending)
+            if (!pRule->eventPosted && pEngine->pPostEvent != 0)
+            {
+                pRule->eventPosted = (pEngine->pPostEvent(pRule->eventID) == 0);
+            }
+
+            activeCount++;
+        }
+    }
+
+    return activeCount;
+}
+
+int32_t alarmEngineResetSignal(AlarmEngine_t* pEngine, int32_t signalID)
+{
+    // Check for valid pointer
+    if (pEngine == 0)
+        return ALARM_ERR_INVALID_PTR;
+
+    for (int32_t i=0; i<pEngine->ruleCount; i++)
+    {
+        if (pEngine->pRules[i].signalID == signalID)
+        {
+            alarmRuleReset(&(pEngine->pRules[i]));
+        }
+    }
+
+    return ALARM_ERR_OK;
+}
+
+bool alarmEngineIsActive(const AlarmEngine_t* pEngine, int32_t eventID)
+{
+    if (pEngine == 0)
+        return false;
+
+    for (int32_t i=0; i<pEngine->ruleCount; i++)
+    {
+        if (pEngine->pRules[i].eventID == eventID && pEngine->pRules[i].active)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Resets the dynamic fields of a rule
+ *
+ * @param pRule         Pointer to the rule
+ */
+static void alarmRuleReset(AlarmRule_t* pRule)
+{
+    pRule->exceeded = false;
+    pRule->exceededSinceMs = 0;
+    pRule->active = false;
+    pRule->eventPosted = false;
+}
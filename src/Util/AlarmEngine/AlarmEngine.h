@@ -0,0 +1,129 @@
+/******************************************************************************
+ * @file AlarmEngine.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the time-over-threshold alarm engine
+ *
+ * The alarms are defined by a rule table. Each rule watches one signal and
+ * posts its event as soon as the signal stayed above the threshold for the
+ * hold time. The condition ends when the signal drops to the threshold
+ * minus the hysteresis, short dips within the hysteresis do not restart
+ * the hold time.
+ *
+ * Every new sample of a signal updates all rules of this signal
+ * incrementally (only the time stamp of the first exceeding sample is
+ * kept), so new signals and rules only need new table entries.
+ *
+ *****************************************************************************/
+#ifndef _ALARM_ENGINE_H_
+#define _ALARM_ENGINE_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define ALARM_ERR_OK                        0       //!< No error occured
+#define ALARM_ERR_INVALID_PTR               -1      //!< Invalid pointer (null pointer)
+#define ALARM_ERR_INVALID_PARAM             -2      //!< Invalid rule parameter (e.g. negative hysteresis)
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Function pointer to post the event of an alarm (e.g. sameplAppSendEvent)
+ *
+ * Returns 0 if the event has been accepted, otherwise the event is posted
+ * again with the next sample of the signal.
+ */
+typedef int32_t (*AlarmPostEventFunction)(int32_t eventID);
+
+/**
+ * @brief Struct to represent a rule of the alarm table
+ *
+ */
+typedef struct _AlarmRule
+{
+    // Static fields used for the rule configuration
+    int32_t signalID;                       //!< ID of the signal the rule watches
+    int32_t threshold;                      //!< The condition starts with a value above the threshold
+    uint32_t holdTimeMs;                    //!< Time the condition has to last until the alarm is active [ms]
+    int32_t hysteresis;                     //!< The condition ends with a value at or below threshold - hysteresis
+    int32_t eventID;                        //!< Event which is posted when the alarm becomes active
+
+    // Dynamic fields used during runtime
+    bool exceeded;                          //!< Condition is fulfilled
+    uint32_t exceededSinceMs;               //!< Time stamp of the sample which started the condition [ms]
+    bool active;                            //!< Hold time has elapsed, alarm is active
+    bool eventPosted;                       //!< Event of the active alarm has been accepted
+} AlarmRule_t;
+
+/**
+ * @brief Struct which represents an alarm engine with its rule table
+ *
+ */
+typedef struct _AlarmEngine
+{
+    int32_t ruleCount;                      //!< Number of rules in the table
+    AlarmRule_t* pRules;                    //!< Array of rules
+    AlarmPostEventFunction pPostEvent;      //!< Function to post the events (can be 0)
+} AlarmEngine_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes the alarm engine with the rule table and resets all rules
+ *
+ * @param pEngine           Pointer to the alarm engine instance
+ * @param pRules            Pointer to the rule table
+ * @param ruleCount         Number of rules in the table
+ * @param pPostEvent        Function to post the events of the alarms (can be 0)
+ *
+ * @return Returns ALARM_ERR_OK if no error occured
+ */
+int32_t alarmEngineInitialize(AlarmEngine_t* pEngine, AlarmRule_t* pRules, int32_t ruleCount, AlarmPostEventFunction pPostEvent);
+
+/**
+ * @brief Updates all rules of a signal with a new sample
+ *
+ * @param pEngine           Pointer to the alarm engine instance
+ * @param signalID          ID of the signal
+ * @param value             New value of the signal
+ * @param nowMs             Time stamp of the sample [ms] (wraps around)
+ *
+ * @return Number of active alarms of the signal, or ALARM_ERR_INVALID_PTR
+ */
+int32_t alarmEngineUpdate(AlarmEngine_t* pEngine, int32_t signalID, int32_t value, uint32_t nowMs);
+
+/**
+ * @brief Resets all rules of a signal, e.g. if its sensor is defect
+ *
+ * @param pEngine           Pointer to the alarm engine instance
+ * @param signalID          ID of the signal
+ *
+ * @return Returns ALARM_ERR_OK if no error occured
+ */
+int32_t alarmEngineResetSignal(AlarmEngine_t* pEngine, int32_t signalID);
+
+/**
+ * @brief Checks whether an alarm with the given event is active
+ *
+ * @param pEngine           Pointer to the alarm engine instance
+ * @param eventID           Event of the alarm
+ *
+ * @return true if at least one rule with this event is active
+ */
+bool alarmEngineIsActive(const AlarmEngine_t* pEngine, int32_t eventID);
+
+#endif
@@ -35,15 +35,81 @@
 
 int32_t filterInitEMA(EMAFilterData_t* pEMA, int32_t scalingFactor, int32_t alpha, bool resetFilter)
 {
-    return 0;
+    if (pEMA == 0)
+    {
+        return FILTER_ERR_INVALID_PTR;
+    }
+
+    if (scalingFactor <= 0 || alpha <= 0 || alpha > scalingFactor)
+    {
+        return FILTER_ERR_INVALID_PARAM;
+    }
+
+    pEMA->scalingFactor = scalingFactor;
+    pEMA->scalingShift = -1;
+    pEMA->alpha = alpha;
+
+    if ((scalingFactor & (scalingFactor - 1)) == 0)
+    {
+        pEMA->scalingShift = 0;
+        while ((1 << pEMA->scalingShift) < scalingFactor)
+        {
+            pEMA->scalingShift++;
+        }
+    }
+
+    if (resetFilter)
+    {
+        return filterResetEMA(pEMA);
+    }
+
+    return FILTER_ERR_OK;
 }
 
 int32_t filterResetEMA(EMAFilterData_t* pEMA)
 {
-    return 0;
+    if (pEMA == 0)
+    {
+        return FILTER_ERR_INVALID_PTR;
+    }
+
+    pEMA->firstValueAvailable = false;
+    pEMA->previousValue = 0;
+
+    return FILTER_ERR_OK;
 }
 
 int32_t filterEMA(EMAFilterData_t* pEMA, int32_t sensorValue)
 {
-    return 0;
+    if (pEMA == 0 || pEMA->scalingFactor <= 0)
+    {
+        return sensorValue;
+    }
+
+    // The first value initializes the filter, otherwise the output would
+    // start at 0 and settle only slowly
+    if (!pEMA->firstValueAvailable)
+    {
+        pEMA->firstValueAvailable = true;
+        pEMA->previousValue = sensorValue;
+        return sensorValue;
+    }
+
+    // y[n] = y[n-1] + alpha * (x[n] - y[n-1]), 64 bit to avoid an overflow of the product
+    int64_t delta = (int64_t)sensorValue - pEMA->previousValue;
+    int64_t product = delta * pEMA->alpha;
+
+    if (pEMA->scalingShift >= 0)
+    {
+        // Shift the magnitude, so the result is truncated towards 0 like the division
+        product = (product < 0) ? -((-product) >> pEMA->scalingShift) : (product >> pEMA->scalingShift);
+    }
+    else
+    {
+        product /= pEMA->scalingFactor;
+    }
+
+    pEMA->previousValue += (int32_t)product;
+
+    return pEMA->previousValue;
 }
\ No newline at end of file
@@ -40,6 +40,7 @@ typedef struct _EMAFilterData
     int32_t alpha;                              //!< Alpha value (filter constant) as scaled value
     int32_t previousValue;                      //!< Previous value of the filter output
     int32_t scalingFactor;                      //!< Used scaling factor
+    int32_t scalingShift;                       //!< log2 of the scaling factor if it is a power of 2, otherwise -1
 } EMAFilterData_t;
 
 
@@ -54,6 +55,9 @@ typedef struct _EMAFilterData
  * @param alpha             Already scaled alpha factor (must be scaled with same scaling factor as supplied via parameter)
  * @param resetFilter       Flag to indicate whether the filter should be reset
  *
+ * A scaling factor which is a power of 2 replaces the division of every
+ * filter step by a shift (same result).
+ *
  * @return Return FILTER_ERR_OK is no error occured
  */
 int32_t filterInitEMA(EMAFilterData_t* pEMA, int32_t scalingFactor, int32_t alpha, bool resetFilter);
@@ -71,6 +75,9 @@ int32_t filterResetEMA(EMAFilterData_t* pEMA);
 /**
  * @brief Performs the EMA filtering on the provided sensor value
  *
+ * y[n] = y[n-1] + alpha / scalingFactor * (x[n] - y[n-1]), the first value
+ * after a reset is passed through unfiltered.
+ *
  * @param pEMA              Pointer to the EMA filter struct
  * @param sensorValue       Value which should be filtered
  *
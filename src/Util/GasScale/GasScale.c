@@ -0,0 +1,98 @@
+/******************************************************************************
+ * @file GasScale.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the gas sensor scaling library
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "GasScale.h"
+#include "ADCModule.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define GAS_PPM_SPAN            (GAS_PPM_MAX - GAS_PPM_MIN)                 //!< Span of the measurement range [ppm]
+#define GAS_MICROVOLT_SPAN      (GAS_MICROVOLT_MAX - GAS_MICROVOLT_MIN)     //!< Span of the sensor voltage [µV]
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t gasScalePpmToMicroVolt(int32_t ppm)
+{
+    if (ppm < GAS_PPM_MIN)
+    {
+        ppm = GAS_PPM_MIN;
+    }
+    else if (ppm > GAS_PPM_MAX)
+    {
+        ppm = GAS_PPM_MAX;
+    }
+
+    /* 64 bit intermediate result: 9800ppm * 2000000µV exceeds 32 bit */
+    int64_t scaled = (int64_t)(ppm - GAS_PPM_MIN) * GAS_MICROVOLT_SPAN;
+
+    return GAS_MICROVOLT_MIN + (int32_t)((scaled + GAS_PPM_SPAN / 2) / GAS_PPM_SPAN);
+}
+
+int32_t gasScaleMicroVoltToPpm(int32_t microVolt)
+{
+    if (microVolt < GAS_MICROVOLT_MIN)
+    {
+        microVolt = GAS_MICROVOLT_MIN;
+    }
+    else if (microVolt > GAS_MICROVOLT_MAX)
+    {
+        microVolt = GAS_MICROVOLT_MAX;
+    }
+
+    int64_t scaled = (int64_t)(microVolt - GAS_MICROVOLT_MIN) * GAS_PPM_SPAN;
+
+    return GAS_PPM_MIN + (int32_t)((scaled + GAS_MICROVOLT_SPAN / 2) / GAS_MICROVOLT_SPAN);
+}
+
+bool gasScaleIsValid(int32_t microVolt)
+{
+    return (microVolt >= GAS_MICROVOLT_MIN) && (microVolt <= GAS_MICROVOLT_MAX);
+}
+
+int32_t gasScaleMicroVoltToDacDigits(int32_t microVolt)
+{
+    if (microVolt < 0)
+    {
+        return 0;
+    }
+
+    /* 64 bit intermediate result: the rounding offset overflows near INT32_MAX */
+    int64_t digits = ((int64_t)microVolt + ADC_MICROVOLTS_PER_DIGIT / 2) / ADC_MICROVOLTS_PER_DIGIT;
+
+    if (digits > GAS_DAC_MAX_DIGITS)
+    {
+        digits = GAS_DAC_MAX_DIGITS;
+    }
+
+    return (int32_t)digits;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * @file GasScale.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the gas sensor scaling library
+ *
+ * The gas sensor maps 200ppm..10000ppm linearly to 0.5V..2.5V. The library
+ * has no hardware dependencies and can therefore also be built on a host.
+ *
+ *****************************************************************************/
+#ifndef _GAS_SCALE_H_
+#define _GAS_SCALE_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define GAS_PPM_MIN                     200         //!< Lower end of the measurement range [ppm]
+#define GAS_PPM_MAX                     10000       //!< Upper end of the measurement range [ppm]
+#define GAS_MICROVOLT_MIN               500000      //!< Sensor voltage at GAS_PPM_MIN [µV]
+#define GAS_MICROVOLT_MAX               2500000     //!< Sensor voltage at GAS_PPM_MAX [µV]
+
+#define GAS_PPM_WARNING                 3000        //!< Gas concentration for a warning [ppm]
+#define GAS_PPM_EMERGENCY               5000        //!< Gas concentration for an emergency [ppm]
+
+#define GAS_DAC_MAX_DIGITS              4095        //!< Maximum value of the 12 bit threshold DAC
+
+
+/***** TYPES *****************************************************************/
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Converts a gas concentration to the corresponding sensor voltage
+ *
+ * @param ppm               Gas concentration in ppm (limited to the measurement range)
+ *
+ * @return Sensor voltage in µV (rounded)
+ */
+int32_t gasScalePpmToMicroVolt(int32_t ppm);
+
+/**
+ * @brief Converts a sensor voltage to the corresponding gas concentration
+ *
+ * @param microVolt         Sensor voltage in µV (limited to the valid range)
+ *
+ * @return Gas concentration in ppm (rounded)
+ */
+int32_t gasScaleMicroVoltToPpm(int32_t microVolt);
+
+/**
+ * @brief Checks whether a sensor voltage is inside the valid range. A voltage
+ * outside of the range indicates a sensor defect.
+ *
+ * @param microVolt         Sensor voltage in µV
+ *
+ * @return Returns true if the voltage is valid
+ */
+bool gasScaleIsValid(int32_t microVolt);
+
+/**
+ * @brief Converts a sensor voltage to the DAC value of the comparator
+ * threshold. The DAC uses the same 3.3 V reference and resolution as the
+ * ADC, so the conversion uses ADC_MICROVOLTS_PER_DIGIT.
+ *
+ * @param microVolt         Sensor voltage in µV
+ *
+ * @return DAC value in digits (rounded, limited to 0..GAS_DAC_MAX_DIGITS)
+ */
+int32_t gasScaleMicroVoltToDacDigits(int32_t microVolt);
+
+#endif
@@ -19,6 +19,7 @@
 #include <string.h>
 
 #include "Util/Log/printf.h"
+#include "Util/Log/LogOutput.h"
 
 #include "stm32g4xx_hal.h"
 #include "UARTModule.h"
@@ -47,14 +48,21 @@ static int internalFormattedOutput(const char* format, va_list va);
  */
 static char gOutputBuffer[MAX_OUTPUT_BUFFER];
 
+static LogWriter gWriter = uartWriteDebug;    //!< Function used to write the log output
+
 
 /***** PUBLIC FUNCTIONS ******************************************************/
 
+void outputSetWriter(LogWriter pWriter)
+{
+    gWriter = (pWriter != 0) ? pWriter : uartWriteDebug;
+}
+
 void outputLog(const char* msg)
 {
     // Send buffer to UART
     int32_t bufferLength = strlen(msg);
-    uartSendData((uint8_t*)msg, bufferLength);
+    gWriter((uint8_t*)msg, bufferLength);
 }
 
 
@@ -91,7 +99,7 @@ static int internalFormattedOutput(const char* format, va_list va)
 
     if (ret > 0 && ret <= MAX_OUTPUT_BUFFER)
     {
-        uartSendData((uint8_t*)gOutputBuffer, ret);
+        gWriter((uint8_t*)gOutputBuffer, ret);
     }
 
     return ret;
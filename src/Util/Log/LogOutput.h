@@ -16,6 +16,7 @@
 #define _LOG_OUTPUT_H_
 
 /***** INCLUDES **************************************************************/
+#include <stdint.h>
 
 
 /***** CONSTANTS *************************************************************/
@@ -26,9 +27,22 @@
 
 /***** TYPES *****************************************************************/
 
+/**
+ * @brief Function pointer to write the log output (e.g. uartWriteDebug)
+ *
+ */
+typedef int32_t (*LogWriter)(uint8_t* pData, int32_t length);
+
 
 /***** PROTOTYPES ************************************************************/
 
+/**
+ * @brief Sets the function used to write the log output
+ *
+ * @param pWriter Writer for the log output, 0 restores the default (uartWriteDebug)
+ */
+void outputSetWriter(LogWriter pWriter);
+
 /**
  * @brief Outputs a simple string message to the UART output
  *
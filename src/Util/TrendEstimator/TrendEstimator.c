@@ -0,0 +1,263 @@
+/******************************************************************************
+ * @file TrendEstimator.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the trend estimator with early warning
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "TrendEstimator.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int64_t trendNumerator(const TrendEstimator_t* pTrend);
+static bool trendPredictCrossing(const TrendEstimator_t* pTrend);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t trendInitialize(TrendEstimator_t* pTrend, int32_t* pWindow, int32_t windowSize, uint32_t samplePeriodMs)
+{
+    // Check for valid pointer
+    if (pTrend == 0 || pWindow == 0)
+        return TREND_ERR_INVALID_PTR;
+
+    if (windowSize < TREND_MIN_WINDOW || windowSize > TREND_MAX_WINDOW || samplePeriodMs == 0)
+        return TREND_ERR_INVALID_PARAM;
+
+    *pTrend = (TrendEstimator_t){ 0 };
+
+    int64_t n = windowSize;
+
+    pTrend->pWindow         = pWindow;
+    pTrend->windowSize      = windowSize;
+    pTrend->samplePeriodMs  = samplePeriodMs;
+
+    // Sum(x) = N(N-1)/2, Sum(x^2) = N(N-1)(2N-1)/6, N * Sum(x^2) - Sum(x)^2 = N^2(N^2-1)/12
+    pTrend->sumX            = n * (n - 1) / 2;
+    pTrend->denominator     = n * n * (n * n - 1) / 12;
+
+    return TREND_ERR_OK;
+}
+
+int32_t trendSetEarlyWarning(TrendEstimator_t* pTrend, int32_t threshold, uint32_t horizonMs, int32_t eventID, TrendPostEventFunction pPostEvent)
+{
+    // Check for valid pointer
+    if (pTrend == 0 || pTrend->samplePeriodMs == 0)
+        return TREND_ERR_INVALID_PTR;
+
+    uint32_t horizon = horizonMs / pTrend->samplePeriodMs;
+
+    if (horizon > TREND_MAX_HORIZON)
+        return TREND_ERR_INVALID_PARAM;
+
+    pTrend->threshold       = threshold;
+    pTrend->horizon         = (int32_t)horizon;
+    pTrend->eventID         = eventID;
+    pTrend->pPostEvent      = pPostEvent;
+    pTrend->warningActive   = false;
+    pTrend->eventPosted     = false;
+
+    return TREND_ERR_OK;
+}
+
+int32_t trendReset(TrendEstimator_t* pTrend)
+{
+    // Check for valid pointer
+    if (pTrend == 0)
+        return TREND_ERR_INVALID_PTR;
+
+    pTrend->count           = 0;
+    pTrend->index           = 0;
+    pTrend->sumY            = 0;
+    pTrend->sumXY           = 0;
+    pTrend->lastValue       = 0;
+    pTrend->warningActive   = false;
+    pTrend->eventPosted     = false;
+
+    return TREND_ERR_OK;
+}
+
+int32_t trendUpdate(TrendEstimator_t* pTrend, int32_t value)
+{
+    // Check for valid pointer
+    if (pTrend == 0 || pTrend->pWindow == 0)
+        return TREND_ERR_INVALID_PTR;
+
+    if (pTrend->count < pTrend->windowSize)
+    {
+        // Window not full yet, the new sample gets the next position
+        pTrend->sumXY += (int64_t)pTrend->count * value;
+        pTrend->sumY += value;
+        pTrend->pWindow[pTrend->count] = value;
+        pTrend->count++;
+    }
+    else
+    {
+        // The oldest sample leaves the window, the others move one position
+        // towards the start and the new sample takes the last position
+        pTrend->sumY -= pTrend->pWindow[pTrend->index];
+        pTrend->sumXY -= pTrend->sumY;
+        pTrend->sumXY += (int64_t)(pTrend->windowSize - 1) * value;
+        pTrend->sumY += value;
+
+        pTrend->pWindow[pTrend->index] = value;
+        pTrend->index++;
+        if (pTrend->index >= pTrend->windowSize)
+        {
+            pTrend->index = 0;
+        }
+    }
+
+    pTrend->lastValue = value;
+
+    if (pTrend->count < pTrend->windowSize)
+        return TREND_ERR_NO_DATA;
+
+    if (pTrend->horizon > 0)
+    {
+        bool warning = (value >= pTrend->threshold) || trendPredictCrossing(pTrend);
+
+        if (!warning)
+        {
+            pTrend->eventPosted = false;
+        }
+        else if (!pTrend->eventPosted && pTrend->pPostEvent != 0)
+        {
+            // Retry until the event is accepted (e.g. another event is still pending)
+            pTrend->eventPosted = (pTrend->pPostEvent(pTrend->eventID) == 0);
+        }
+
+        pTrend->warningActive = warning;
+    }
+
+    return TREND_ERR_OK;
+}
+
+int32_t trendGetSlope(const TrendEstimator_t* pTrend, int32_t* pMilliPerSecond)
+{
+    // Check for valid pointer
+    if (pTrend == 0 || pMilliPerSecond == 0)
+        return TREND_ERR_INVALID_PTR;
+
+    if (pTrend->count < pTrend->windowSize)
+        return TREND_ERR_NO_DATA;
+
+    // slope per sample = numerator / denominator, scaled by 1000 and by 1000ms / period
+    int64_t slope = (trendNumerator(pTrend) * 1000) / pTrend->denominator;
+
+    // Scale to seconds only within the 32 bit range (otherwise limited anyway),
+    // so the multiplication can not overflow
+    if (slope >= INT32_MIN && slope <= INT32_MAX)
+    {
+        slope = (slope * 1000) / (int64_t)pTrend->samplePeriodMs;
+    }
+
+    if (slope > INT32_MAX)
+    {
+        slope = INT32_MAX;
+    }
+    else if (slope < INT32_MIN)
+    {
+        slope = INT32_MIN;
+    }
+
+    *pMilliPerSecond = (int32_t)slope;
+
+    return TREND_ERR_OK;
+}
+
+int32_t trendGetTimeToThreshold(const TrendEstimator_t* pTrend, int32_t threshold, uint32_t* pTimeMs)
+{
+    // Check for valid pointer
+    if (pTrend == 0 || pTimeMs == 0)
+        return TREND_ERR_INVALID_PTR;
+
+    if (pTrend->count < pTrend->windowSize)
+        return TREND_ERR_NO_DATA;
+
+    if (pTrend->lastValue >= threshold)
+    {
+        *pTimeMs = 0;
+        return TREND_ERR_OK;
+    }
+
+    int64_t numerator = trendNumerator(pTrend);
+    if (numerator <= 0)
+        return TREND_ERR_NOT_RISING;
+
+    // Distance / slope in sample periods (rounded up)
+    int64_t distance = ((int64_t)threshold - pTrend->lastValue) * pTrend->denominator;
+    int64_t samples = (distance + numerator - 1) / numerator;
+
+    if (samples > (int64_t)(UINT32_MAX / pTrend->samplePeriodMs))
+    {
+        *pTimeMs = UINT32_MAX;
+    }
+    else
+    {
+        *pTimeMs = (uint32_t)samples * pTrend->samplePeriodMs;
+    }
+
+    return TREND_ERR_OK;
+}
+
+bool trendIsWarningActive(const TrendEstimator_t* pTrend)
+{
+    return (pTrend != 0) ? pTrend->warningActive : false;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Calculates the numerator of the slope of a full window
+ *
+ * @param pTrend        Pointer to the trend estimator instance
+ *
+ * @return N * Sum(x * y) - Sum(x) * Sum(y)
+ */
+static int64_t trendNumerator(const TrendEstimator_t* pTrend)
+{
+    return (int64_t)pTrend->windowSize * pTrend->sumXY - pTrend->sumX * pTrend->sumY;
+}
+
+/**
+ * @brief Checks whether the threshold is crossed within the horizon
+ *
+ * lastValue + numerator / denominator * horizon >= threshold, multiplied
+ * by the (positive) denominator. With the limits of the window size and
+ * the horizon both products fit into 64 bit.
+ *
+ * @param pTrend        Pointer to the trend estimator instance
+ *
+ * @return true if the crossing is predicted within the horizon
+ */
+static bool trendPredictCrossing(const TrendEstimator_t* pTrend)
+{
+    int64_t numerator = trendNumerator(pTrend);
+
+    if (numerator <= 0)
+        return false;
+
+    return numerator * pTrend->horizon >= ((int64_t)pTrend->threshold - pTrend->lastValue) * pTrend->denominator;
+}
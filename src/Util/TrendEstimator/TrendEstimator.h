@@ -0,0 +1,173 @@
+/******************************************************************************
+ * @file TrendEstimator.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the trend estimator (least squares slope over a
+ * sliding window) with early warning
+ *
+ * The samples have to be taken with a constant period. With the position
+ * x = 0..N-1 of a sample in the window, the slope of the regression line is
+ *
+ *   slope = (N * Sum(x * y) - Sum(x) * Sum(y)) / (N * Sum(x^2) - Sum(x)^2)
+ *
+ * Sum(x) and Sum(x^2) are constant for a full window. Sum(y) and Sum(x * y)
+ * are updated with every sample at constant cost: when the oldest sample
+ * leaves the window, all other samples move one position towards the
+ * start, which reduces Sum(x * y) by the remaining Sum(y). All sums are
+ * integers, so they do not drift.
+ *
+ * The early warning compares the extrapolated value after the horizon
+ * with the threshold by cross multiplication, so no division is needed
+ * per sample.
+ *
+ *****************************************************************************/
+#ifndef _TREND_ESTIMATOR_H_
+#define _TREND_ESTIMATOR_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***** CONSTANTS *************************************************************/
+#define TREND_MIN_WINDOW                    2       //!< Minimum number of samples in the window
+#define TREND_MAX_WINDOW                    64      //!< Maximum number of samples in the window (64 bit sums)
+#define TREND_MAX_HORIZON                   1024    //!< Maximum early warning horizon in sample periods
+
+
+/***** MACROS ****************************************************************/
+#define TREND_ERR_OK                        0       //!< No error occured
+#define TREND_ERR_INVALID_PTR               -1      //!< Invalid pointer (null pointer)
+#define TREND_ERR_INVALID_PARAM             -2      //!< Invalid parameter (window size, period, horizon)
+#define TREND_ERR_NO_DATA                   -3      //!< Window not filled yet
+#define TREND_ERR_NOT_RISING                -4      //!< Signal does not rise, the threshold is not reached
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Function pointer to post the early warning event (e.g. sameplAppSendEvent)
+ *
+ * Returns 0 if the event has been accepted, otherwise the event is posted
+ * again with the next sample.
+ */
+typedef int32_t (*TrendPostEventFunction)(int32_t eventID);
+
+/**
+ * @brief Struct which represents a trend estimator of one signal
+ *
+ */
+typedef struct _TrendEstimator
+{
+    // Static fields used for the configuration
+    int32_t* pWindow;                       //!< Samples of the window (circular, provided by the caller)
+    int32_t windowSize;                     //!< Number of samples in the window (N)
+    uint32_t samplePeriodMs;                //!< Period of the samples [ms]
+    int64_t sumX;                           //!< Sum(x) of a full window
+    int64_t denominator;                    //!< N * Sum(x^2) - Sum(x)^2 of a full window
+
+    int32_t threshold;                      //!< Threshold of the early warning
+    int32_t horizon;                        //!< Early warning horizon in sample periods (0 = no early warning)
+    int32_t eventID;                        //!< Event posted when the warning becomes active
+    TrendPostEventFunction pPostEvent;      //!< Function to post the event (can be 0)
+
+    // Dynamic fields used during runtime
+    int32_t count;                          //!< Number of samples in the window
+    int32_t index;                          //!< Position of the oldest sample in pWindow (when full)
+    int64_t sumY;                           //!< Sum(y) of the window
+    int64_t sumXY;                          //!< Sum(x * y) of the window
+    int32_t lastValue;                      //!< Newest sample
+    bool warningActive;                     //!< Threshold reached or predicted within the horizon
+    bool eventPosted;                       //!< Event of the active warning has been accepted
+} TrendEstimator_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes a trend estimator without early warning
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ * @param pWindow           Memory for the samples of the window
+ * @param windowSize        Number of samples in the window (TREND_MIN_WINDOW..TREND_MAX_WINDOW)
+ * @param samplePeriodMs    Period of the samples [ms]
+ *
+ * @return Returns TREND_ERR_OK if no error occured
+ */
+int32_t trendInitialize(TrendEstimator_t* pTrend, int32_t* pWindow, int32_t windowSize, uint32_t samplePeriodMs);
+
+/**
+ * @brief Configures the early warning
+ *
+ * The warning becomes active as soon as the signal reaches the threshold
+ * or the slope predicts the crossing within the horizon. The event is
+ * posted once per activation.
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ * @param threshold         Threshold of the signal
+ * @param horizonMs         Horizon of the prediction [ms], 0 disables the early warning
+ * @param eventID           Event to post
+ * @param pPostEvent        Function to post the event (can be 0)
+ *
+ * @return Returns TREND_ERR_OK if no error occured
+ */
+int32_t trendSetEarlyWarning(TrendEstimator_t* pTrend, int32_t threshold, uint32_t horizonMs, int32_t eventID, TrendPostEventFunction pPostEvent);
+
+/**
+ * @brief Discards all samples of the window, e.g. if the sensor is defect
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ *
+ * @return Returns TREND_ERR_OK if no error occured
+ */
+int32_t trendReset(TrendEstimator_t* pTrend);
+
+/**
+ * @brief Adds a sample to the window and updates the early warning
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ * @param value             New sample
+ *
+ * @return Returns TREND_ERR_OK, TREND_ERR_NO_DATA while the window is
+ * filled, or TREND_ERR_INVALID_PTR
+ */
+int32_t trendUpdate(TrendEstimator_t* pTrend, int32_t value);
+
+/**
+ * @brief Returns the slope of the signal
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ * @param pMilliPerSecond   Pointer to store the slope to [1/1000 signal units per second]
+ *
+ * @return Returns TREND_ERR_OK, TREND_ERR_NO_DATA or TREND_ERR_INVALID_PTR
+ */
+int32_t trendGetSlope(const TrendEstimator_t* pTrend, int32_t* pMilliPerSecond);
+
+/**
+ * @brief Predicts the time until the signal reaches a threshold
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ * @param threshold         Threshold of the signal
+ * @param pTimeMs           Pointer to store the time to [ms], 0 if the threshold is already reached
+ *
+ * @return Returns TREND_ERR_OK, TREND_ERR_NO_DATA, TREND_ERR_NOT_RISING
+ * (time is not written) or TREND_ERR_INVALID_PTR
+ */
+int32_t trendGetTimeToThreshold(const TrendEstimator_t* pTrend, int32_t threshold, uint32_t* pTimeMs);
+
+/**
+ * @brief Checks whether the early warning is active
+ *
+ * @param pTrend            Pointer to the trend estimator instance
+ *
+ * @return true if the threshold is reached or predicted within the horizon
+ */
+bool trendIsWarningActive(const TrendEstimator_t* pTrend);
+
+#endif
@@ -15,6 +15,8 @@
 
 
 /***** INCLUDES **************************************************************/
+#include <stdbool.h>
+
 #include "stm32g4xx_hal.h"
 #include "System.h"
 
@@ -31,6 +33,17 @@
 #include "ADCModule.h"
 #include "TimerModule.h"
 #include "Scheduler.h"
+#include "AppTasks.h"
+#include "Application.h"
+
+#ifdef ENABLE_HW_GAS_TRIP
+#include "ComparatorModule.h"
+#include "Util/GasScale/GasScale.h"
+#endif
+
+#ifdef ENABLE_FRAME_MUX
+#include "FrameMux.h"
+#endif
 
 #include "GlobalObjects.h"
 
@@ -39,6 +52,8 @@
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define DEBUG_UART_BAUDRATE     115200      //!< Baudrate of the debug UART (log output, frame multiplexer)
+#define SENSOR_UART_BAUDRATE    115200      //!< Baudrate of the water sensor line
 
 
 /***** PRIVATE TYPES *********************************************************/
@@ -46,10 +61,14 @@
 
 /***** PRIVATE PROTOTYPES ****************************************************/
 static int32_t initializePeripherals();
+static void taskHmi1ms();
+static void taskHmi100ms();
 
 
 /***** PRIVATE VARIABLES *****************************************************/
 static Scheduler gScheduler;            // Global Scheduler instance
+static int32_t gDisplayCounter = 0;     // Value shown on the 7-segment display
+static Button_Status_t gLastAlarmResetButton = BUTTON_RELEASED;    // State of B1 in the last HMI cycle
 
 
 /***** PUBLIC FUNCTIONS ******************************************************/
@@ -67,74 +86,25 @@ int main(void)
     SystemClock_Config();
 
     // Initialize Peripherals
-    initializePeripherals();
+    int32_t result = initializePeripherals();
+
+    // Initialize the application state machine and the data of the tasks
+    sampleAppInitialize();
+    taskAppInitialize();
 
     // Initialize Scheduler
+    gScheduler.pGetHALTick  = HAL_GetTick;
+    gScheduler.pTask_1ms    = taskHmi1ms;
+    gScheduler.pTask_10ms   = taskApp10ms;
+    gScheduler.pTask_100ms  = taskHmi100ms;
+    gScheduler.pTask_250ms  = taskApp250ms;
     schedInitialize(&gScheduler);
 
-    int globalCounter = 0;
-    uint8_t left = 0;
+    sameplAppSendEvent((result == ERROR_OK) ? EVT_ID_INIT_READY : EVT_ID_SENSOR_FAILED);
 
     while (1)
     {
-        // Read to buttons
-        Button_Status_t but1 = buttonGetButtonStatus(BTN_SW1);
-        Button_Status_t but2 = buttonGetButtonStatus(BTN_SW2);
-        Button_Status_t but3 = buttonGetButtonStatus(BTN_B1);
-
-        // Read the POT1 input from ADC
-        int adcValue = adcReadChannel(ADC_INPUT0);
-
-        // If SW1 is pressed, print some debug message on the terminal
-        if (but1 == BUTTON_PRESSED)
-        {
-            // Toggle all LEDs to the their functionality (Toggle frequency depends on HAL_Delay at end of loop)
-            ledToggleLED(LED0);
-            HAL_Delay(25);
-            ledToggleLED(LED1);
-            HAL_Delay(25);
-            ledToggleLED(LED2);
-            HAL_Delay(25);
-            ledToggleLED(LED3);
-            HAL_Delay(25);
-            ledToggleLED(LED4);
-            HAL_Delay(25);
-        }
-
-        // If SW2 is pressed, print the ADC digit value on the terminal
-        if (but2 == BUTTON_PRESSED)
-        {
-        	HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_RESET);
-        }
-        else
-        {
-        	HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_SET);
-        }
-
-        if (but3 == BUTTON_PRESSED)
-        {
-        	outputLogf("ADC Val: %d\n\r", adcValue);
-        }
-
-        globalCounter++;
-        if (globalCounter > 99)
-        {
-            globalCounter = 0;
-        }
-
-        if (left == 1)
-        {
-            displayShowDigit(LEFT_DISPLAY, (globalCounter / 10));
-        }
-        else
-        {
-            displayShowDigit(RIGHT_DISPLAY, (globalCounter % 10));
-        }
-
-        left = !left;
-
-        // Remove this HAL_Delay as soon as there is a Scheduler used
-        HAL_Delay(25);
+        schedCycle(&gScheduler);
     }
 }
 
@@ -149,7 +119,16 @@ int main(void)
 static int32_t initializePeripherals()
 {
     // Initialize UART used for Debug-Outputs
-    uartInitialize(115200);
+    uartInitialize(UART_PORT_DEBUG, DEBUG_UART_BAUDRATE);
+
+    // Initialize the dedicated UART of the water sensor line
+    uartInitialize(UART_PORT_SENSOR, SENSOR_UART_BAUDRATE);
+
+#ifdef ENABLE_FRAME_MUX
+    // Log output is sent as frames on the log channel (see tools/frame_demux.py)
+    frameMuxInitialize();
+    outputSetWriter(frameMuxWriteLog);
+#endif
 
     // Initialize GPIOs for LED and 7-Segment output
 	ledInitialize();
@@ -162,5 +141,91 @@ static int32_t initializePeripherals()
     timerInitialize();
     adcInitialize();
 
+#ifdef ENABLE_HW_GAS_TRIP
+    // Hardware trip of the gas sensors at the emergency threshold (uses the
+    // analog inputs configured by the ADC module). Without the trip the
+    // emergency is still detected by the ADC, so the startup continues
+    if (compInitialize(gasScalePpmToMicroVolt(GAS_PPM_EMERGENCY)) != COMP_ERR_OK)
+    {
+        outputLog("Hardware gas trip not available, using the ADC alarms only\n\r");
+    }
+#endif
+
     return ERROR_OK;
 }
+
+/**
+ * @brief Multiplexes the two digits of the 7-segment display
+ */
+static void taskHmi1ms()
+{
+    static uint8_t left = 0;
+
+    if (left == 1)
+    {
+        displayShowDigit(LEFT_DISPLAY, (gDisplayCounter / 10));
+    }
+    else
+    {
+        displayShowDigit(RIGHT_DISPLAY, (gDisplayCounter % 10));
+    }
+
+    left = !left;
+}
+
+/**
+ * @brief Reads the buttons and updates LEDs, buzzer and display counter
+ */
+static void taskHmi100ms()
+{
+    // Read to buttons
+    Button_Status_t but1 = buttonGetButtonStatus(BTN_SW1);
+    Button_Status_t but2 = buttonGetButtonStatus(BTN_SW2);
+    Button_Status_t but3 = buttonGetButtonStatus(BTN_B1);
+
+    // If SW1 is pressed, toggle the LEDs (toggle frequency depends on the task period),
+    // LED1 shows the alarm state
+    if (but1 == BUTTON_PRESSED)
+    {
+        ledToggleLED(LED0);
+        ledToggleLED(LED2);
+        ledToggleLED(LED3);
+        ledToggleLED(LED4);
+    }
+
+    // The buzzer sounds while SW2 is pressed and in the Emergency state
+    bool buzzer = (but2 == BUTTON_PRESSED) || (sampleAppGetState() == STATE_ID_EMERGENCY);
+
+#ifdef ENABLE_HW_GAS_TRIP
+    // The buzzer must not be switched off while the hardware trip is active
+    buzzer = buzzer || compIsTripped();
+#endif
+
+    if (buzzer)
+    {
+        HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_RESET);
+    }
+    else
+    {
+        HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_SET);
+    }
+
+    // B1 is the alarm reset, only the press is taken (not holding the button)
+    if (but3 == BUTTON_PRESSED && gLastAlarmResetButton != BUTTON_PRESSED)
+    {
+        outputLogf("Alarm reset, ADC Val: %d\n\r", adcReadChannel(ADC_INPUT0));
+        taskAppAcknowledgeAlarms();
+
+#ifdef ENABLE_HW_GAS_TRIP
+        // The trip stays active while an input is still above the threshold
+        compAcknowledgeTrip();
+#endif
+    }
+    gLastAlarmResetButton = but3;
+
+    gDisplayCounter++;
+    if (gDisplayCounter > 99)
+    {
+        gDisplayCounter = 0;
+    }
+}
@@ -109,7 +109,7 @@ static int32_t initializePeripherals(void)
     int32_t result = ERROR_OK;
 
     /* UART – 115200 baud, 8N1 */
-    result = uartInitialize(115200);
+    result = uartInitialize(UART_PORT_DEBUG, 115200);
     if (result != UART_ERR_OK)
     {
         return ERROR_GENERAL;
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+###############################################################################
+# @file adc_dump_to_csv.py
+#
+# @brief Converts a raw ADC capture dump (see adcCaptureProcess() in
+# src/HAL/ADCModule.h) into a CSV file
+#
+# The dump is expected as raw bytes as received from the debug UART, e.g.
+# recorded with "cat /dev/ttyACM0 > dump.bin". Any bytes before the "ADCD"
+# magic (e.g. log output) are skipped. The capture is started by sending a
+# 'c' on the terminal. With ENABLE_FRAME_MUX, the capture is requested and
+# the dump is extracted with tools/frame_demux.py.
+#
+# Usage: adc_dump_to_csv.py <dump.bin> [<output.csv>]
+#
+###############################################################################
+
+import struct
+import sys
+
+HEADER_FORMAT = "<4sBBHIIIHHHHI"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+TRAILER_SIZE = 4
+
+CHANNEL_NAMES = ["POT1", "POT2", "TEMP", "VBAT", "VREF"]
+
+
+def parse_dump(data):
+    start = data.find(b"ADCD")
+    if start < 0:
+        raise ValueError("no dump header found")
+
+    (magic, version, channel_count, channel_mask, sample_rate, sequence_count,
+     microvolts_per_digit, vrefint_cal, ts_cal1, ts_cal2, _reserved,
+     start_tick) = struct.unpack_from(HEADER_FORMAT, data, start)
+
+    if version != 1:
+        raise ValueError("unsupported dump version %d" % version)
+
+    channels = [i for i in range(16) if channel_mask & (1 << i)]
+    if len(channels) != channel_count:
+        raise ValueError("channel mask and channel count do not match")
+
+    sample_count = sequence_count * channel_count
+    offset = start + HEADER_SIZE
+    end = offset + 2 * sample_count
+    if len(data) < end + TRAILER_SIZE:
+        raise ValueError("dump truncated: expected %d samples" % sample_count)
+
+    samples = struct.unpack_from("<%dH" % sample_count, data, offset)
+    (checksum,) = struct.unpack_from("<I", data, end)
+    if (sum(samples) & 0xFFFFFFFF) != checksum:
+        raise ValueError("checksum mismatch")
+
+    header = {
+        "sample_rate": sample_rate,
+        "channels": channels,
+        "microvolts_per_digit": microvolts_per_digit,
+        "vrefint_cal": vrefint_cal,
+        "ts_cal1": ts_cal1,
+        "ts_cal2": ts_cal2,
+        "start_tick": start_tick,
+    }
+    return header, samples
+
+
+def write_csv(header, samples, out):
+    channels = header["channels"]
+    names = [CHANNEL_NAMES[c] if c < len(CHANNEL_NAMES) else "CH%d" % c for c in channels]
+
+    out.write("# sample_rate_hz=%d microvolts_per_digit=%d vrefint_cal=%d ts_cal1=%d ts_cal2=%d start_tick_ms=%d\n"
+              % (header["sample_rate"], header["microvolts_per_digit"], header["vrefint_cal"],
+                 header["ts_cal1"], header["ts_cal2"], header["start_tick"]))
+    out.write("index,time_us," + ",".join("%s_raw,%s_uv" % (n, n) for n in names) + "\n")
+
+    count = len(channels)
+    for index in range(len(samples) // count):
+        row = samples[index * count:(index + 1) * count]
+        time_us = index * 1000000 // header["sample_rate"]
+        values = ",".join("%d,%d" % (raw, raw * header["microvolts_per_digit"]) for raw in row)
+        out.write("%d,%d,%s\n" % (index, time_us, values))
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: %s <dump.bin> [<output.csv>]\n" % sys.argv[0])
+        return 1
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    header, samples = parse_dump(data)
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], "w") as out:
+            write_csv(header, samples, out)
+    else:
+        write_csv(header, samples, sys.stdout)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
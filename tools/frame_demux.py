@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+###############################################################################
+# @file frame_demux.py
+#
+# @brief Host side of the frame multiplexer (see src/Service/FrameMux.h)
+#
+# Splits the UART byte stream into COBS frames, checks the CRC16 and prints
+# the frames per channel. The log channel is printed as text, all other
+# channels as hex dump. Single channels can be written to a file, e.g. the
+# telemetry channel for tools/adc_dump_to_csv.py.
+#
+# The stream is read from a file or a serial device node, e.g.
+# "frame_demux.py /dev/ttyACM0" (the port has to be configured with stty).
+#
+# The water sensor link statistics are requested with
+# "frame_demux.py --send 4 01" and printed decoded. A raw ADC capture is
+# started with "frame_demux.py --send 4 02" (default channels, rate and
+# length) or "--send 4 02<mask><rate Hz><sequences>" (32 bit little endian
+# each), the dump follows on the telemetry channel.
+#
+# Usage: frame_demux.py <input> [--channel <n> --output <file>]
+#        frame_demux.py --send <channel> <hex payload>  > /dev/ttyACM0
+#
+###############################################################################
+
+import argparse
+import binascii
+import struct
+import sys
+
+CHANNEL_NAMES = {0: "CONTROL", 1: "LOG", 2: "SENSOR", 3: "TELEMETRY", 4: "DIAGNOSTIC"}
+CHANNEL_LOG = 1
+CHANNEL_DIAGNOSTIC = 4
+DIAG_CMD_WATER_LINK = 0x01
+DIAG_CMD_ADC_CAPTURE = 0x02
+WATER_LINK_FIELDS = ("interval min", "interval max", "interval mean", "jitter mean", "jitter max")
+WATER_LINK_BIN_WIDTH_MS = 10
+MAX_PAYLOAD = 128
+
+
+def crc16(data):
+    # CRC-CCITT, polynomial 0x1021, start value 0xFFFF
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data):
+            raise ValueError("invalid COBS encoding")
+        out += data[index + 1:index + code]
+        index += code
+        if code < 0xFF and index < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte != 0:
+            out.append(byte)
+            code += 1
+        if byte == 0 or code == 0xFF:
+            out[code_index] = code
+            code_index = len(out)
+            out.append(0)
+            code = 1
+    out[code_index] = code
+    return bytes(out)
+
+
+def encode_frame(channel, payload):
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload too long")
+    raw = bytes([channel]) + payload
+    crc = crc16(raw)
+    return cobs_encode(raw + bytes([crc & 0xFF, crc >> 8])) + b"\x00"
+
+
+def decode_frame(encoded):
+    raw = cobs_decode(encoded)
+    if len(raw) < 3:
+        raise ValueError("frame too short")
+    crc = raw[-2] | (raw[-1] << 8)
+    if crc16(raw[:-2]) != crc:
+        raise ValueError("CRC mismatch")
+    return raw[0], raw[1:-2]
+
+
+def frames(stream):
+    """Yields (channel, payload) or (None, error) for every frame of the stream"""
+    pending = bytearray()
+    while True:
+        data = stream.read(1) if stream.isatty() else stream.read(4096)
+        if not data:
+            break
+        pending += data
+        while True:
+            end = pending.find(b"\x00")
+            if end < 0:
+                break
+            encoded = bytes(pending[:end])
+            del pending[:end + 1]
+            if not encoded:
+                continue
+            try:
+                yield decode_frame(encoded)
+            except ValueError as error:
+                yield None, str(error)
+
+
+def format_water_link(payload):
+    # Response to DIAG_CMD_WATER_LINK (see src/App/AppTasks.c)
+    values = struct.unpack("<%dI" % ((len(payload) - 1) // 4), payload[1:])
+    text = ", ".join("%s %u us" % field for field in zip(WATER_LINK_FIELDS, values))
+    text += ", loss %u ppm, checksum errors %u ppm\n" % (values[5], values[6])
+    histogram = values[7:]
+    for index, count in enumerate(histogram):
+        last = "+" if index == len(histogram) - 1 else "-%d" % ((index + 1) * WATER_LINK_BIN_WIDTH_MS)
+        text += "  %3d%-5s ms %u\n" % (index * WATER_LINK_BIN_WIDTH_MS, last, count)
+    return text
+
+
+def print_frame(channel, payload, out):
+    name = CHANNEL_NAMES.get(channel, "CH%d" % channel)
+    if channel == CHANNEL_LOG:
+        out.write(payload.decode("latin-1"))
+    elif channel == CHANNEL_DIAGNOSTIC and payload[:1] == bytes([DIAG_CMD_WATER_LINK]) and len(payload) > 29:
+        out.write("[%s] water link: %s" % (name, format_water_link(payload)))
+    elif channel == CHANNEL_DIAGNOSTIC and payload[:1] == bytes([DIAG_CMD_ADC_CAPTURE]) and len(payload) == 5:
+        out.write("[%s] ADC capture: result %d\n" % (name, struct.unpack_from("<i", payload, 1)[0]))
+    else:
+        out.write("[%s] %s\n" % (name, payload.hex(" ")))
+    out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Demultiplexes the frames of the UART stream")
+    parser.add_argument("input", nargs="?", help="recorded stream or serial device")
+    parser.add_argument("--channel", type=int, help="only handle this channel")
+    parser.add_argument("--output", help="write the payload of --channel to this file")
+    parser.add_argument("--send", nargs=2, metavar=("CHANNEL", "HEX"),
+                        help="encode a frame and write it to stdout")
+    args = parser.parse_args()
+
+    if args.send:
+        sys.stdout.buffer.write(encode_frame(int(args.send[0]), bytes.fromhex(args.send[1])))
+        return 0
+
+    if args.input is None or (args.output and args.channel is None):
+        parser.print_usage(sys.stderr)
+        return 1
+
+    output = open(args.output, "wb") if args.output else None
+    errors = 0
+
+    with open(args.input, "rb", buffering=0) as stream:
+        for channel, payload in frames(stream):
+            if channel is None:
+                errors += 1
+                sys.stderr.write("frame error: %s\n" % payload)
+                continue
+            if args.channel is not None and channel != args.channel:
+                continue
+            if output:
+                output.write(payload)
+            else:
+                print_frame(channel, payload, sys.stdout)
+
+    if output:
+        output.close()
+
+    if errors:
+        sys.stderr.write("%d invalid frames\n" % errors)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * @file HostTest.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Minimal check macros for the host tests (see make host-test)
+ *
+ * Each test is a program of its own, a failed check is reported with its
+ * location and the program returns a non zero exit code.
+ *
+ *****************************************************************************/
+#ifndef _HOST_TEST_H_
+#define _HOST_TEST_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+
+/**
+ * @brief Checks a condition, a failure is reported and counted
+ */
+#define HOST_TEST_CHECK(condition)      hostTestCheck((condition), #condition, __FILE__, __LINE__)
+
+
+/***** TYPES *****************************************************************/
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gHostTestChecks;        //!< Number of executed checks
+static uint32_t gHostTestFailures;      //!< Number of failed checks
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Counts a check and reports it if it failed
+ *
+ * @param condition     Result of the check
+ * @param pText         Text of the checked condition
+ * @param pFile         Source file of the check
+ * @param line          Source line of the check
+ *
+ * @return The result of the check
+ */
+static inline bool hostTestCheck(bool condition, const char* pText, const char* pFile, int line)
+{
+    gHostTestChecks++;
+
+    if (!condition)
+    {
+        gHostTestFailures++;
+        fprintf(stderr, "%s:%d: check failed: %s\n", pFile, line, pText);
+    }
+
+    return condition;
+}
+
+/**
+ * @brief Prints the summary of the test
+ *
+ * @param pName         Name of the test
+ *
+ * @return Exit code of the test program (0 if all checks passed)
+ */
+static inline int hostTestResult(const char* pName)
+{
+    printf("%s: %u checks, %u failed\n", pName, gHostTestChecks, gHostTestFailures);
+    return (gHostTestFailures == 0) ? 0 : 1;
+}
+
+#endif
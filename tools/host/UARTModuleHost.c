@@ -0,0 +1,756 @@
+/******************************************************************************
+ * @file UARTModuleHost.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host implementation of the UART Module based on a Linux
+ * pseudo-terminal
+ *
+ * Implements the API of src/HAL/UARTModule.h, so the layers above the UART
+ * (frame multiplexer, sensor decoders) run unchanged on the host. The ring
+ * buffers are the ones of the target (src/HAL/UARTRing.c): the receive
+ * thread (the "DMA") publishes the RX head in chunks of at most half the
+ * buffer, the reader detects overwritten data the same way.
+ *
+ * Every initialized port gets its own pseudo-terminal (or attached file
+ * descriptor) with its own receive and transmit thread.
+ *
+ *****************************************************************************/
+
+#define _GNU_SOURCE
+
+/***** INCLUDES **************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "UARTModuleHost.h"
+#include "UARTRing.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define UART_RX_CHUNK               (UART_RX_BUFFER_SIZE / 2)       //!< Bytes per RX event (half transfer of the DMA)
+#define UART_TX_CHUNK               64                              //!< Bytes per write to the file descriptor
+#define UART_BITS_PER_BYTE          10                              //!< Start bit, 8 data bits, stop bit
+#define UART_POLL_TIMEOUT_MS        100                             //!< Poll timeout of the receive thread
+
+#define PPM                         1000000U                        //!< Parts per million
+#define UART_RANDOM_SEED            0x12345678U                     //!< Default seed of the fault injection
+
+#define UART_PORT_VALID(port)       ((uint32_t)(port) < UART_PORT_COUNT)     //!< Checks a port passed to the API
+
+/**
+ * @brief Static initializer of a port instance
+ */
+#define UART_HOST_INSTANCE(p)       { .port = (p), .fd = -1, .slaveFd = -1, \
+                                      .txLock = PTHREAD_MUTEX_INITIALIZER, .txCondition = PTHREAD_COND_INITIALIZER, \
+                                      .faultLock = PTHREAD_MUTEX_INITIALIZER, .randomState = UART_RANDOM_SEED }
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief State of a UART port
+ *
+ */
+typedef struct _UARTHostInstance_
+{
+    UARTPort_t port;                    //!< Port of the instance
+    int fd;                             //!< File descriptor of the UART (pseudo-terminal master)
+    int slaveFd;                        //!< Slave side, kept open so the master does not see a hang up
+    char portName[64];                  //!< Path of the pseudo-terminal slave
+    uint32_t baudrate;                  //!< Configured baudrate
+    atomic_int running;                 //!< Threads are running
+
+    pthread_t rxThread;                 //!< Receive thread ("RX DMA")
+    pthread_t txThread;                 //!< Transmit thread ("TX DMA")
+
+    UARTRxRing_t rxRing;                //!< RX ring buffer (head published with release semantics)
+    _Atomic UARTRxCallback rxCallback;  //!< Called by the receive thread after new data has been published
+
+    pthread_mutex_t txLock;             //!< Protects the TX ring buffer
+    pthread_cond_t txCondition;         //!< Signals new data and completed transfers
+    UARTTxRing_t txRing;                //!< TX ring buffer, drained by the transmit thread
+
+    pthread_mutex_t faultLock;          //!< Protects the fault configuration and counters
+    UARTHostFaults_t faults;            //!< Injected faults
+    UARTHostStats_t hostStats;          //!< Counters of the injected faults
+    uint32_t randomState;               //!< State of the random generator
+    uint32_t burstRemaining;            //!< Bytes left in the current corrupted burst
+
+    UARTIrqStats_t irqStats;            //!< RX event counters (written by the receive thread)
+} UARTHostInstance_t;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int32_t uartOpenPseudoTerminal(UARTHostInstance_t* pUART);
+static void* uartRxThread(void* pArgument);
+static void* uartTxThread(void* pArgument);
+static uint32_t uartApplyFaults(UARTHostInstance_t* pUART, uint8_t* pData, uint32_t count);
+static uint32_t uartRandom(UARTHostInstance_t* pUART);
+static void uartPace(UARTHostInstance_t* pUART, uint32_t byteCount);
+static uint32_t uartRxPending(UARTHostInstance_t* pUART);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static atomic_int gPacing = 1;              //!< Transfers are paced to the baudrate
+
+static UARTHostInstance_t gUART[UART_PORT_COUNT] =
+{
+    UART_HOST_INSTANCE(UART_PORT_DEBUG),
+    UART_HOST_INSTANCE(UART_PORT_SENSOR)
+};                                          //!< State of the UART ports
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t uartHostAttach(UARTPort_t port, int fd)
+{
+    if (!UART_PORT_VALID(port) || fd < 0 || atomic_load(&gUART[port].running))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    pUART->fd = fd;
+    pUART->portName[0] = '\0';
+
+    return UART_ERR_OK;
+}
+
+const char* uartHostGetPortName(UARTPort_t port)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return "";
+    }
+
+    return gUART[port].portName;
+}
+
+void uartHostSetPacing(int32_t enable)
+{
+    atomic_store(&gPacing, enable ? 1 : 0);
+}
+
+int32_t uartHostSetFaults(UARTPort_t port, const UARTHostFaults_t* pFaults)
+{
+    if (!UART_PORT_VALID(port) ||
+        (pFaults != 0 && (pFaults->dropPpm > PPM || pFaults->bitFlipPpm > PPM || pFaults->burstPpm > PPM)))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    pthread_mutex_lock(&pUART->faultLock);
+
+    pUART->faults = (pFaults != 0) ? *pFaults : (UARTHostFaults_t){ 0 };
+    pUART->randomState = (pUART->faults.seed != 0) ? pUART->faults.seed : UART_RANDOM_SEED;
+    pUART->burstRemaining = 0;
+
+    pthread_mutex_unlock(&pUART->faultLock);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartHostGetStats(UARTPort_t port, UARTHostStats_t* pStats)
+{
+    if (!UART_PORT_VALID(port) || pStats == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    pthread_mutex_lock(&pUART->faultLock);
+    *pStats = pUART->hostStats;
+    pthread_mutex_unlock(&pUART->faultLock);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartInitialize(UARTPort_t port, uint32_t baudrate)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    if (baudrate == 0)
+    {
+        return UART_ERR_BAUDRATE;
+    }
+
+    if (atomic_load(&pUART->running))
+    {
+        return UART_ERR_INIT_FAILURE;
+    }
+
+    if (pUART->fd < 0 && uartOpenPseudoTerminal(pUART) != UART_ERR_OK)
+    {
+        return UART_ERR_INIT_FAILURE;
+    }
+
+    pUART->baudrate = baudrate;
+
+    uartRxRingReset(&pUART->rxRing);
+    pUART->irqStats = (UARTIrqStats_t){ 0 };
+
+    uartTxRingReset(&pUART->txRing);
+    pUART->hostStats = (UARTHostStats_t){ 0 };
+
+    atomic_store(&pUART->running, 1);
+
+    if (pthread_create(&pUART->rxThread, 0, uartRxThread, pUART) != 0 ||
+        pthread_create(&pUART->txThread, 0, uartTxThread, pUART) != 0)
+    {
+        return UART_ERR_INIT_FAILURE;
+    }
+
+    return UART_ERR_OK;
+}
+
+int32_t uartGetBaudrate(UARTPort_t port, uint32_t* pActualBaudrate, int32_t* pErrorPpm)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    if (pActualBaudrate == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    *pActualBaudrate = pUART->baudrate;
+
+    if (pErrorPpm != 0)
+    {
+        *pErrorPpm = 0;
+    }
+
+    return UART_ERR_OK;
+}
+
+int32_t uartSendData(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    int32_t result;
+
+    if (!UART_PORT_VALID(port) || pDataBuffer == 0 || bufferLength < 0)
+    {
+        return UART_ERR_TRANSMIT;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+    uint32_t length = (uint32_t)bufferLength;
+
+    pthread_mutex_lock(&pUART->txLock);
+
+    result = uartTxRingWrite(&pUART->txRing, pDataBuffer, length);
+
+    pthread_cond_broadcast(&pUART->txCondition);
+    pthread_mutex_unlock(&pUART->txLock);
+
+    return result;
+}
+
+int32_t uartWriteDebug(uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    return uartSendData(UART_PORT_DEBUG, pDataBuffer, bufferLength);
+}
+
+int32_t uartSetTxPolicy(UARTPort_t port, UART_TxPolicy_t policy)
+{
+    if (!UART_PORT_VALID(port) ||
+        (policy != UART_TX_POLICY_DROP_NEW && policy != UART_TX_POLICY_OVERWRITE_OLDEST))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    pthread_mutex_lock(&pUART->txLock);
+    pUART->txRing.policy = policy;
+    pthread_mutex_unlock(&pUART->txLock);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartFlush(UARTPort_t port, uint32_t timeoutMs)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_TRANSMIT;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+    int32_t result = UART_ERR_OK;
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&pUART->txLock);
+
+    while (!uartTxRingIsIdle(&pUART->txRing))
+    {
+        if (pthread_cond_timedwait(&pUART->txCondition, &pUART->txLock, &deadline) == ETIMEDOUT)
+        {
+            result = UART_ERR_TRANSMIT;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&pUART->txLock);
+
+    return result;
+}
+
+int32_t uartGetTxStats(UARTPort_t port, UARTTxStats_t* pStats)
+{
+    if (!UART_PORT_VALID(port) || pStats == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    pthread_mutex_lock(&pUART->txLock);
+    *pStats = pUART->txRing.stats;
+    pthread_mutex_unlock(&pUART->txLock);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartGetIrqStats(UARTPort_t port, UARTIrqStats_t* pStats)
+{
+    if (!UART_PORT_VALID(port) || pStats == 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    pthread_mutex_lock(&pUART->faultLock);
+    *pStats = pUART->irqStats;
+    pthread_mutex_unlock(&pUART->faultLock);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartReceiveData(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    if (!UART_PORT_VALID(port) || pDataBuffer == 0 || bufferLength < 0 ||
+        (uint32_t)bufferLength > uartRxPending(&gUART[port]))
+    {
+        return UART_ERR_RECEIVE;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    uartRxRingCopy(&pUART->rxRing, pDataBuffer, (uint32_t)bufferLength);
+    uartRxRingConsume(&pUART->rxRing, (uint32_t)bufferLength);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartHasData(UARTPort_t port, int8_t* pHasData)
+{
+    if (!UART_PORT_VALID(port) || pHasData == 0)
+    {
+        return UART_ERR_RECEIVE;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    *pHasData = (uartRxPending(pUART) > 0) ? 1 : 0;
+
+    return UART_ERR_OK;
+}
+
+int32_t uartAvailable(UARTPort_t port)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    return (int32_t)uartRxPending(&gUART[port]);
+}
+
+int32_t uartRead(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    int32_t count = uartPeek(port, pDataBuffer, bufferLength);
+
+    if (count > 0)
+    {
+        uartRxRingConsume(&gUART[port].rxRing, (uint32_t)count);
+    }
+
+    return count;
+}
+
+int32_t uartPeek(UARTPort_t port, uint8_t* pDataBuffer, int32_t bufferLength)
+{
+    if (!UART_PORT_VALID(port) || pDataBuffer == 0 || bufferLength < 0)
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    uint32_t count = uartRxPending(pUART);
+
+    if (count > (uint32_t)bufferLength)
+    {
+        count = (uint32_t)bufferLength;
+    }
+
+    uartRxRingCopy(&pUART->rxRing, pDataBuffer, count);
+
+    return (int32_t)count;
+}
+
+uint32_t uartGetRxOverflowCount(UARTPort_t port)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return 0;
+    }
+
+    return gUART[port].rxRing.overflowCount;
+}
+
+int32_t uartSetRxCallback(UARTPort_t port, UARTRxCallback pCallback)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_INVALID_PARAM;
+    }
+
+    atomic_store(&gUART[port].rxCallback, pCallback);
+
+    return UART_ERR_OK;
+}
+
+int32_t uartStopReception(UARTPort_t port)
+{
+    if (!UART_PORT_VALID(port))
+    {
+        return UART_ERR_RECEIVE;
+    }
+
+    UARTHostInstance_t* pUART = &gUART[port];
+
+    if (!atomic_exchange(&pUART->running, 0))
+    {
+        return UART_ERR_OK;
+    }
+
+    pthread_mutex_lock(&pUART->txLock);
+    pthread_cond_broadcast(&pUART->txCondition);
+    pthread_mutex_unlock(&pUART->txLock);
+
+    pthread_join(pUART->rxThread, 0);
+    pthread_join(pUART->txThread, 0);
+
+    close(pUART->fd);
+    pUART->fd = -1;
+
+    if (pUART->slaveFd >= 0)
+    {
+        close(pUART->slaveFd);
+        pUART->slaveFd = -1;
+    }
+
+    return UART_ERR_OK;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Opens a pseudo-terminal in raw mode
+ *
+ * @param pUART         Port instance
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INIT_FAILURE
+ */
+static int32_t uartOpenPseudoTerminal(UARTHostInstance_t* pUART)
+{
+    struct termios settings;
+
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0 ||
+        ptsname_r(fd, pUART->portName, sizeof(pUART->portName)) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return UART_ERR_INIT_FAILURE;
+    }
+
+    pUART->slaveFd = open(pUART->portName, O_RDWR | O_NOCTTY);
+
+    if (pUART->slaveFd < 0 || tcgetattr(pUART->slaveFd, &settings) != 0)
+    {
+        close(fd);
+        return UART_ERR_INIT_FAILURE;
+    }
+
+    cfmakeraw(&settings);
+    tcsetattr(pUART->slaveFd, TCSANOW, &settings);
+
+    pUART->fd = fd;
+
+    return UART_ERR_OK;
+}
+
+/**
+ * @brief Receive thread, emulates the circular RX DMA
+ *
+ * @param pArgument     Port instance
+ *
+ * @return Always 0
+ */
+static void* uartRxThread(void* pArgument)
+{
+    UARTHostInstance_t* pUART = (UARTHostInstance_t*)pArgument;
+
+    uint8_t chunk[UART_RX_CHUNK];
+    struct pollfd pollFd = { pUART->fd, POLLIN, 0 };
+
+    while (atomic_load(&pUART->running))
+    {
+        if (poll(&pollFd, 1, UART_POLL_TIMEOUT_MS) <= 0)
+        {
+            continue;
+        }
+
+        ssize_t count = read(pUART->fd, chunk, sizeof(chunk));
+
+        if (count <= 0)
+        {
+            if (count == 0 || (errno != EAGAIN && errno != EINTR))
+            {
+                /* Peer closed the connection, wait for the next one */
+                usleep(UART_POLL_TIMEOUT_MS * 1000);
+            }
+            continue;
+        }
+
+        uartPace(pUART, (uint32_t)count);
+
+        uint32_t received = uartApplyFaults(pUART, chunk, (uint32_t)count);
+        uint32_t head = pUART->rxRing.head;
+
+        for (uint32_t i = 0; i < received; i++)
+        {
+            pUART->rxRing.buffer[(head + i) & UART_RX_BUFFER_MASK] = chunk[i];
+        }
+
+        /* Publish like the IDLE line/half transfer event of the target */
+        atomic_thread_fence(memory_order_release);
+        pUART->rxRing.head = head + received;
+
+        pthread_mutex_lock(&pUART->faultLock);
+        pUART->irqStats.rxEventCount++;
+        pUART->irqStats.rxBytes += received;
+        pthread_mutex_unlock(&pUART->faultLock);
+
+        UARTRxCallback pCallback = atomic_load(&pUART->rxCallback);
+        if (received != 0 && pCallback != 0)
+        {
+            pCallback(pUART->port);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Transmit thread, drains the TX ring buffer
+ *
+ * @param pArgument     Port instance
+ *
+ * @return Always 0
+ */
+static void* uartTxThread(void* pArgument)
+{
+    UARTHostInstance_t* pUART = (UARTHostInstance_t*)pArgument;
+
+    pthread_mutex_lock(&pUART->txLock);
+
+    while (atomic_load(&pUART->running))
+    {
+        uint32_t index = 0;
+        uint32_t count = uartTxRingNext(&pUART->txRing, UART_TX_CHUNK, &index);
+
+        if (count == 0)
+        {
+            pthread_cond_wait(&pUART->txCondition, &pUART->txLock);
+            continue;
+        }
+
+        /* The running transfer is never overwritten, so it is written without the lock */
+        const uint8_t* chunk = &pUART->txRing.buffer[index];
+        uartTxRingStart(&pUART->txRing, count);
+
+        pthread_mutex_unlock(&pUART->txLock);
+
+        uint32_t written = 0;
+        while (written < count)
+        {
+            ssize_t result = write(pUART->fd, chunk + written, count - written);
+            if (result <= 0)
+            {
+                break;
+            }
+            written += (uint32_t)result;
+        }
+
+        uartPace(pUART, count);
+
+        pthread_mutex_lock(&pUART->txLock);
+
+        uartTxRingComplete(&pUART->txRing, written);
+        pthread_cond_broadcast(&pUART->txCondition);
+    }
+
+    pthread_mutex_unlock(&pUART->txLock);
+
+    return 0;
+}
+
+/**
+ * @brief Applies the configured faults to a received chunk
+ *
+ * @param pUART         Port instance
+ * @param pData         Received bytes, modified in place
+ * @param count         Number of received bytes
+ *
+ * @return Number of bytes left after dropping
+ */
+static uint32_t uartApplyFaults(UARTHostInstance_t* pUART, uint8_t* pData, uint32_t count)
+{
+    uint32_t kept = 0;
+
+    pthread_mutex_lock(&pUART->faultLock);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t data = pData[i];
+
+        if (pUART->faults.dropPpm != 0 && (uartRandom(pUART) % PPM) < pUART->faults.dropPpm)
+        {
+            pUART->hostStats.bytesDropped++;
+            continue;
+        }
+
+        if (pUART->burstRemaining == 0 && pUART->faults.burstPpm != 0 && (uartRandom(pUART) % PPM) < pUART->faults.burstPpm)
+        {
+            pUART->burstRemaining = pUART->faults.burstLength;
+            pUART->hostStats.bursts++;
+        }
+
+        if (pUART->burstRemaining != 0)
+        {
+            data = (uint8_t)uartRandom(pUART);
+            pUART->burstRemaining--;
+        }
+        else if (pUART->faults.bitFlipPpm != 0 && (uartRandom(pUART) % PPM) < pUART->faults.bitFlipPpm)
+        {
+            data ^= (uint8_t)(1U << (uartRandom(pUART) % 8));
+            pUART->hostStats.bitsFlipped++;
+        }
+
+        pData[kept++] = data;
+    }
+
+    pthread_mutex_unlock(&pUART->faultLock);
+
+    return kept;
+}
+
+/**
+ * @brief Random generator for the fault injection (xorshift32)
+ *
+ * @param pUART         Port instance
+ *
+ * @return Next random value
+ */
+static uint32_t uartRandom(UARTHostInstance_t* pUART)
+{
+    pUART->randomState ^= pUART->randomState << 13;
+    pUART->randomState ^= pUART->randomState >> 17;
+    pUART->randomState ^= pUART->randomState << 5;
+
+    return pUART->randomState;
+}
+
+/**
+ * @brief Sleeps for the time the transfer of the bytes takes at the baudrate
+ *
+ * @param pUART         Port instance
+ * @param byteCount     Number of transferred bytes
+ */
+static void uartPace(UARTHostInstance_t* pUART, uint32_t byteCount)
+{
+    if (!atomic_load(&gPacing) || pUART->baudrate == 0)
+    {
+        return;
+    }
+
+    uint64_t nanoseconds = (uint64_t)byteCount * UART_BITS_PER_BYTE * 1000000000ULL / pUART->baudrate;
+    struct timespec duration = { (time_t)(nanoseconds / 1000000000ULL), (long)(nanoseconds % 1000000000ULL) };
+
+    nanosleep(&duration, 0);
+}
+
+/**
+ * @brief Returns the number of valid bytes in the RX ring buffer
+ *
+ * The fence pairs with the one of the receive thread, so the published
+ * bytes are visible before they are copied.
+ *
+ * @param pUART         Port instance
+ *
+ * @return Number of bytes which can be read
+ */
+static uint32_t uartRxPending(UARTHostInstance_t* pUART)
+{
+    uint32_t pending = uartRxRingPending(&pUART->rxRing);
+
+    atomic_thread_fence(memory_order_acquire);
+
+    return pending;
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * @file UARTModuleHost.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host specific extensions of the host implementation of the UART
+ * module (see UARTModule.h for the common API)
+ *
+ * On the host, the UART is a Linux pseudo-terminal (or any other file
+ * descriptor, e.g. one end of a socketpair). A receive thread emulates the
+ * RX DMA, a transmit thread drains the TX ring buffer. Both are paced to the
+ * configured baudrate and the receive path can inject faults. Every port
+ * has its own pseudo-terminal, threads and fault injection.
+ *
+ *****************************************************************************/
+#ifndef _UART_MODULE_HOST_H_
+#define _UART_MODULE_HOST_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "UARTModule.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Faults injected into the received byte stream
+ *
+ * Probabilities are given in ppm per received byte.
+ */
+typedef struct _UARTHostFaults_
+{
+    uint32_t dropPpm;                   //!< Probability that a byte is lost
+    uint32_t bitFlipPpm;                //!< Probability that a single bit of a byte is flipped
+    uint32_t burstPpm;                  //!< Probability that a burst of corrupted bytes starts
+    uint32_t burstLength;               //!< Number of bytes replaced by random values in a burst
+    uint32_t seed;                      //!< Seed of the random generator (0 = fixed default)
+} UARTHostFaults_t;
+
+/**
+ * @brief Counters of the injected faults
+ *
+ */
+typedef struct _UARTHostStats_
+{
+    uint32_t bytesDropped;              //!< Number of dropped bytes
+    uint32_t bitsFlipped;               //!< Number of flipped bits
+    uint32_t bursts;                    //!< Number of corrupted bursts
+} UARTHostStats_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Uses an already opened file descriptor as UART instead of a new
+ * pseudo-terminal
+ *
+ * Must be called before uartInitialize(). The descriptor is closed by
+ * uartStopReception().
+ *
+ * @param port          UART port
+ * @param fd            File descriptor (e.g. one end of a socketpair)
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartHostAttach(UARTPort_t port, int fd);
+
+/**
+ * @brief Returns the path of the pseudo-terminal slave the peer has to open
+ *
+ * @param port          UART port
+ *
+ * @return Path of the slave device, empty if no pseudo-terminal is used
+ */
+const char* uartHostGetPortName(UARTPort_t port);
+
+/**
+ * @brief Enables or disables the pacing of the transfers to the baudrate
+ *
+ * Without pacing, data is passed as fast as the host allows (default: on).
+ * Applies to all ports.
+ *
+ * @param enable        1 to pace the transfers, 0 to disable the pacing
+ */
+void uartHostSetPacing(int32_t enable);
+
+/**
+ * @brief Configures the faults injected into the received byte stream
+ *
+ * @param port          UART port
+ * @param pFaults       Fault configuration, 0 disables the fault injection
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartHostSetFaults(UARTPort_t port, const UARTHostFaults_t* pFaults);
+
+/**
+ * @brief Returns the counters of the injected faults
+ *
+ * @param port          UART port
+ * @param pStats        Pointer to store the counters to
+ *
+ * @return Returns UART_ERR_OK if no error occured, otherwise UART_ERR_INVALID_PARAM
+ */
+int32_t uartHostGetStats(UARTPort_t port, UARTHostStats_t* pStats);
+
+#endif
@@ -0,0 +1,388 @@
+/******************************************************************************
+ * @file test_alarm.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host test of the time-over-threshold alarm engine
+ *
+ * The gas rules of the application (warning and emergency) post their
+ * events into a state table with the alarm transitions of the application.
+ * The test covers the hold time, dips within and below the hysteresis, the
+ * re-arm after the condition ended or the alarms were acknowledged and the
+ * retry of an event the state table did not accept because another event
+ * was still pending.
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "HostTest.h"
+#include "App/Application.h"
+#include "AlarmEngine/AlarmEngine.h"
+#include "StateTable/StateTable.h"
+#include "GasScale/GasScale.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define TEST_SIGNAL_GAS         0           //!< Signal ID of the gas concentration
+#define TEST_SIGNAL_OTHER       1           //!< Signal ID without rules
+#define TEST_HOLD_WARNING_MS    5000        //!< Hold time of the warning [ms]
+#define TEST_HOLD_EMERGENCY_MS  3000        //!< Hold time of the emergency [ms]
+#define TEST_HYSTERESIS_PPM     100         //!< Hysteresis of the gas rules [ppm]
+#define TEST_CYCLE_MS           10          //!< Period of the updates (10ms task)
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void testSetup(void);
+static int32_t testPostEvent(int32_t eventID);
+static int32_t testRun(int32_t value, uint32_t fromMs, uint32_t toMs);
+static void testParameters(void);
+static void testHoldTime(void);
+static void testHysteresis(void);
+static void testRearm(void);
+static void testAcknowledge(void);
+static void testPendingEvent(void);
+static void testWrapAround(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+/**
+ * @brief Gas rules of the application (see AppTasks.c)
+ */
+static AlarmRule_t gRules[] =
+{
+    {TEST_SIGNAL_GAS,   GAS_PPM_WARNING,    TEST_HOLD_WARNING_MS,   TEST_HYSTERESIS_PPM,    EVT_ID_ALARM_WARNING,   false,  0,  false,  false},
+    {TEST_SIGNAL_GAS,   GAS_PPM_EMERGENCY,  TEST_HOLD_EMERGENCY_MS, TEST_HYSTERESIS_PPM,    EVT_ID_ALARM_EMERGENCY, false,  0,  false,  false},
+};
+
+/**
+ * @brief States and alarm transitions of the application (see Application.c)
+ */
+static State_t gStates[] =
+{
+    {STATE_ID_RUNNING,      0,  0,  0,  false},
+    {STATE_ID_FAILURE,      0,  0,  0,  false},
+    {STATE_ID_WARNING,      0,  0,  0,  false},
+    {STATE_ID_EMERGENCY,    0,  0,  0,  false},
+};
+
+static StateTableEntry_t gEntries[] =
+{
+    {STATE_ID_RUNNING,      STATE_ID_FAILURE,       EVT_ID_SENSOR_FAILED,       0,  0,  0},
+    {STATE_ID_RUNNING,      STATE_ID_WARNING,       EVT_ID_ALARM_WARNING,       0,  0,  0},
+    {STATE_ID_RUNNING,      STATE_ID_EMERGENCY,     EVT_ID_ALARM_EMERGENCY,     0,  0,  0},
+    {STATE_ID_WARNING,      STATE_ID_EMERGENCY,     EVT_ID_ALARM_EMERGENCY,     0,  0,  0},
+    {STATE_ID_WARNING,      STATE_ID_RUNNING,       EVT_ID_ALARM_RESET,         0,  0,  0},
+    {STATE_ID_WARNING,      STATE_ID_FAILURE,       EVT_ID_SENSOR_FAILED,       0,  0,  0},
+    {STATE_ID_EMERGENCY,    STATE_ID_RUNNING,       EVT_ID_ALARM_RESET,         0,  0,  0},
+    {STATE_ID_EMERGENCY,    STATE_ID_FAILURE,       EVT_ID_SENSOR_FAILED,       0,  0,  0},
+};
+
+static StateTable_t gStateTable;            //!< State machine which receives the events
+static AlarmEngine_t gEngine;               //!< Engine under test
+static uint32_t gPostCount;                 //!< Calls of the post function
+static uint32_t gAcceptedCount;             //!< Events accepted by the state table
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(void)
+{
+    testParameters();
+    testHoldTime();
+    testHysteresis();
+    testRearm();
+    testAcknowledge();
+    testPendingEvent();
+    testWrapAround();
+
+    return hostTestResult("test_alarm");
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Resets the engine and puts the state table into Running
+ */
+static void testSetup(void)
+{
+    gStateTable.pStateList = gStates;
+    gStateTable.stateCount = sizeof(gStates) / sizeof(State_t);
+    gStateTable.pendingEvent = STT_NONE_EVENT;
+    stateTableInitialize(&gStateTable, gEntries, sizeof(gEntries) / sizeof(StateTableEntry_t), STATE_ID_RUNNING);
+
+    alarmEngineInitialize(&gEngine, gRules, sizeof(gRules) / sizeof(AlarmRule_t), testPostEvent);
+
+    gPostCount = 0;
+    gAcceptedCount = 0;
+}
+
+/**
+ * @brief Posts an event to the state table like sameplAppSendEvent()
+ *
+ * @param eventID       Event to post
+ *
+ * @return 0 if the event has been accepted
+ */
+static int32_t testPostEvent(int32_t eventID)
+{
+    int32_t result = stateTableSendEvent(&gStateTable, eventID);
+
+    gPostCount++;
+    if (result == STATETBL_ERR_OK)
+    {
+        gAcceptedCount++;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Feeds a constant value every cycle and runs the state table after
+ * each update like taskApp10ms()
+ *
+ * @param value         Value of the gas signal [ppm]
+ * @param fromMs        Time stamp of the first update [ms]
+ * @param toMs          Time stamp of the last update [ms]
+ *
+ * @return Number of active alarms after the last update
+ */
+static int32_t testRun(int32_t value, uint32_t fromMs, uint32_t toMs)
+{
+    int32_t activeCount = 0;
+
+    for (uint32_t nowMs = fromMs; (int32_t)(toMs - nowMs) >= 0; nowMs += TEST_CYCLE_MS)
+    {
+        activeCount = alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, value, nowMs);
+        stateTableRunCyclic(&gStateTable);
+    }
+
+    return activeCount;
+}
+
+/**
+ * @brief Invalid tables and pointers are rejected
+ */
+static void testParameters(void)
+{
+    AlarmRule_t rule = {TEST_SIGNAL_GAS, GAS_PPM_WARNING, 0, -1, EVT_ID_ALARM_WARNING, false, 0, false, false};
+
+    HOST_TEST_CHECK(alarmEngineInitialize(0, gRules, 1, 0) == ALARM_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(alarmEngineInitialize(&gEngine, 0, 1, 0) == ALARM_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(alarmEngineInitialize(&gEngine, gRules, -1, 0) == ALARM_ERR_INVALID_PARAM);
+    HOST_TEST_CHECK(alarmEngineInitialize(&gEngine, &rule, 1, 0) == ALARM_ERR_INVALID_PARAM);
+    HOST_TEST_CHECK(alarmEngineUpdate(0, TEST_SIGNAL_GAS, 0, 0) == ALARM_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(alarmEngineResetSignal(0, TEST_SIGNAL_GAS) == ALARM_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(!alarmEngineIsActive(0, EVT_ID_ALARM_WARNING));
+
+    // Without post function the alarm is only reported by the return value
+    HOST_TEST_CHECK(alarmEngineInitialize(&gEngine, gRules, sizeof(gRules) / sizeof(AlarmRule_t), 0) == ALARM_ERR_OK);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, 0) == 0);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS) == 1);
+}
+
+/**
+ * @brief The event is posted exactly once, when the signal stayed above the
+ * threshold for the hold time
+ */
+static void testHoldTime(void)
+{
+    testSetup();
+
+    // The threshold itself is not above the threshold
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING, 0, 2 * TEST_HOLD_WARNING_MS) == 0);
+    HOST_TEST_CHECK(gPostCount == 0);
+
+    // One cycle before the hold time has elapsed nothing is posted
+    uint32_t startMs = 2 * TEST_HOLD_WARNING_MS + TEST_CYCLE_MS;
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, startMs, startMs + TEST_HOLD_WARNING_MS - TEST_CYCLE_MS) == 0);
+    HOST_TEST_CHECK(gPostCount == 0);
+    HOST_TEST_CHECK(!alarmEngineIsActive(&gEngine, EVT_ID_ALARM_WARNING));
+
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, startMs + TEST_HOLD_WARNING_MS, startMs + TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 1 && gAcceptedCount == 1);
+    HOST_TEST_CHECK(alarmEngineIsActive(&gEngine, EVT_ID_ALARM_WARNING));
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_WARNING);
+
+    // An active alarm does not post its event again
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, startMs + TEST_HOLD_WARNING_MS + TEST_CYCLE_MS, startMs + 4 * TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 1);
+
+    // Samples of other signals do not touch the gas rules
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_OTHER, 0, startMs + 4 * TEST_HOLD_WARNING_MS) == 0);
+    HOST_TEST_CHECK(alarmEngineIsActive(&gEngine, EVT_ID_ALARM_WARNING));
+
+    // Above the emergency threshold, the shorter hold time of the emergency
+    // rule starts with its own first exceeding sample
+    startMs += 4 * TEST_HOLD_WARNING_MS + TEST_CYCLE_MS;
+    HOST_TEST_CHECK(testRun(GAS_PPM_EMERGENCY + 1, startMs, startMs + TEST_HOLD_EMERGENCY_MS - TEST_CYCLE_MS) == 1);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_WARNING);
+    HOST_TEST_CHECK(testRun(GAS_PPM_EMERGENCY + 1, startMs + TEST_HOLD_EMERGENCY_MS, startMs + TEST_HOLD_EMERGENCY_MS) == 2);
+    HOST_TEST_CHECK(gPostCount == 2 && gAcceptedCount == 2);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_EMERGENCY);
+}
+
+/**
+ * @brief Dips within the hysteresis keep the hold time running, a dip to
+ * the threshold minus the hysteresis restarts it
+ */
+static void testHysteresis(void)
+{
+    testSetup();
+
+    // Dip to one ppm above the lower bound of the hysteresis band
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 0, 2000) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING - TEST_HYSTERESIS_PPM + 1, 2010, 3000) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 3010, TEST_HOLD_WARNING_MS - TEST_CYCLE_MS) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS, TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gAcceptedCount == 1);
+
+    // The hold time is measured from the first exceeding sample, so it
+    // also elapses while the signal is within the hysteresis band
+    testSetup();
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 0, 0) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING - TEST_HYSTERESIS_PPM + 1, TEST_CYCLE_MS, TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_WARNING);
+
+    // Dip to the lower bound of the hysteresis band restarts the hold time
+    testSetup();
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 0, 2000) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING - TEST_HYSTERESIS_PPM, 2010, 2010) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 2020, 2020 + TEST_HOLD_WARNING_MS - TEST_CYCLE_MS) == 0);
+    HOST_TEST_CHECK(gPostCount == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 2020 + TEST_HOLD_WARNING_MS, 2020 + TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gAcceptedCount == 1);
+}
+
+/**
+ * @brief An active alarm stays active within the hysteresis and is re-armed
+ * once the signal dropped below it, the next crossing posts again
+ */
+static void testRearm(void)
+{
+    testSetup();
+
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 0, TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gAcceptedCount == 1);
+
+    // Within the hysteresis the alarm stays active and is not posted again
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING - TEST_HYSTERESIS_PPM + 1, 5010, 8000) == 1);
+    HOST_TEST_CHECK(gPostCount == 1);
+
+    // Below the hysteresis the rule is re-armed
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING - TEST_HYSTERESIS_PPM, 8010, 8010) == 0);
+    HOST_TEST_CHECK(!alarmEngineIsActive(&gEngine, EVT_ID_ALARM_WARNING));
+
+    // The state machine is still in Warning until the acknowledge
+    HOST_TEST_CHECK(testPostEvent(EVT_ID_ALARM_RESET) == STATETBL_ERR_OK);
+    stateTableRunCyclic(&gStateTable);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_RUNNING);
+
+    // The next crossing has to elapse the full hold time again
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 9000, 9000 + TEST_HOLD_WARNING_MS - TEST_CYCLE_MS) == 0);
+    HOST_TEST_CHECK(gPostCount == 2);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 9000 + TEST_HOLD_WARNING_MS, 9000 + TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 3 && gAcceptedCount == 3);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_WARNING);
+}
+
+/**
+ * @brief After the acknowledge (reset of the signal) a condition which is
+ * still present raises the alarm again after its hold time
+ */
+static void testAcknowledge(void)
+{
+    testSetup();
+
+    HOST_TEST_CHECK(testRun(GAS_PPM_EMERGENCY + 1, 0, TEST_HOLD_WARNING_MS) == 2);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_EMERGENCY);
+
+    // Acknowledge like taskApp10ms(): reset the signal, post the reset
+    HOST_TEST_CHECK(alarmEngineResetSignal(&gEngine, TEST_SIGNAL_GAS) == ALARM_ERR_OK);
+    HOST_TEST_CHECK(!alarmEngineIsActive(&gEngine, EVT_ID_ALARM_WARNING));
+    HOST_TEST_CHECK(!alarmEngineIsActive(&gEngine, EVT_ID_ALARM_EMERGENCY));
+    HOST_TEST_CHECK(testPostEvent(EVT_ID_ALARM_RESET) == STATETBL_ERR_OK);
+    stateTableRunCyclic(&gStateTable);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_RUNNING);
+
+    uint32_t postCount = gPostCount;
+    uint32_t startMs = TEST_HOLD_WARNING_MS + TEST_CYCLE_MS;
+    HOST_TEST_CHECK(testRun(GAS_PPM_EMERGENCY + 1, startMs, startMs + TEST_HOLD_EMERGENCY_MS - TEST_CYCLE_MS) == 0);
+    HOST_TEST_CHECK(gPostCount == postCount);
+    HOST_TEST_CHECK(testRun(GAS_PPM_EMERGENCY + 1, startMs + TEST_HOLD_EMERGENCY_MS, startMs + TEST_HOLD_EMERGENCY_MS) == 1);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_EMERGENCY);
+}
+
+/**
+ * @brief An event which is not accepted because another event is pending
+ * is posted again with the next sample until the state table takes it
+ */
+static void testPendingEvent(void)
+{
+    testSetup();
+
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, 0, TEST_HOLD_WARNING_MS - TEST_CYCLE_MS) == 0);
+
+    // The sensor failure is posted first in the same cycle
+    HOST_TEST_CHECK(stateTableSendEvent(&gStateTable, EVT_ID_SENSOR_FAILED) == STATETBL_ERR_OK);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 1 && gAcceptedCount == 0);
+    HOST_TEST_CHECK(!gRules[0].eventPosted);
+
+    // While the table is busy, every sample retries the post
+    HOST_TEST_CHECK(stateTableSendEvent(&gStateTable, EVT_ID_SENSOR_FAILED) == STATETBL_ERR_EVENT_PENDING);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS + TEST_CYCLE_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 2 && gAcceptedCount == 0);
+
+    // The state table takes the sensor failure, the alarm is posted with
+    // the next sample and lands in the pending slot
+    stateTableRunCyclic(&gStateTable);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_FAILURE);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS + 2 * TEST_CYCLE_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 3 && gAcceptedCount == 1);
+    HOST_TEST_CHECK(gRules[0].eventPosted);
+    HOST_TEST_CHECK(gStateTable.pendingEvent == EVT_ID_ALARM_WARNING);
+
+    // Once accepted it is not posted again
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS + 3 * TEST_CYCLE_MS, 3 * TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gPostCount == 3);
+
+    // An event the state machine does not handle only delays the warning
+    // until the next cycle
+    testSetup();
+    HOST_TEST_CHECK(stateTableSendEvent(&gStateTable, EVT_ID_ALARM_RESET) == STATETBL_ERR_OK);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, 0) == 0);
+    HOST_TEST_CHECK(alarmEngineUpdate(&gEngine, TEST_SIGNAL_GAS, GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gAcceptedCount == 0);
+    stateTableRunCyclic(&gStateTable);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, TEST_HOLD_WARNING_MS + TEST_CYCLE_MS, TEST_HOLD_WARNING_MS + TEST_CYCLE_MS) == 1);
+    HOST_TEST_CHECK(gAcceptedCount == 1);
+    HOST_TEST_CHECK(gStateTable.currentStateID == STATE_ID_WARNING);
+}
+
+/**
+ * @brief The hold time is measured correctly across the wrap around of the
+ * millisecond tick
+ */
+static void testWrapAround(void)
+{
+    testSetup();
+
+    uint32_t startMs = UINT32_MAX - 2000;
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, startMs, startMs + TEST_HOLD_WARNING_MS - TEST_CYCLE_MS) == 0);
+    HOST_TEST_CHECK(testRun(GAS_PPM_WARNING + 1, startMs + TEST_HOLD_WARNING_MS, startMs + TEST_HOLD_WARNING_MS) == 1);
+    HOST_TEST_CHECK(gAcceptedCount == 1);
+}
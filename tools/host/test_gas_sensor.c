@@ -0,0 +1,302 @@
+/******************************************************************************
+ * @file test_gas_sensor.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host test of the dual channel gas sensor
+ *
+ * The conversion by multiply and shift is compared with the division of
+ * gasScaleMicroVoltToPpm() for every µV of the ADC input range. The range
+ * check is tested at the 0.5 V and 2.5 V bounds and the consistency check
+ * at the 10 % limit with either channel above the other. The comparator
+ * threshold is checked at the ppm trip points and at the DAC limits.
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "HostTest.h"
+#include "DualChannelGasSensor.h"
+#include "GasScale/GasScale.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define TEST_MICROVOLT_FIRST        -100000     //!< First voltage of the conversion test [µV]
+#define TEST_MICROVOLT_LAST         3300000     //!< Last voltage of the conversion test [µV]
+#define TEST_PPM_STEP               7           //!< Step of the first channel in the consistency test [ppm]
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void testConversion(void);
+static void testRange(void);
+static void testConsistency(void);
+static void testSensorConsistency(void);
+static void testSnapshot(void);
+static void testDacThreshold(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(void)
+{
+    testConversion();
+    testRange();
+    testConsistency();
+    testSensorConsistency();
+    testSnapshot();
+    testDacThreshold();
+
+    return hostTestResult("test_gas_sensor");
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief The conversion matches gasScaleMicroVoltToPpm() over the whole
+ * input range, including the limited values outside of 0.5 V .. 2.5 V
+ */
+static void testConversion(void)
+{
+    uint32_t mismatches = 0;
+
+    for (int32_t microVolt = TEST_MICROVOLT_FIRST; microVolt <= TEST_MICROVOLT_LAST; microVolt++)
+    {
+        int32_t expected = gasScaleMicroVoltToPpm(microVolt);
+        int32_t ppm = gasSensorMicroVoltToPpm(microVolt);
+
+        if (ppm != expected)
+        {
+            if (mismatches < 10)
+            {
+                fprintf(stderr, "  %d uV: %d ppm, expected %d ppm\n", microVolt, ppm, expected);
+            }
+            mismatches++;
+        }
+    }
+
+    HOST_TEST_CHECK(mismatches == 0);
+
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(GAS_MICROVOLT_MIN) == GAS_PPM_MIN);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(GAS_MICROVOLT_MAX) == GAS_PPM_MAX);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(GAS_MICROVOLT_MIN - 1) == GAS_PPM_MIN);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(GAS_MICROVOLT_MAX + 1) == GAS_PPM_MAX);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(INT32_MIN) == GAS_PPM_MIN);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(INT32_MAX) == GAS_PPM_MAX);
+
+    // 1 ppm per 204.08 µV, the halves are rounded up
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(GAS_MICROVOLT_MIN + 102) == GAS_PPM_MIN);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(GAS_MICROVOLT_MIN + 103) == GAS_PPM_MIN + 1);
+    HOST_TEST_CHECK(gasSensorMicroVoltToPpm(gasScalePpmToMicroVolt(GAS_PPM_EMERGENCY)) == GAS_PPM_EMERGENCY);
+}
+
+/**
+ * @brief Samples outside of 0.5 V .. 2.5 V flag the channel as defect
+ */
+static void testRange(void)
+{
+    DualChannelGasSensor_t sensor;
+    int32_t ppm = 0;
+
+    HOST_TEST_CHECK(gasSensorInitialize(0) == GAS_SENSOR_ERR_INVALID_PARAM);
+    HOST_TEST_CHECK(gasSensorInitialize(&sensor) == GAS_SENSOR_ERR_OK);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_NO_DATA);
+    HOST_TEST_CHECK(gasSensorProcess(0, GAS_MICROVOLT_MIN, GAS_MICROVOLT_MIN) == GAS_SENSOR_ERR_INVALID_PARAM);
+
+    // Both bounds are valid
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, GAS_MICROVOLT_MIN, GAS_MICROVOLT_MIN) == GAS_SENSOR_ERR_OK);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_OK && ppm == GAS_PPM_MIN);
+
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, GAS_MICROVOLT_MAX, GAS_MICROVOLT_MAX) == GAS_SENSOR_ERR_OK);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_OK && ppm == GAS_PPM_MAX);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == 0);
+
+    // One µV outside, the filtered value does not hide the defect
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, GAS_MICROVOLT_MIN - 1, GAS_MICROVOLT_MIN) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == GAS_SENSOR_FLAG_RANGE_CH1);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_DEFECT && ppm == GAS_PPM_MIN);
+
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, GAS_MICROVOLT_MAX, GAS_MICROVOLT_MAX + 1) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == GAS_SENSOR_FLAG_RANGE_CH2);
+
+    // Broken wire and short circuit to the supply on both channels
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, 0, 3300000) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == (GAS_SENSOR_FLAG_RANGE_CH1 | GAS_SENSOR_FLAG_RANGE_CH2));
+    HOST_TEST_CHECK(sensor.channel[0].rangeErrors == 1 && sensor.channel[1].rangeErrors == 1);
+    HOST_TEST_CHECK(sensor.inconsistencies == 0);
+
+    // The range defect ends with the next valid sample, the filtered
+    // channels still disagree until they have settled
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, 1500000, 1500000) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == GAS_SENSOR_FLAG_INCONSISTENT);
+}
+
+/**
+ * @brief The channels may differ by 10 % of their mean, with either
+ * channel above the other
+ */
+static void testConsistency(void)
+{
+    // 105 <= 105.25 and 106 > 105.3
+    HOST_TEST_CHECK(gasSensorIsConsistent(1000, 1105));
+    HOST_TEST_CHECK(gasSensorIsConsistent(1105, 1000));
+    HOST_TEST_CHECK(!gasSensorIsConsistent(1000, 1106));
+    HOST_TEST_CHECK(!gasSensorIsConsistent(1106, 1000));
+
+    // Exactly 10 % is consistent
+    HOST_TEST_CHECK(gasSensorIsConsistent(950, 1050));
+    HOST_TEST_CHECK(gasSensorIsConsistent(1050, 950));
+    HOST_TEST_CHECK(!gasSensorIsConsistent(949, 1050));
+    HOST_TEST_CHECK(!gasSensorIsConsistent(1050, 949));
+
+    // Ends of the measurement range
+    HOST_TEST_CHECK(gasSensorIsConsistent(GAS_PPM_MIN, GAS_PPM_MIN + 21));
+    HOST_TEST_CHECK(!gasSensorIsConsistent(GAS_PPM_MIN + 22, GAS_PPM_MIN));
+    HOST_TEST_CHECK(gasSensorIsConsistent(GAS_PPM_MAX, GAS_PPM_MAX - 952));
+    HOST_TEST_CHECK(!gasSensorIsConsistent(GAS_PPM_MAX - 953, GAS_PPM_MAX));
+
+    // Floating point reference over the measurement range (ties are covered above)
+    uint32_t mismatches = 0;
+
+    for (int32_t ppm1 = GAS_PPM_MIN; ppm1 <= GAS_PPM_MAX; ppm1 += TEST_PPM_STEP)
+    {
+        for (int32_t ppm2 = GAS_PPM_MIN; ppm2 <= GAS_PPM_MAX; ppm2++)
+        {
+            double difference = (ppm1 > ppm2) ? (ppm1 - ppm2) : (ppm2 - ppm1);
+            double limit = GAS_SENSOR_MAX_DEVIATION_PCT / 100.0 * (ppm1 + ppm2) / 2.0;
+
+            if (difference - limit > 1e-6 || difference - limit < -1e-6)
+            {
+                if (gasSensorIsConsistent(ppm1, ppm2) != (difference < limit))
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    HOST_TEST_CHECK(mismatches == 0);
+}
+
+/**
+ * @brief Inconsistent channels are flagged and counted by the sensor
+ */
+static void testSensorConsistency(void)
+{
+    DualChannelGasSensor_t sensor;
+    int32_t ppm = 0;
+
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, gasScalePpmToMicroVolt(1000), gasScalePpmToMicroVolt(1105)) == GAS_SENSOR_ERR_OK);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_OK && ppm == 1053);
+
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, gasScalePpmToMicroVolt(1000), gasScalePpmToMicroVolt(1106)) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == GAS_SENSOR_FLAG_INCONSISTENT);
+
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, gasScalePpmToMicroVolt(1106), gasScalePpmToMicroVolt(1000)) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == GAS_SENSOR_FLAG_INCONSISTENT);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_DEFECT && ppm == 1053);
+    HOST_TEST_CHECK(sensor.inconsistencies == 1);
+
+    // After a fault of one channel the filtered channels agree again once
+    // the difference has decayed by 0.75 per sample to 10 %
+    gasSensorInitialize(&sensor);
+    HOST_TEST_CHECK(gasSensorProcess(&sensor, gasScalePpmToMicroVolt(1000), gasScalePpmToMicroVolt(2000)) == GAS_SENSOR_ERR_DEFECT);
+
+    int32_t samples = 0;
+    do
+    {
+        samples++;
+    } while (gasSensorProcess(&sensor, gasScalePpmToMicroVolt(1000), gasScalePpmToMicroVolt(1000)) != GAS_SENSOR_ERR_OK && samples < 100);
+
+    HOST_TEST_CHECK(samples > 1 && samples < 20);
+    HOST_TEST_CHECK(sensor.inconsistencies == (uint32_t)samples);
+}
+
+/**
+ * @brief Snapshots are converted with ADC_MICROVOLTS_PER_DIGIT and a
+ * snapshot is only processed once
+ */
+static void testSnapshot(void)
+{
+    DualChannelGasSensor_t sensor;
+    ADCSnapshot_t snapshot = { 0 };
+    int32_t ppm = 0;
+
+    gasSensorInitialize(&sensor);
+    snapshot.sequenceNumber = 1;
+    snapshot.rawValues[ADC_INPUT0] = 2000;
+    snapshot.rawValues[ADC_INPUT1] = 2000;
+
+    HOST_TEST_CHECK(gasSensorProcessSnapshot(&sensor, 0) == GAS_SENSOR_ERR_INVALID_PARAM);
+    HOST_TEST_CHECK(gasSensorProcessSnapshot(&sensor, &snapshot) == GAS_SENSOR_ERR_OK);
+    HOST_TEST_CHECK(sensor.channel[0].microVolt == 2000 * ADC_MICROVOLTS_PER_DIGIT);
+    HOST_TEST_CHECK(gasSensorGetPpm(&sensor, &ppm) == GAS_SENSOR_ERR_OK &&
+                    ppm == gasScaleMicroVoltToPpm(2000 * ADC_MICROVOLTS_PER_DIGIT));
+
+    // Same sequence number, the sample is not counted again
+    HOST_TEST_CHECK(gasSensorProcessSnapshot(&sensor, &snapshot) == GAS_SENSOR_ERR_OK);
+    HOST_TEST_CHECK(sensor.samples == 1);
+
+    // Full scale of the ADC is above 2.5 V
+    snapshot.sequenceNumber = 2;
+    snapshot.rawValues[ADC_INPUT1] = 4095;
+    HOST_TEST_CHECK(gasSensorProcessSnapshot(&sensor, &snapshot) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(gasSensorGetFlags(&sensor) == GAS_SENSOR_FLAG_RANGE_CH2);
+    HOST_TEST_CHECK(gasSensorProcessSnapshot(&sensor, &snapshot) == GAS_SENSOR_ERR_DEFECT);
+    HOST_TEST_CHECK(sensor.samples == 2);
+}
+
+/**
+ * @brief The DAC value at the trip points reproduces the voltage within half
+ * a digit, values outside of the DAC range are limited
+ */
+static void testDacThreshold(void)
+{
+    int32_t warningMicroVolt = gasScalePpmToMicroVolt(GAS_PPM_WARNING);
+    int32_t emergencyMicroVolt = gasScalePpmToMicroVolt(GAS_PPM_EMERGENCY);
+    int32_t digits = 0;
+
+    // 1071429µV / 805µV = 1330.97
+    digits = gasScaleMicroVoltToDacDigits(warningMicroVolt);
+    HOST_TEST_CHECK(digits == 1331);
+    HOST_TEST_CHECK(digits * ADC_MICROVOLTS_PER_DIGIT - warningMicroVolt <= ADC_MICROVOLTS_PER_DIGIT / 2);
+    HOST_TEST_CHECK(gasScaleMicroVoltToPpm(digits * ADC_MICROVOLTS_PER_DIGIT) == GAS_PPM_WARNING);
+
+    // 1479592µV / 805µV = 1838.00
+    digits = gasScaleMicroVoltToDacDigits(emergencyMicroVolt);
+    HOST_TEST_CHECK(digits == 1838);
+    HOST_TEST_CHECK(emergencyMicroVolt - digits * ADC_MICROVOLTS_PER_DIGIT <= ADC_MICROVOLTS_PER_DIGIT / 2);
+    HOST_TEST_CHECK(gasScaleMicroVoltToPpm(digits * ADC_MICROVOLTS_PER_DIGIT) == GAS_PPM_EMERGENCY);
+
+    // Rounding at half a digit
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(ADC_MICROVOLTS_PER_DIGIT / 2) == 0);
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(ADC_MICROVOLTS_PER_DIGIT / 2 + 1) == 1);
+
+    // Limits of the 12 bit DAC
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(-1) == 0);
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(INT32_MIN) == 0);
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(GAS_DAC_MAX_DIGITS * ADC_MICROVOLTS_PER_DIGIT) == GAS_DAC_MAX_DIGITS);
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(3300000) == GAS_DAC_MAX_DIGITS);
+    HOST_TEST_CHECK(gasScaleMicroVoltToDacDigits(INT32_MAX) == GAS_DAC_MAX_DIGITS);
+}
@@ -0,0 +1,214 @@
+/******************************************************************************
+ * @file test_scheduler.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host test of the cyclic scheduler
+ *
+ * The HAL tick is simulated. The test checks that every slot runs at its
+ * period, that a late task is started only once and realigned, and that
+ * the wrap around of the tick does not change the periods.
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "HostTest.h"
+#include "Scheduler.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t testGetTick(void);
+static void testTask1ms(void);
+static void testTask10ms(void);
+static void testTask250ms(void);
+static void testSetup(uint32_t startTick);
+static void testRunUntil(uint32_t endTick);
+static void testParameters(void);
+static void testPeriods(void);
+static void testLateTask(void);
+static void testWrapAround(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static Scheduler gScheduler;                //!< Scheduler under test
+static uint32_t gTick;                      //!< Simulated HAL tick
+static uint32_t gCount1ms;                  //!< Runs of the 1ms task
+static uint32_t gCount10ms;                 //!< Runs of the 10ms task
+static uint32_t gCount250ms;                //!< Runs of the 250ms task
+static uint32_t gLastTick250ms;             //!< Tick of the last run of the 250ms task
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(void)
+{
+    testParameters();
+    testPeriods();
+    testLateTask();
+    testWrapAround();
+
+    return hostTestResult("test_scheduler");
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+static uint32_t testGetTick(void)
+{
+    return gTick;
+}
+
+static void testTask1ms(void)
+{
+    gCount1ms++;
+}
+
+static void testTask10ms(void)
+{
+    gCount10ms++;
+}
+
+static void testTask250ms(void)
+{
+    gCount250ms++;
+    gLastTick250ms = gTick;
+}
+
+/**
+ * @brief Initializes the scheduler with the 1ms, 10ms and 250ms test tasks
+ *
+ * @param startTick     HAL tick at the initialization
+ */
+static void testSetup(uint32_t startTick)
+{
+    Scheduler scheduler = { 0 };
+
+    gScheduler = scheduler;
+    gScheduler.pGetHALTick  = testGetTick;
+    gScheduler.pTask_1ms    = testTask1ms;
+    gScheduler.pTask_10ms   = testTask10ms;
+    gScheduler.pTask_250ms  = testTask250ms;
+
+    gTick = startTick;
+    gCount1ms = 0;
+    gCount10ms = 0;
+    gCount250ms = 0;
+    gLastTick250ms = startTick;
+
+    HOST_TEST_CHECK(schedInitialize(&gScheduler) == SCHED_ERR_OK);
+}
+
+/**
+ * @brief Calls the scheduler several times per tick up to the given tick
+ *
+ * @param endTick       Last HAL tick
+ */
+static void testRunUntil(uint32_t endTick)
+{
+    while (1)
+    {
+        schedCycle(&gScheduler);
+        schedCycle(&gScheduler);
+
+        if (gTick == endTick)
+        {
+            break;
+        }
+        gTick++;
+    }
+}
+
+/**
+ * @brief Missing scheduler or tick function are rejected
+ */
+static void testParameters(void)
+{
+    Scheduler scheduler = { 0 };
+
+    HOST_TEST_CHECK(schedInitialize(0) == SCHED_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(schedCycle(0) == SCHED_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(schedInitialize(&scheduler) == SCHED_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(schedCycle(&scheduler) == SCHED_ERR_INVALID_PTR);
+}
+
+/**
+ * @brief Each slot runs once per period, unused slots are skipped
+ */
+static void testPeriods(void)
+{
+    testSetup(1000);
+
+    // Nothing runs before the first period has elapsed
+    schedCycle(&gScheduler);
+    HOST_TEST_CHECK(gCount1ms == 0 && gCount10ms == 0 && gCount250ms == 0);
+
+    testRunUntil(1000 + 10000);
+    HOST_TEST_CHECK(gCount1ms == 10000);
+    HOST_TEST_CHECK(gCount10ms == 1000);
+    HOST_TEST_CHECK(gCount250ms == 40);
+    HOST_TEST_CHECK(gLastTick250ms == 1000 + 10000);
+}
+
+/**
+ * @brief A task which is late by several periods is started once and its
+ * slot continues from the current tick
+ */
+static void testLateTask(void)
+{
+    testSetup(0);
+
+    testRunUntil(250);
+    HOST_TEST_CHECK(gCount250ms == 1 && gLastTick250ms == 250);
+
+    // A long task blocks the scheduler for 3 periods and a bit
+    gTick = 250 + 3 * 250 + 20;
+    schedCycle(&gScheduler);
+    HOST_TEST_CHECK(gCount250ms == 2 && gLastTick250ms == 1020);
+
+    // The next run is one period later, not as a burst to catch up
+    testRunUntil(1020 + 249);
+    HOST_TEST_CHECK(gCount250ms == 2);
+    testRunUntil(1020 + 250);
+    HOST_TEST_CHECK(gCount250ms == 3);
+
+    // Late by less than one period keeps the slot aligned
+    gTick = 1270 + 250 + 100;
+    schedCycle(&gScheduler);
+    HOST_TEST_CHECK(gCount250ms == 4);
+    testRunUntil(1270 + 2 * 250 - 1);
+    HOST_TEST_CHECK(gCount250ms == 4);
+    testRunUntil(1270 + 2 * 250);
+    HOST_TEST_CHECK(gCount250ms == 5);
+}
+
+/**
+ * @brief The periods stay the same across the wrap around of the HAL tick
+ */
+static void testWrapAround(void)
+{
+    testSetup(UINT32_MAX - 500);
+
+    testRunUntil(UINT32_MAX);
+    HOST_TEST_CHECK(gCount250ms == 2 && gCount10ms == 50);
+
+    gTick++;
+    testRunUntil(1000 - 501);
+    HOST_TEST_CHECK(gCount250ms == 4);
+    HOST_TEST_CHECK(gCount10ms == 100);
+    HOST_TEST_CHECK(gCount1ms == 1000);
+}
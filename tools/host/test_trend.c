@@ -0,0 +1,353 @@
+/******************************************************************************
+ * @file test_trend.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host test of the trend estimator
+ *
+ * The slope of all window sizes is compared with a floating point least
+ * squares fit of the same samples. Ramps, flat and falling signals check
+ * the exact results, the rounding and the saturation of the time to the
+ * threshold and the posting of the early warning event.
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "HostTest.h"
+#include "TrendEstimator/TrendEstimator.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define TEST_REFERENCE_SAMPLES      1000        //!< Random samples per window size
+#define TEST_REFERENCE_PERIOD_MS    100         //!< Sample period of the reference test
+#define TEST_REFERENCE_RANGE        5000000     //!< Range of the random samples
+#define TEST_EVENT_ID               5           //!< Event ID of the early warning
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int32_t testPostEvent(int32_t eventID);
+static int32_t testRandom(void);
+static void testParameters(void);
+static void testReference(void);
+static void testRamp(void);
+static void testFlatAndFalling(void);
+static void testSaturation(void);
+static void testEarlyWarning(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gRandomState = 1;           //!< State of the random generator (reproducible)
+static uint32_t gPostCalls;                 //!< Number of calls of testPostEvent()
+static uint32_t gPostAccepted;              //!< Number of accepted events
+static uint32_t gPostRejects;               //!< Number of calls to reject before the next event is accepted
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(void)
+{
+    testParameters();
+    testReference();
+    testRamp();
+    testFlatAndFalling();
+    testSaturation();
+    testEarlyWarning();
+
+    return hostTestResult("test_trend");
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Post function of the early warning, rejects gPostRejects calls
+ * like a state machine with a pending event
+ */
+static int32_t testPostEvent(int32_t eventID)
+{
+    gPostCalls++;
+
+    if (eventID != TEST_EVENT_ID)
+        return -1;
+
+    if (gPostRejects > 0)
+    {
+        gPostRejects--;
+        return -4;
+    }
+
+    gPostAccepted++;
+    return 0;
+}
+
+/**
+ * @brief Linear congruential generator, so the test does not depend on rand()
+ *
+ * @return Random value in -TEST_REFERENCE_RANGE / 2 .. TEST_REFERENCE_RANGE / 2
+ */
+static int32_t testRandom(void)
+{
+    gRandomState = gRandomState * 1664525u + 1013904223u;
+    return (int32_t)((gRandomState >> 8) % (TEST_REFERENCE_RANGE + 1)) - TEST_REFERENCE_RANGE / 2;
+}
+
+/**
+ * @brief Invalid pointers and parameters are rejected
+ */
+static void testParameters(void)
+{
+    int32_t window[TREND_MAX_WINDOW + 1];
+    TrendEstimator_t trend;
+    int32_t slope;
+    uint32_t timeMs;
+
+    HOST_TEST_CHECK(trendInitialize(0, window, TREND_MIN_WINDOW, 100) == TREND_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(trendInitialize(&trend, 0, TREND_MIN_WINDOW, 100) == TREND_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(trendInitialize(&trend, window, TREND_MIN_WINDOW - 1, 100) == TREND_ERR_INVALID_PARAM);
+    HOST_TEST_CHECK(trendInitialize(&trend, window, TREND_MAX_WINDOW + 1, 100) == TREND_ERR_INVALID_PARAM);
+    HOST_TEST_CHECK(trendInitialize(&trend, window, TREND_MAX_WINDOW, 0) == TREND_ERR_INVALID_PARAM);
+
+    HOST_TEST_CHECK(trendInitialize(&trend, window, TREND_MAX_WINDOW, 250) == TREND_ERR_OK);
+    HOST_TEST_CHECK(trendSetEarlyWarning(&trend, 0, TREND_MAX_HORIZON * 250, TEST_EVENT_ID, 0) == TREND_ERR_OK);
+    HOST_TEST_CHECK(trendSetEarlyWarning(&trend, 0, (TREND_MAX_HORIZON + 1) * 250, TEST_EVENT_ID, 0) == TREND_ERR_INVALID_PARAM);
+
+    HOST_TEST_CHECK(trendUpdate(0, 0) == TREND_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(trendGetSlope(&trend, 0) == TREND_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_NO_DATA);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 0, 0) == TREND_ERR_INVALID_PTR);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 0, &timeMs) == TREND_ERR_NO_DATA);
+    HOST_TEST_CHECK(!trendIsWarningActive(0));
+}
+
+/**
+ * @brief The slope of every window size matches the least squares fit
+ *
+ * The slope is truncated twice (per sample and per second), so it may
+ * differ by 1000 / period + 1 milli-units per second.
+ */
+static void testReference(void)
+{
+    static int32_t history[TEST_REFERENCE_SAMPLES];
+    const double tolerance = 1000 / TEST_REFERENCE_PERIOD_MS + 1;
+
+    for (int32_t n = TREND_MIN_WINDOW; n <= TREND_MAX_WINDOW; n++)
+    {
+        int32_t window[TREND_MAX_WINDOW];
+        TrendEstimator_t trend;
+        bool ok = true;
+
+        trendInitialize(&trend, window, n, TEST_REFERENCE_PERIOD_MS);
+
+        for (int32_t i = 0; i < TEST_REFERENCE_SAMPLES && ok; i++)
+        {
+            history[i] = testRandom();
+            int32_t result = trendUpdate(&trend, history[i]);
+
+            if (i + 1 < n)
+            {
+                ok = HOST_TEST_CHECK(result == TREND_ERR_NO_DATA);
+                continue;
+            }
+
+            long double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+            for (int32_t k = 0; k < n; k++)
+            {
+                long double x = k;
+                long double y = history[i - n + 1 + k];
+                sumX += x;
+                sumY += y;
+                sumXX += x * x;
+                sumXY += x * y;
+            }
+
+            long double reference = (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+            reference *= 1000.0L * 1000.0L / TEST_REFERENCE_PERIOD_MS;
+
+            int32_t slope = 0;
+            ok = HOST_TEST_CHECK(result == TREND_ERR_OK) &&
+                 HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_OK);
+
+            // Outside of the 32 bit range the slope is limited
+            if (ok && reference > INT32_MIN && reference < INT32_MAX)
+            {
+                long double difference = slope - reference;
+                ok = HOST_TEST_CHECK(difference <= tolerance && difference >= -tolerance);
+            }
+
+            if (!ok)
+            {
+                fprintf(stderr, "  window %d, sample %d: slope %d, reference %.1Lf\n", n, i, slope, reference);
+            }
+        }
+    }
+}
+
+/**
+ * @brief A ramp gives the exact slope and the time to the threshold is
+ * rounded up to whole sample periods
+ */
+static void testRamp(void)
+{
+    for (int32_t n = TREND_MIN_WINDOW; n <= TREND_MAX_WINDOW; n++)
+    {
+        int32_t window[TREND_MAX_WINDOW];
+        TrendEstimator_t trend;
+        int32_t slope = 0;
+        uint32_t timeMs = 1;
+
+        // 3 units per 100 ms, more samples than the window to check the sliding sums
+        trendInitialize(&trend, window, n, 100);
+        for (int32_t i = 0; i < 3 * n; i++)
+        {
+            trendUpdate(&trend, 1000 + 3 * i);
+        }
+
+        int32_t last = 1000 + 3 * (3 * n - 1);
+
+        HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_OK && slope == 30000);
+
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, last + 1, &timeMs) == TREND_ERR_OK && timeMs == 100);
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, last + 3, &timeMs) == TREND_ERR_OK && timeMs == 100);
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, last + 4, &timeMs) == TREND_ERR_OK && timeMs == 200);
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, last + 9, &timeMs) == TREND_ERR_OK && timeMs == 300);
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, last + 10, &timeMs) == TREND_ERR_OK && timeMs == 400);
+
+        // Threshold already reached
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, last, &timeMs) == TREND_ERR_OK && timeMs == 0);
+        HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 0, &timeMs) == TREND_ERR_OK && timeMs == 0);
+
+        // After a reset the window has to be filled again
+        trendReset(&trend);
+        HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_NO_DATA);
+    }
+}
+
+/**
+ * @brief A flat or falling signal never reaches the threshold
+ */
+static void testFlatAndFalling(void)
+{
+    int32_t window[32];
+    TrendEstimator_t trend;
+    int32_t slope = 1;
+    uint32_t timeMs = 1;
+
+    trendInitialize(&trend, window, 32, 250);
+    trendSetEarlyWarning(&trend, 300, 10000, TEST_EVENT_ID, testPostEvent);
+
+    gPostCalls = 0;
+    for (int32_t i = 0; i < 100; i++)
+    {
+        trendUpdate(&trend, 250);
+    }
+
+    HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_OK && slope == 0);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 300, &timeMs) == TREND_ERR_NOT_RISING && timeMs == 1);
+    HOST_TEST_CHECK(!trendIsWarningActive(&trend));
+
+    // 1 unit per 250 ms down
+    for (int32_t i = 0; i < 100; i++)
+    {
+        trendUpdate(&trend, 250 - i);
+    }
+
+    HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_OK && slope == -4000);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 300, &timeMs) == TREND_ERR_NOT_RISING && timeMs == 1);
+    HOST_TEST_CHECK(!trendIsWarningActive(&trend));
+    HOST_TEST_CHECK(gPostCalls == 0);
+}
+
+/**
+ * @brief The time to the threshold and the slope saturate instead of
+ * wrapping around
+ */
+static void testSaturation(void)
+{
+    int32_t window[TREND_MIN_WINDOW];
+    TrendEstimator_t trend;
+    int32_t slope = 0;
+    uint32_t timeMs = 0;
+
+    // 1 unit per second, the last sample is 1
+    trendInitialize(&trend, window, TREND_MIN_WINDOW, 1000);
+    trendUpdate(&trend, 0);
+    trendUpdate(&trend, 1);
+
+    // UINT32_MAX / 1000 = 4294967 periods still fit
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 1 + 4294967, &timeMs) == TREND_ERR_OK && timeMs == 4294967000u);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 1 + 4294968, &timeMs) == TREND_ERR_OK && timeMs == UINT32_MAX);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, INT32_MAX, &timeMs) == TREND_ERR_OK && timeMs == UINT32_MAX);
+
+    // Largest possible steps
+    trendInitialize(&trend, window, TREND_MIN_WINDOW, 1);
+    trendUpdate(&trend, INT32_MIN);
+    trendUpdate(&trend, INT32_MAX);
+    HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_OK && slope == INT32_MAX);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, INT32_MAX, &timeMs) == TREND_ERR_OK && timeMs == 0);
+
+    trendUpdate(&trend, INT32_MIN);
+    HOST_TEST_CHECK(trendGetSlope(&trend, &slope) == TREND_ERR_OK && slope == INT32_MIN);
+    HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, INT32_MAX, &timeMs) == TREND_ERR_NOT_RISING);
+}
+
+/**
+ * @brief A rising water level (200 cm + 5 cm/s, 250 ms samples) raises the
+ * early warning about 10 s before it reaches 300 cm, the event is posted
+ * once per activation and again after a rejected post
+ */
+static void testEarlyWarning(void)
+{
+    int32_t window[32];
+    TrendEstimator_t trend;
+    int32_t warningMs = -1;
+    uint32_t timeMs = 0;
+
+    trendInitialize(&trend, window, 32, 250);
+    trendSetEarlyWarning(&trend, 300, 10000, TEST_EVENT_ID, testPostEvent);
+
+    gPostCalls = 0;
+    gPostAccepted = 0;
+    gPostRejects = 2;
+
+    for (int32_t ms = 0; ms < 30000; ms += 250)
+    {
+        trendUpdate(&trend, 200 + ms * 5 / 1000);
+
+        if (warningMs < 0 && trendIsWarningActive(&trend))
+        {
+            warningMs = ms;
+            HOST_TEST_CHECK(trendGetTimeToThreshold(&trend, 300, &timeMs) == TREND_ERR_OK && timeMs <= 10000);
+        }
+    }
+
+    // 300 cm is reached after 20 s
+    HOST_TEST_CHECK(warningMs >= 9000 && warningMs <= 10000);
+    HOST_TEST_CHECK(gPostCalls == 3 && gPostAccepted == 1);
+
+    // The warning ends with a flat signal below the threshold and is posted
+    // again with the next rise
+    for (int32_t i = 0; i < 64; i++)
+    {
+        trendUpdate(&trend, 100);
+    }
+    HOST_TEST_CHECK(!trendIsWarningActive(&trend));
+
+    for (int32_t i = 0; i < 64; i++)
+    {
+        trendUpdate(&trend, 100 + 5 * i);
+    }
+    HOST_TEST_CHECK(trendIsWarningActive(&trend));
+    HOST_TEST_CHECK(gPostAccepted == 2);
+}
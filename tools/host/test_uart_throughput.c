@@ -0,0 +1,317 @@
+/******************************************************************************
+ * @file test_uart_throughput.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host test of the throughput of the host UART
+ *
+ * The sensor UART is attached to one end of a socketpair and runs without
+ * pacing. A peer thread pushes a known byte pattern through the receive
+ * path and checks the pattern sent through the transmit path. The peer never
+ * has more bytes in flight than the RX ring buffer holds, so every overflow
+ * or dropped byte is an error of the ring buffer handling. The throughput of
+ * both directions is reported.
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "HostTest.h"
+#include "UARTModuleHost.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define TEST_PORT               UART_PORT_SENSOR            //!< Port under test (the sensor line)
+#define TEST_BYTES              2000000                     //!< Bytes pushed through each direction
+#define TEST_BAUDRATE           115200                      //!< Configured baudrate (not paced)
+#define TEST_RX_BLOCK           (UART_RX_BUFFER_SIZE / 2)   //!< Bytes written by the peer at once
+#define TEST_TX_BLOCK           UART_TX_BUFFER_SIZE         //!< Bytes queued by uartSendData() before a flush
+#define TEST_FLUSH_TIMEOUT_MS   5000                        //!< Timeout of a flush of the TX ring buffer
+#define TEST_TIMEOUT_S          30                          //!< Timeout of each direction
+#define TEST_PEER_TIMEOUT_S     5                           //!< Receive timeout of the peer reader
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint8_t testPattern(uint32_t index);
+static double testNow(void);
+static void* testPeerWriter(void* pArgument);
+static void* testPeerReader(void* pArgument);
+static void testReceive(void);
+static void testTransmit(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static int gPeerFd = -1;                    //!< Peer end of the socketpair
+static atomic_uint gRxConsumed;             //!< Bytes read with uartRead() (flow control of the peer writer)
+static atomic_bool gRxAbort;                //!< Stops the peer writer after a timeout of the receive test
+static uint32_t gPeerReceived;              //!< Bytes received by the peer reader
+static uint32_t gPeerMismatches;            //!< Bytes received by the peer reader which differ from the pattern
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(void)
+{
+    int fds[2];
+
+    if (!HOST_TEST_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0))
+    {
+        return hostTestResult("test_uart_throughput");
+    }
+
+    gPeerFd = fds[1];
+
+    // The peer reader gives up if the UART stops sending
+    struct timeval timeout = { TEST_PEER_TIMEOUT_S, 0 };
+    setsockopt(gPeerFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    uartHostSetPacing(0);
+    HOST_TEST_CHECK(uartHostAttach(TEST_PORT, fds[0]) == UART_ERR_OK);
+    HOST_TEST_CHECK(uartInitialize(TEST_PORT, TEST_BAUDRATE) == UART_ERR_OK);
+
+    testReceive();
+    testTransmit();
+
+    uartStopReception(TEST_PORT);
+    close(gPeerFd);
+
+    return hostTestResult("test_uart_throughput");
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Byte pattern of the test stream, does not repeat within the ring buffers
+ *
+ * @param index         Position in the stream
+ *
+ * @return Byte at the position
+ */
+static uint8_t testPattern(uint32_t index)
+{
+    return (uint8_t)(index ^ (index >> 8) ^ (index >> 16));
+}
+
+/**
+ * @brief Returns a monotonic time stamp
+ *
+ * @return Time in seconds
+ */
+static double testNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Pushes the test pattern into the receive path of the UART
+ *
+ * A block is only written when the previous bytes have been read, so the
+ * bytes in the socket and the RX ring buffer never exceed its size.
+ *
+ * @param pArgument     Unused
+ *
+ * @return Always 0
+ */
+static void* testPeerWriter(void* pArgument)
+{
+    (void)pArgument;
+
+    uint8_t block[TEST_RX_BLOCK];
+    uint32_t sent = 0;
+
+    while (sent < TEST_BYTES && !atomic_load(&gRxAbort))
+    {
+        if (sent - atomic_load(&gRxConsumed) > UART_RX_BUFFER_SIZE - TEST_RX_BLOCK)
+        {
+            sched_yield();
+            continue;
+        }
+
+        uint32_t length = (TEST_BYTES - sent < TEST_RX_BLOCK) ? TEST_BYTES - sent : TEST_RX_BLOCK;
+        for (uint32_t i = 0; i < length; i++)
+        {
+            block[i] = testPattern(sent + i);
+        }
+
+        uint32_t written = 0;
+        while (written < length)
+        {
+            ssize_t count = write(gPeerFd, &block[written], length - written);
+            if (count <= 0)
+            {
+                return 0;
+            }
+            written += (uint32_t)count;
+        }
+
+        sent += length;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Receives the bytes sent by the UART and compares them with the pattern
+ *
+ * @param pArgument     Unused
+ *
+ * @return Always 0
+ */
+static void* testPeerReader(void* pArgument)
+{
+    (void)pArgument;
+
+    uint8_t block[TEST_TX_BLOCK];
+
+    while (gPeerReceived < TEST_BYTES)
+    {
+        ssize_t count = read(gPeerFd, block, sizeof(block));
+        if (count <= 0)
+        {
+            break;
+        }
+
+        for (ssize_t i = 0; i < count; i++)
+        {
+            if (block[i] != testPattern(gPeerReceived + (uint32_t)i))
+            {
+                gPeerMismatches++;
+            }
+        }
+
+        gPeerReceived += (uint32_t)count;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Reads the pattern pushed by the peer with uartRead()
+ *
+ * All bytes have to arrive in order, without RX overflow and without a
+ * byte lost by the receive thread.
+ */
+static void testReceive(void)
+{
+    pthread_t writer;
+    uint8_t chunk[UART_RX_BUFFER_SIZE];
+    uint32_t received = 0;
+    uint32_t mismatches = 0;
+
+    atomic_store(&gRxConsumed, 0);
+    pthread_create(&writer, 0, testPeerWriter, 0);
+
+    double start = testNow();
+
+    while (received < TEST_BYTES && testNow() - start < TEST_TIMEOUT_S)
+    {
+        int32_t count = uartRead(TEST_PORT, chunk, sizeof(chunk));
+
+        if (count <= 0)
+        {
+            sched_yield();
+            continue;
+        }
+
+        for (int32_t i = 0; i < count; i++)
+        {
+            if (chunk[i] != testPattern(received + (uint32_t)i))
+            {
+                mismatches++;
+            }
+        }
+
+        received += (uint32_t)count;
+        atomic_store(&gRxConsumed, received);
+    }
+
+    double elapsed = testNow() - start;
+
+    atomic_store(&gRxAbort, true);
+    pthread_join(writer, 0);
+
+    UARTIrqStats_t irqStats;
+    UARTHostStats_t hostStats;
+
+    HOST_TEST_CHECK(uartGetIrqStats(TEST_PORT, &irqStats) == UART_ERR_OK);
+    HOST_TEST_CHECK(uartHostGetStats(TEST_PORT, &hostStats) == UART_ERR_OK);
+
+    HOST_TEST_CHECK(received == TEST_BYTES);
+    HOST_TEST_CHECK(mismatches == 0);
+    HOST_TEST_CHECK(irqStats.rxBytes == TEST_BYTES);
+    HOST_TEST_CHECK(uartGetRxOverflowCount(TEST_PORT) == 0);
+    HOST_TEST_CHECK(hostStats.bytesDropped == 0);
+
+    printf("RX: %u bytes in %.3f s, %.0f bytes/s\n", received, elapsed, received / elapsed);
+}
+
+/**
+ * @brief Sends the pattern with uartSendData() to the peer
+ *
+ * The TX ring buffer is flushed after every full buffer, so no byte may be
+ * dropped and the peer has to receive all bytes in order.
+ */
+static void testTransmit(void)
+{
+    pthread_t reader;
+    uint8_t block[TEST_TX_BLOCK];
+    uint32_t queued = 0;
+    bool flushed = true;
+
+    HOST_TEST_CHECK(uartSetTxPolicy(TEST_PORT, UART_TX_POLICY_DROP_NEW) == UART_ERR_OK);
+    pthread_create(&reader, 0, testPeerReader, 0);
+
+    double start = testNow();
+
+    while (queued < TEST_BYTES && flushed)
+    {
+        int32_t length = (TEST_BYTES - queued < TEST_TX_BLOCK) ? (int32_t)(TEST_BYTES - queued) : TEST_TX_BLOCK;
+        for (int32_t i = 0; i < length; i++)
+        {
+            block[i] = testPattern(queued + (uint32_t)i);
+        }
+
+        HOST_TEST_CHECK(uartSendData(TEST_PORT, block, length) == UART_ERR_OK);
+        queued += (uint32_t)length;
+
+        flushed = HOST_TEST_CHECK(uartFlush(TEST_PORT, TEST_FLUSH_TIMEOUT_MS) == UART_ERR_OK);
+    }
+
+    pthread_join(reader, 0);
+
+    double elapsed = testNow() - start;
+
+    UARTTxStats_t txStats;
+
+    HOST_TEST_CHECK(uartGetTxStats(TEST_PORT, &txStats) == UART_ERR_OK);
+
+    HOST_TEST_CHECK(gPeerReceived == TEST_BYTES);
+    HOST_TEST_CHECK(gPeerMismatches == 0);
+    HOST_TEST_CHECK(txStats.bytesQueued == TEST_BYTES);
+    HOST_TEST_CHECK(txStats.bytesDropped == 0);
+
+    printf("TX: %u bytes in %.3f s, %.0f bytes/s\n", gPeerReceived, elapsed, gPeerReceived / elapsed);
+}
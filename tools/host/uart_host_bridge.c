@@ -0,0 +1,248 @@
+/******************************************************************************
+ * @file uart_host_bridge.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host program which runs the UART stack of the firmware on a
+ * pseudo-terminal
+ *
+ * The received data is passed through the frame multiplexer (or only drained
+ * in raw mode, or decoded as raw water sensor stream) and the throughput,
+ * overflows and frame errors are reported once per second. Received log
+ * frames are echoed back on the log channel, the sensor channel is passed
+ * to the water sensor decoder. In water mode the stream is received on the
+ * sensor port like on the target, the other modes use the debug port.
+ *
+ * Example for a throughput measurement of the receive path:
+ *
+ *   uart_host_bridge -r -b 2000000            (prints the pseudo-terminal)
+ *   head -c 100000000 /dev/urandom > /dev/pts/N
+ *
+ * Usage: uart_host_bridge [-b baudrate] [-r | -w] [-n] [-d ppm] [-f ppm] [-B ppm:length] [-s seconds]
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "UARTModuleHost.h"
+#include "FrameMux.h"
+#include "WaterSensor.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define BRIDGE_DEFAULT_BAUDRATE     115200      //!< Baudrate if no -b option is given
+#define BRIDGE_POLL_INTERVAL_US     1000        //!< Interval of the processing loop
+#define BRIDGE_RAW_CHUNK            256         //!< Bytes read per call in raw mode
+
+#define BRIDGE_MODE_FRAMES          0           //!< Received data is decoded by the frame multiplexer
+#define BRIDGE_MODE_RAW             1           //!< Received data is only drained
+#define BRIDGE_MODE_WATER           2           //!< Received data is a raw water sensor stream
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void bridgeLogConsumer(uint8_t channel, const uint8_t* pPayload, uint16_t length);
+static void bridgeSensorConsumer(uint8_t channel, const uint8_t* pPayload, uint16_t length);
+static uint32_t bridgeNowUs(void);
+static double bridgeNow(void);
+static void bridgeReport(UARTPort_t port, double elapsed, uint64_t rxBytes);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static WaterSensor_t gWaterSensor;          //!< Decoder for the water sensor stream
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(int argc, char* argv[])
+{
+    uint32_t baudrate = BRIDGE_DEFAULT_BAUDRATE;
+    uint32_t duration = 0;
+    int32_t mode = BRIDGE_MODE_FRAMES;
+    UARTHostFaults_t faults = { 0 };
+    int option;
+
+    while ((option = getopt(argc, argv, "b:rwnd:f:B:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'b': baudrate = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'r': mode = BRIDGE_MODE_RAW; break;
+            case 'w': mode = BRIDGE_MODE_WATER; break;
+            case 'n': uartHostSetPacing(0); break;
+            case 'd': faults.dropPpm = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'f': faults.bitFlipPpm = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'B':
+                if (sscanf(optarg, "%u:%u", &faults.burstPpm, &faults.burstLength) != 2)
+                {
+                    fprintf(stderr, "invalid burst specification '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 's': duration = (uint32_t)strtoul(optarg, 0, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-b baudrate] [-r | -w] [-n] [-d ppm] [-f ppm] [-B ppm:length] [-s seconds]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    UARTPort_t port = (mode == BRIDGE_MODE_WATER) ? UART_PORT_SENSOR : UART_PORT_DEBUG;
+
+    if (uartHostSetFaults(port, &faults) != UART_ERR_OK || uartInitialize(port, baudrate) != UART_ERR_OK)
+    {
+        fprintf(stderr, "UART initialization failed\n");
+        return 1;
+    }
+
+    fprintf(stderr, "UART on %s at %u baud\n", uartHostGetPortName(port), baudrate);
+
+    frameMuxInitialize();
+    frameMuxRegisterConsumer(FRAME_CHANNEL_LOG, bridgeLogConsumer);
+    frameMuxRegisterConsumer(FRAME_CHANNEL_SENSOR, bridgeSensorConsumer);
+    waterSensorInitialize(&gWaterSensor, bridgeNowUs());
+
+    double start = bridgeNow();
+    double lastReport = start;
+    uint64_t rxBytes = 0;
+
+    while (duration == 0 || (bridgeNow() - start) < duration)
+    {
+        if (mode == BRIDGE_MODE_FRAMES)
+        {
+            frameMuxProcess();
+        }
+        else
+        {
+            uint8_t chunk[BRIDGE_RAW_CHUNK];
+            int32_t count;
+
+            while ((count = uartRead(port, chunk, BRIDGE_RAW_CHUNK)) > 0)
+            {
+                rxBytes += (uint64_t)count;
+
+                if (mode == BRIDGE_MODE_WATER)
+                {
+                    waterSensorProcess(&gWaterSensor, chunk, count, bridgeNowUs());
+                }
+            }
+        }
+
+        waterSensorCheckTimeout(&gWaterSensor, bridgeNowUs());
+
+        double now = bridgeNow();
+        if (now - lastReport >= 1.0)
+        {
+            bridgeReport(port, now - start, rxBytes);
+            lastReport = now;
+        }
+
+        usleep(BRIDGE_POLL_INTERVAL_US);
+    }
+
+    uartFlush(port, 1000);
+    uartStopReception(port);
+
+    return 0;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Prints received log frames and echoes them back
+ *
+ * @param channel       Channel of the frame
+ * @param pPayload      Payload of the frame
+ * @param length        Length of the payload
+ */
+static void bridgeLogConsumer(uint8_t channel, const uint8_t* pPayload, uint16_t length)
+{
+    fwrite(pPayload, 1, length, stdout);
+    fflush(stdout);
+
+    frameMuxSend(channel, pPayload, length);
+}
+
+/**
+ * @brief Passes the sensor channel to the water sensor decoder
+ *
+ * @param channel       Channel of the frame
+ * @param pPayload      Payload of the frame
+ * @param length        Length of the payload
+ */
+static void bridgeSensorConsumer(uint8_t channel, const uint8_t* pPayload, uint16_t length)
+{
+    waterSensorProcess(&gWaterSensor, pPayload, length, bridgeNowUs());
+}
+
+/**
+ * @brief Returns a monotonic time stamp in us (like timerGetMicroseconds())
+ *
+ * @return Time in us
+ */
+static uint32_t bridgeNowUs(void)
+{
+    return (uint32_t)(uint64_t)(bridgeNow() * 1e6);
+}
+
+/**
+ * @brief Returns a monotonic time stamp
+ *
+ * @return Time in seconds
+ */
+static double bridgeNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Prints the throughput and error counters
+ *
+ * @param port          Port the data is received on
+ * @param elapsed       Time since start in seconds
+ * @param rxBytes       Bytes read by the application in raw mode
+ */
+static void bridgeReport(UARTPort_t port, double elapsed, uint64_t rxBytes)
+{
+    UARTIrqStats_t irqStats;
+    UARTTxStats_t txStats;
+    UARTHostStats_t hostStats;
+    FrameMuxStats_t muxStats;
+
+    uartGetIrqStats(port, &irqStats);
+    uartGetTxStats(port, &txStats);
+    uartHostGetStats(port, &hostStats);
+    frameMuxGetStats(&muxStats);
+
+    fprintf(stderr,
+            "%7.1f s  rx %u B (%.0f B/s, read %llu B)  overflows %u  tx %u B dropped %u  "
+            "frames %u crc %u framing %u  water frames %u samples %u sync %u discarded %u resync max %u B "
+            "counter %u lost %u unknown %u timeouts %u  "
+            "injected drop %u flip %u burst %u\n",
+            elapsed, irqStats.rxBytes, irqStats.rxBytes / elapsed, (unsigned long long)rxBytes,
+            uartGetRxOverflowCount(port), txStats.bytesQueued, txStats.bytesDropped,
+            muxStats.framesReceived, muxStats.crcErrors, muxStats.framingErrors,
+            gWaterSensor.stats.framesReceived, gWaterSensor.stats.samplesReceived, gWaterSensor.stats.syncLosses,
+            gWaterSensor.stats.bytesDiscarded, gWaterSensor.stats.resyncBytesMax,
+            gWaterSensor.stats.counterErrors, gWaterSensor.stats.framesLost, gWaterSensor.stats.unknownProbeFrames,
+            gWaterSensor.channel.timeouts,
+            hostStats.bytesDropped, hostStats.bitsFlipped, hostStats.bursts);
+}
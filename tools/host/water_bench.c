@@ -0,0 +1,632 @@
+/******************************************************************************
+ * @file water_bench.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host benchmark and equivalence check of the water sensor decoder
+ *
+ * The batch validation (waterSensorValidateFrames()) has to give the same
+ * verdict as the byte-wise reference (waterSensorCheckFrame()) for every
+ * frame: random bytes, valid frames and valid frames with a flipped bit.
+ * Both are timed on the same frames afterwards.
+ *
+ * The stream test generates a byte stream like tools/water_stream.py
+ * (legacy and extended frames, wrong checksums, wrong reserved words,
+ * counter skips and rollovers, garbage) in-process, passes it in blocks of
+ * random size to waterSensorProcess() and compares the counters of the
+ * decoder with the reference model of water_stream.py. The throughput of
+ * the decoder and the resynchronization are reported.
+ *
+ * The program returns a non zero exit code on any mismatch, so it is also
+ * run by make host-test. For a long run, e.g.:
+ *
+ *   water_bench -b 500000000 -e 300
+ *
+ * Usage: water_bench [-f frames] [-r rounds] [-b bytes] [-s seed]
+ *                    [-e permille extended] [-k permille bad]
+ *                    [-g permille garbage] [-p permille skip]
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "HostTest.h"
+#include "WaterSensor.h"
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define BENCH_DEFAULT_FRAMES        200000      //!< Frames of the equivalence check and the benchmark
+#define BENCH_DEFAULT_ROUNDS        50          //!< Repetitions of the benchmark
+#define BENCH_DEFAULT_BYTES         16000000    //!< Size of the generated stream
+
+#define BENCH_CHUNK_SIZE            65536       //!< Bytes generated at once
+#define BENCH_MAX_BLOCK             256         //!< Largest block passed to waterSensorProcess() (like the RX DMA)
+#define BENCH_MAX_GARBAGE           24          //!< Largest number of garbage bytes in front of a frame
+#define BENCH_MAX_FRAME             WATER_ADDR_FRAME_SIZE(WATER_EXT_MAX_SAMPLES)    //!< Largest frame of any format
+#define BENCH_BYTE_TIME_US          87          //!< Time of one byte at 115200 baud (time stamps of the blocks)
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief Parameters of the generated stream (see water_stream.py)
+ */
+typedef struct _BenchStreamConfig_
+{
+    uint64_t bytes;                 //!< Size of the stream
+    uint32_t badPermille;           //!< Frames with a flipped bit in checksum or reserved word
+    uint32_t garbagePermille;       //!< Frames preceded by random bytes
+    uint32_t skipPermille;          //!< Frames followed by a counter skip
+    uint32_t extendedPermille;      //!< Extended frames (otherwise legacy frames)
+} BenchStreamConfig_t;
+
+/**
+ * @brief Counters of the reference model (names as in water_stream.py)
+ */
+typedef struct _BenchCounters_
+{
+    uint64_t frames;
+    uint64_t samples;
+    uint64_t syncLosses;
+    uint64_t discarded;
+    uint64_t counterErrors;
+    uint64_t framesLost;
+    uint64_t resyncMax;
+    uint64_t unknown;
+} BenchCounters_t;
+
+/**
+ * @brief State of the reference model between two chunks of the stream
+ */
+typedef struct _BenchReference_
+{
+    uint8_t tail[BENCH_MAX_FRAME];  //!< Last bytes of the previous chunk
+    uint32_t tailLength;            //!< Number of valid bytes in tail
+    uint64_t offset;                //!< Stream position of the first byte of the next chunk
+    uint64_t position;              //!< Stream position behind the last frame
+    bool synchronized;              //!< At least one frame found
+    int32_t counter;                //!< Counter of the last unaddressed frame (-1 = none)
+    BenchCounters_t counters;       //!< Expected counters of the decoder
+} BenchReference_t;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t benchRandom(void);
+static double benchNow(void);
+static void benchFillFrames(uint32_t* pFrames, int32_t frameCount);
+static void benchValidateFrames(int32_t frameCount, uint32_t rounds);
+static uint32_t benchEncodeFrame(uint8_t* pFrame, uint8_t counter, const int32_t* pSamples, uint32_t count, bool extended);
+static uint32_t benchGenerate(const BenchStreamConfig_t* pConfig, uint8_t* pCounter, uint8_t* pBuffer, uint32_t capacity);
+static int32_t benchFrameSize(const uint8_t* pEnd);
+static void benchReferenceProcess(BenchReference_t* pReference, const uint8_t* pData, uint32_t length);
+static void benchReferenceFinish(BenchReference_t* pReference);
+static void benchStream(const BenchStreamConfig_t* pConfig);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gRandomState = 1;           //!< State of the random generator (reproducible)
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int main(int argc, char* argv[])
+{
+    int32_t frameCount = BENCH_DEFAULT_FRAMES;
+    uint32_t rounds = BENCH_DEFAULT_ROUNDS;
+    BenchStreamConfig_t config = { BENCH_DEFAULT_BYTES, 10, 10, 5, 100 };
+    int option;
+
+    while ((option = getopt(argc, argv, "f:r:b:s:e:k:g:p:")) != -1)
+    {
+        switch (option)
+        {
+            case 'f': frameCount = (int32_t)strtol(optarg, 0, 0); break;
+            case 'r': rounds = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'b': config.bytes = strtoull(optarg, 0, 0); break;
+            case 's': gRandomState = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'e': config.extendedPermille = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'k': config.badPermille = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'g': config.garbagePermille = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'p': config.skipPermille = (uint32_t)strtoul(optarg, 0, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-f frames] [-r rounds] [-b bytes] [-s seed] [-e permille] [-k permille] [-g permille] [-p permille]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    // Xorshift gets stuck at 0
+    if (gRandomState == 0)
+    {
+        gRandomState = 1;
+    }
+
+    if (frameCount <= 0)
+    {
+        fprintf(stderr, "invalid number of frames\n");
+        return 1;
+    }
+
+    benchValidateFrames(frameCount, rounds);
+    benchStream(&config);
+
+    return hostTestResult("water_bench");
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Xorshift generator, so the frames do not depend on rand()
+ *
+ * @return Random 32 bit value
+ */
+static uint32_t benchRandom(void)
+{
+    gRandomState ^= gRandomState << 13;
+    gRandomState ^= gRandomState >> 17;
+    gRandomState ^= gRandomState << 5;
+
+    return gRandomState;
+}
+
+/**
+ * @brief Returns a monotonic time stamp
+ *
+ * @return Time in seconds
+ */
+static double benchNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Fills aligned legacy frames: one quarter random bytes, the others
+ * valid frames of which every third gets a flipped bit
+ *
+ * @param pFrames       Frames, WATER_FRAME_WORDS words per frame
+ * @param frameCount    Number of frames
+ */
+static void benchFillFrames(uint32_t* pFrames, int32_t frameCount)
+{
+    for (int32_t i = 0; i < frameCount; i++)
+    {
+        uint8_t* pFrame = (uint8_t*)&pFrames[i * WATER_FRAME_WORDS];
+        uint32_t kind = benchRandom() % 12;
+
+        for (int32_t j = 0; j < WATER_FRAME_SIZE; j++)
+        {
+            pFrame[j] = (uint8_t)benchRandom();
+        }
+
+        if (kind < 3)
+            continue;
+
+        uint8_t sum = 0;
+        pFrame[5] = (uint8_t)(WATER_FRAME_RESERVED & 0xFF);
+        pFrame[6] = (uint8_t)(WATER_FRAME_RESERVED >> 8);
+        for (int32_t j = 0; j < WATER_FRAME_SIZE - 1; j++)
+        {
+            sum += pFrame[j];
+        }
+        pFrame[WATER_FRAME_SIZE - 1] = (uint8_t)-sum;
+
+        if (kind < 6)
+        {
+            uint32_t bit = benchRandom() % (WATER_FRAME_SIZE * 8);
+            pFrame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        }
+    }
+}
+
+/**
+ * @brief Compares the batch validation with the byte-wise reference and
+ * measures both
+ *
+ * @param frameCount    Number of frames
+ * @param rounds        Repetitions of the measurement
+ */
+static void benchValidateFrames(int32_t frameCount, uint32_t rounds)
+{
+    uint32_t* pFrames = malloc((size_t)frameCount * WATER_FRAME_SIZE);
+    bool* pValid = malloc((size_t)frameCount * sizeof(bool));
+
+    if (!HOST_TEST_CHECK(pFrames != 0 && pValid != 0))
+    {
+        free(pFrames);
+        free(pValid);
+        return;
+    }
+
+    benchFillFrames(pFrames, frameCount);
+
+    // Equivalence of every single verdict and of the number of valid frames
+    int32_t validCount = waterSensorValidateFrames(pFrames, frameCount, pValid);
+    int32_t referenceCount = 0;
+    uint32_t mismatches = 0;
+
+    for (int32_t i = 0; i < frameCount; i++)
+    {
+        bool reference = waterSensorCheckFrame((const uint8_t*)&pFrames[i * WATER_FRAME_WORDS]);
+
+        if (reference != pValid[i])
+        {
+            if (mismatches < 10)
+            {
+                fprintf(stderr, "  frame %d: batch %d, reference %d\n", i, pValid[i], reference);
+            }
+            mismatches++;
+        }
+
+        referenceCount += reference ? 1 : 0;
+    }
+
+    HOST_TEST_CHECK(mismatches == 0);
+    HOST_TEST_CHECK(validCount == referenceCount);
+    HOST_TEST_CHECK(waterSensorValidateFrames(pFrames, frameCount, 0) == referenceCount);
+    HOST_TEST_CHECK(waterSensorValidateFrames(pFrames, 0, pValid) == 0);
+    HOST_TEST_CHECK(waterSensorValidateFrames(0, frameCount, pValid) == WATER_ERR_INVALID_PARAM);
+
+    // Every frame count up to 16 (tails of an unrolled implementation)
+    for (int32_t count = 1; count <= 16 && count <= frameCount; count++)
+    {
+        int32_t expected = 0;
+        for (int32_t i = 0; i < count; i++)
+        {
+            expected += pValid[i] ? 1 : 0;
+        }
+        HOST_TEST_CHECK(waterSensorValidateFrames(pFrames, count, 0) == expected);
+    }
+
+    printf("validate: %d frames, %d valid, %u mismatches\n", frameCount, referenceCount, mismatches);
+
+    // Throughput of both implementations on the same frames
+    volatile int32_t sink = 0;
+    double start = benchNow();
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        sink += waterSensorValidateFrames(pFrames, frameCount, pValid);
+    }
+    double batchTime = benchNow() - start;
+
+    start = benchNow();
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        int32_t count = 0;
+        for (int32_t i = 0; i < frameCount; i++)
+        {
+            count += waterSensorCheckFrame((const uint8_t*)&pFrames[i * WATER_FRAME_WORDS]) ? 1 : 0;
+        }
+        sink += count;
+    }
+    double referenceTime = benchNow() - start;
+
+    double frames = (double)frameCount * rounds;
+    if (batchTime > 0 && referenceTime > 0)
+    {
+        printf("validate: batch %.1f Mframes/s, byte-wise %.1f Mframes/s, speedup %.2f\n",
+               frames / batchTime / 1e6, frames / referenceTime / 1e6, referenceTime / batchTime);
+    }
+
+    free(pFrames);
+    free(pValid);
+}
+
+/**
+ * @brief Encodes a legacy frame (one sample) or an extended frame
+ *
+ * @param pFrame        Buffer for the frame (BENCH_MAX_FRAME bytes)
+ * @param counter       Counter of the frame
+ * @param pSamples      Samples [µV]
+ * @param count         Number of samples (1 for legacy frames)
+ * @param extended      Encode an extended frame
+ *
+ * @return Size of the frame
+ */
+static uint32_t benchEncodeFrame(uint8_t* pFrame, uint8_t counter, const int32_t* pSamples, uint32_t count, bool extended)
+{
+    uint32_t length = 0;
+    uint8_t sum = 0;
+
+    pFrame[length++] = counter;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            pFrame[length++] = (uint8_t)((uint32_t)pSamples[i] >> (8 * j));
+        }
+    }
+
+    if (extended)
+    {
+        pFrame[length++] = (uint8_t)(WATER_EXT_VERSION | count);
+        pFrame[length++] = WATER_EXT_RESERVED_HIGH;
+    }
+    else
+    {
+        pFrame[length++] = (uint8_t)(WATER_FRAME_RESERVED & 0xFF);
+        pFrame[length++] = (uint8_t)(WATER_FRAME_RESERVED >> 8);
+    }
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        sum += pFrame[i];
+    }
+    pFrame[length] = (uint8_t)-sum;
+
+    return length + 1;
+}
+
+/**
+ * @brief Generates the next chunk of the stream (generate() of water_stream.py)
+ *
+ * @param pConfig       Parameters of the stream
+ * @param pCounter      Counter of the next frame (updated)
+ * @param pBuffer       Buffer for the chunk
+ * @param capacity      Size of the buffer
+ *
+ * @return Number of generated bytes
+ */
+static uint32_t benchGenerate(const BenchStreamConfig_t* pConfig, uint8_t* pCounter, uint8_t* pBuffer, uint32_t capacity)
+{
+    uint32_t length = 0;
+
+    while (length + BENCH_MAX_GARBAGE + BENCH_MAX_FRAME <= capacity)
+    {
+        int32_t samples[WATER_EXT_MAX_SAMPLES];
+        uint8_t frame[BENCH_MAX_FRAME];
+        uint32_t choice = benchRandom() % 1000;
+        bool extended = (benchRandom() % 1000) < pConfig->extendedPermille;
+        uint32_t count = extended ? 1 + benchRandom() % WATER_EXT_MAX_SAMPLES : 1;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            samples[i] = (int32_t)(WATER_MICROVOLT_MIN + benchRandom() % (WATER_MICROVOLT_MAX - WATER_MICROVOLT_MIN + 1));
+        }
+
+        uint32_t size = benchEncodeFrame(frame, *pCounter, samples, count, extended);
+        (*pCounter)++;
+
+        if (choice < pConfig->badPermille)
+        {
+            // Corrupted on the radio link, the counter is incremented nevertheless
+            uint32_t position = (benchRandom() % 2) ? size - 1 : size - 3 + benchRandom() % 2;
+            frame[position] ^= (uint8_t)(1u << (benchRandom() % 8));
+        }
+        else if (choice < pConfig->badPermille + pConfig->garbagePermille)
+        {
+            uint32_t garbage = 1 + benchRandom() % BENCH_MAX_GARBAGE;
+            for (uint32_t i = 0; i < garbage; i++)
+            {
+                pBuffer[length++] = (uint8_t)benchRandom();
+            }
+        }
+        else if (choice < pConfig->badPermille + pConfig->garbagePermille + pConfig->skipPermille)
+        {
+            *pCounter += (uint8_t)(1 + benchRandom() % 255);
+        }
+
+        memcpy(&pBuffer[length], frame, size);
+        length += size;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Size of the frame ending in front of pEnd according to its
+ * reserved word (frame_size() of water_stream.py)
+ *
+ * @param pEnd          Position behind the last byte of the frame
+ *
+ * @return Size of the frame, 0 if the reserved word is invalid
+ */
+static int32_t benchFrameSize(const uint8_t* pEnd)
+{
+    uint8_t low = pEnd[-3];
+    uint8_t high = pEnd[-2];
+    uint32_t count = low & 0x0F;
+
+    if (low == (WATER_FRAME_RESERVED & 0xFF) && high == (WATER_FRAME_RESERVED >> 8))
+        return WATER_FRAME_SIZE;
+
+    if (high != WATER_EXT_RESERVED_HIGH || count < 1 || count > WATER_EXT_MAX_SAMPLES)
+        return 0;
+
+    if ((low & 0xF0) == WATER_EXT_VERSION)
+        return WATER_EXT_FRAME_SIZE(count);
+
+    if ((low & 0xF0) == WATER_ADDR_VERSION)
+        return WATER_ADDR_FRAME_SIZE(count);
+
+    return 0;
+}
+
+/**
+ * @brief Reference model of the decoder (reference() of water_stream.py):
+ * the next frame is the first valid frame ending behind the previous
+ * frame. Addressed frames (only found in garbage) realign the decoder,
+ * but belong to no known probe.
+ *
+ * @param pReference    State of the model
+ * @param pData         Next chunk of the stream
+ * @param length        Size of the chunk
+ */
+static void benchReferenceProcess(BenchReference_t* pReference, const uint8_t* pData, uint32_t length)
+{
+    static uint8_t window[BENCH_MAX_FRAME + BENCH_CHUNK_SIZE];
+    BenchCounters_t* pCounters = &pReference->counters;
+
+    // The frames may start in the previous chunk
+    uint64_t base = pReference->offset - pReference->tailLength;
+    memcpy(window, pReference->tail, pReference->tailLength);
+    memcpy(&window[pReference->tailLength], pData, length);
+    uint32_t windowLength = pReference->tailLength + length;
+
+    for (uint32_t end = pReference->tailLength + 1; end <= windowLength; end++)
+    {
+        if (base + end < 3)
+            continue;
+
+        int32_t size = benchFrameSize(&window[end]);
+        if (size == 0 || base + end < pReference->position + (uint64_t)size)
+            continue;
+
+        uint32_t start = end - (uint32_t)size;
+        uint8_t sum = 0;
+        for (uint32_t i = start; i < end; i++)
+        {
+            sum += window[i];
+        }
+        if (sum != 0)
+            continue;
+
+        uint64_t gap = base + start - pReference->position;
+        if (gap != 0)
+        {
+            if (pReference->synchronized)
+            {
+                pCounters->syncLosses++;
+            }
+            pCounters->discarded += gap;
+            if (gap > pCounters->resyncMax)
+            {
+                pCounters->resyncMax = gap;
+            }
+        }
+
+        pReference->synchronized = true;
+        pReference->position = base + end;
+        pCounters->frames++;
+
+        if ((window[end - 3] & 0xF0) == WATER_ADDR_VERSION && window[end - 2] == WATER_EXT_RESERVED_HIGH)
+        {
+            pCounters->unknown++;
+            continue;
+        }
+
+        if (pReference->counter >= 0 && window[start] != (uint8_t)(pReference->counter + 1))
+        {
+            pCounters->counterErrors++;
+            pCounters->framesLost += (uint8_t)(window[start] - pReference->counter - 1);
+        }
+        pReference->counter = window[start];
+        pCounters->samples += (uint32_t)(size - 4) / 4;
+    }
+
+    // A frame ending in the next chunk is at most BENCH_MAX_FRAME bytes long
+    pReference->tailLength = (windowLength < BENCH_MAX_FRAME) ? windowLength : BENCH_MAX_FRAME;
+    memcpy(pReference->tail, &window[windowLength - pReference->tailLength], pReference->tailLength);
+    pReference->offset += length;
+}
+
+/**
+ * @brief Bytes behind the last frame are only counted as skipped with the
+ * next frame, the alignment is lost once the largest frame does not fit
+ * anymore
+ *
+ * @param pReference    State of the model
+ */
+static void benchReferenceFinish(BenchReference_t* pReference)
+{
+    if (pReference->synchronized && pReference->offset - pReference->position > BENCH_MAX_FRAME)
+    {
+        pReference->counters.syncLosses++;
+    }
+}
+
+/**
+ * @brief Decodes a generated stream and compares the counters of the
+ * decoder with the reference model
+ *
+ * @param pConfig       Parameters of the stream
+ */
+static void benchStream(const BenchStreamConfig_t* pConfig)
+{
+    static uint8_t chunk[BENCH_CHUNK_SIZE];
+    static WaterSensor_t sensor;
+    static BenchReference_t reference;
+    uint64_t streamBytes = 0;
+    uint32_t nowUs = 0;
+    uint8_t counter = 0;
+    double decodeTime = 0;
+
+    waterSensorInitialize(&sensor, nowUs);
+    reference = (BenchReference_t){ 0 };
+    reference.counter = -1;
+
+    while (streamBytes < pConfig->bytes)
+    {
+        uint32_t length = benchGenerate(pConfig, &counter, chunk, BENCH_CHUNK_SIZE);
+
+        benchReferenceProcess(&reference, chunk, length);
+
+        // Blocks of random size like the idle line events of the RX DMA
+        double start = benchNow();
+        for (uint32_t position = 0; position < length; )
+        {
+            uint32_t block = 1 + benchRandom() % BENCH_MAX_BLOCK;
+            if (block > length - position)
+            {
+                block = length - position;
+            }
+
+            nowUs += block * BENCH_BYTE_TIME_US;
+            waterSensorProcess(&sensor, &chunk[position], (int32_t)block, nowUs);
+            position += block;
+        }
+        decodeTime += benchNow() - start;
+
+        streamBytes += length;
+    }
+
+    benchReferenceFinish(&reference);
+
+    const WaterSensorStats_t* pStats = &sensor.stats;
+    const BenchCounters_t* pExpected = &reference.counters;
+
+    printf("stream: %llu bytes, frames %u samples %u sync %u discarded %u resync max %u B counter %u lost %u unknown %u checksum %u\n",
+           (unsigned long long)streamBytes, pStats->framesReceived, pStats->samplesReceived, pStats->syncLosses,
+           pStats->bytesDiscarded, pStats->resyncBytesMax, pStats->counterErrors, pStats->framesLost,
+           pStats->unknownProbeFrames, pStats->checksumErrors);
+
+    HOST_TEST_CHECK(pStats->framesReceived == (uint32_t)pExpected->frames);
+    HOST_TEST_CHECK(pStats->samplesReceived == (uint32_t)pExpected->samples);
+    HOST_TEST_CHECK(pStats->syncLosses == (uint32_t)pExpected->syncLosses);
+    HOST_TEST_CHECK(pStats->bytesDiscarded == (uint32_t)pExpected->discarded);
+    HOST_TEST_CHECK(pStats->resyncBytesMax == (uint32_t)pExpected->resyncMax);
+    HOST_TEST_CHECK(pStats->counterErrors == (uint32_t)pExpected->counterErrors);
+    HOST_TEST_CHECK(pStats->framesLost == (uint32_t)pExpected->framesLost);
+    HOST_TEST_CHECK(pStats->unknownProbeFrames == (uint32_t)pExpected->unknown);
+
+    if (gHostTestFailures != 0)
+    {
+        fprintf(stderr, "  expected: frames %llu samples %llu sync %llu discarded %llu resync max %llu B counter %llu lost %llu unknown %llu\n",
+                (unsigned long long)pExpected->frames, (unsigned long long)pExpected->samples,
+                (unsigned long long)pExpected->syncLosses, (unsigned long long)pExpected->discarded,
+                (unsigned long long)pExpected->resyncMax, (unsigned long long)pExpected->counterErrors,
+                (unsigned long long)pExpected->framesLost, (unsigned long long)pExpected->unknown);
+    }
+
+    if (decodeTime > 0)
+    {
+        printf("stream: decoder %.1f MB/s, %.2f Mframes/s, %.1f resync bytes per sync loss\n",
+               (double)streamBytes / decodeTime / 1e6, (double)pStats->framesReceived / decodeTime / 1e6,
+               (pStats->syncLosses != 0) ? (double)pStats->bytesDiscarded / pStats->syncLosses : 0.0);
+    }
+}
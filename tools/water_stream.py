@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+###############################################################################
+# @file water_stream.py
+#
+# @brief Generates a water level sensor byte stream for the decoder in
+# src/Service/WaterSensor.c
+#
+# The stream mixes valid legacy and extended frames with frames with a
+# wrong checksum, frames with a wrong reserved word, counter skips
+# (including rollovers) and random garbage. The stream is written to the output, the counters the
+# decoder has to report for it are computed by an independent reference
+# model and printed to stderr.
+#
+# Example (decoder running on the host, see tools/host/uart_host_bridge.c):
+#
+#   uart_host_bridge -w -b 2000000          (prints the pseudo-terminal)
+#   water_stream.py --frames 100000 /dev/pts/N
+#
+# Usage: water_stream.py [--frames <n>] [--seed <n>] [--bad <permille>]
+#                        [--garbage <permille>] [--skip <permille>]
+#                        [--extended <permille>] <output>
+#
+###############################################################################
+
+import argparse
+import random
+import sys
+
+FRAME_SIZE = 8
+RESERVED = bytes([0xDE, 0xC0])
+EXT_RESERVED_HIGH = 0xC1
+EXT_VERSION = 0x10
+EXT_MAX_SAMPLES = 14
+ADDR_VERSION = 0x20
+MAX_GARBAGE = 24
+
+
+def encode_frame(counter, samples):
+    # One sample gives a legacy frame, a list of samples an extended frame
+    if isinstance(samples, int):
+        payload, reserved = samples.to_bytes(4, "little"), RESERVED
+    else:
+        payload = b"".join(sample.to_bytes(4, "little") for sample in samples)
+        reserved = bytes([EXT_VERSION | len(samples), EXT_RESERVED_HIGH])
+    frame = bytes([counter & 0xFF]) + payload + reserved
+    return frame + bytes([(-sum(frame)) & 0xFF])
+
+
+def frame_size(data, end):
+    # Size of the frame ending in front of end according to its reserved word
+    low, high = data[end - 3], data[end - 2]
+    if high == RESERVED[1] and low == RESERVED[0]:
+        return FRAME_SIZE
+    count = low & 0x0F
+    if high != EXT_RESERVED_HIGH or not 1 <= count <= EXT_MAX_SAMPLES:
+        return None
+    if (low & 0xF0) == EXT_VERSION:
+        return 4 * count + 4
+    if (low & 0xF0) == ADDR_VERSION:
+        return 4 * count + 5
+    return None
+
+
+def generate(args):
+    rng = random.Random(args.seed)
+    out = bytearray()
+    counter = 0
+    for _ in range(args.frames):
+        choice = rng.randrange(1000)
+        if rng.randrange(1000) < args.extended:
+            samples = [rng.randrange(500000, 2500001) for _ in range(rng.randrange(1, EXT_MAX_SAMPLES + 1))]
+        else:
+            samples = rng.randrange(500000, 2500001)
+        frame = bytearray(encode_frame(counter, samples))
+        counter = (counter + 1) & 0xFF
+
+        if choice < args.bad:
+            # Corrupted on the radio link, the counter is incremented nevertheless
+            if rng.randrange(2):
+                frame[-1] ^= 1 << rng.randrange(8)
+            else:
+                frame[-3 + rng.randrange(2)] ^= 1 << rng.randrange(8)
+        elif choice < args.bad + args.garbage:
+            out += bytes(rng.randrange(256) for _ in range(rng.randrange(1, MAX_GARBAGE + 1)))
+        elif choice < args.bad + args.garbage + args.skip:
+            counter = (counter + rng.randrange(1, 256)) & 0xFF
+
+        out += frame
+    return bytes(out)
+
+
+def reference(data):
+    # Straight forward model of the decoder: the next frame is the first
+    # valid frame ending behind the previous frame. Addressed frames (only
+    # found in garbage) realign the decoder, but belong to no known probe.
+    stats = dict(frames=0, samples=0, sync_losses=0, discarded=0, counter_errors=0, frames_lost=0, resync_max=0,
+                 unknown=0)
+    pos = 0
+    synchronized = False
+    counter = None
+    for end in range(3, len(data) + 1):
+        size = frame_size(data, end)
+        if size is None or end - size < pos or (sum(data[end - size:end]) & 0xFF) != 0:
+            continue
+        start = end - size
+        gap = start - pos
+        if gap:
+            if synchronized:
+                stats["sync_losses"] += 1
+            stats["discarded"] += gap
+            stats["resync_max"] = max(stats["resync_max"], gap)
+        synchronized = True
+        stats["frames"] += 1
+        pos = end
+        if (data[end - 3] & 0xF0) == ADDR_VERSION:
+            stats["unknown"] += 1
+            continue
+        if counter is not None and data[start] != (counter + 1) & 0xFF:
+            stats["counter_errors"] += 1
+            stats["frames_lost"] += (data[start] - counter - 1) & 0xFF
+        counter = data[start]
+        stats["samples"] += (size - 4) // 4
+
+    # Bytes behind the last frame are only counted as skipped with the next
+    # frame, the alignment is lost once the largest frame does not fit anymore
+    if synchronized and len(data) - pos > 4 * EXT_MAX_SAMPLES + 5:
+        stats["sync_losses"] += 1
+    return stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generates a water level sensor byte stream")
+    parser.add_argument("output", help="file or device the stream is written to ('-' for stdout)")
+    parser.add_argument("--frames", type=int, default=100000, help="number of frames")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the random generator")
+    parser.add_argument("--bad", type=int, default=10, help="permille of corrupted frames")
+    parser.add_argument("--garbage", type=int, default=10, help="permille of frames preceded by garbage")
+    parser.add_argument("--skip", type=int, default=5, help="permille of frames with a counter skip")
+    parser.add_argument("--extended", type=int, default=0, help="permille of extended frames")
+    args = parser.parse_args()
+
+    data = generate(args)
+    stats = reference(data)
+
+    if args.output == "-":
+        sys.stdout.buffer.write(data)
+        sys.stdout.buffer.flush()
+    else:
+        with open(args.output, "wb") as out:
+            out.write(data)
+
+    print("%u bytes  frames %u samples %u sync %u discarded %u resync max %u B counter %u lost %u unknown %u" %
+          (len(data), stats["frames"], stats["samples"], stats["sync_losses"], stats["discarded"], stats["resync_max"],
+           stats["counter_errors"], stats["frames_lost"], stats["unknown"]), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()